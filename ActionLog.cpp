@@ -0,0 +1,170 @@
+#include "ActionLog.h"
+#include "Serialization.h"
+#include <algorithm>
+#include <sstream>
+
+namespace mtm
+{
+    namespace
+    {
+        const char kKeyframeTag = 'K', kActionTag = 'A';
+        const std::size_t kKeyframeHeaderSize = 9, kActionSize = 19;
+    }
+
+    using serialization::putInt;
+    using serialization::getInt;
+    using serialization::getSignedInt;
+
+    ActionRecorder::ActionRecorder(Game &game, std::ostream &log, int keyframe_interval) : game(game), log(log),
+                                                                                           keyframe_interval(keyframe_interval),
+                                                                                           actions(0)
+    {
+        if (keyframe_interval <= 0)
+        {
+            throw mtm::IllegalArgument();
+        }
+        writeKeyframe();
+    }
+
+    void ActionRecorder::writeKeyframe()
+    {
+        std::ostringstream snapshot;
+        game.saveSnapshot(snapshot);
+        const std::string bytes = snapshot.str();
+        char header[kKeyframeHeaderSize];
+        header[0] = kKeyframeTag;
+        putInt(header + 1, actions);
+        putInt(header + 5, std::uint32_t(bytes.size()));
+        write(header, kKeyframeHeaderSize);
+        write(bytes.data(), bytes.size());
+    }
+
+    void ActionRecorder::write(const char *bytes, std::size_t size)
+    {
+        log.write(bytes, size);
+        if (!log.good())
+        {
+            throw mtm::IllegalSnapshot();
+        }
+    }
+
+    ActionStatus ActionRecorder::apply(const Command &command)
+    {
+        if (actions > 0 && actions % keyframe_interval == 0)
+        {
+            writeKeyframe();
+        }
+        ActionStatus status;
+        game.applyBatch(&command, 1, &status);
+        char record[kActionSize];
+        record[0] = kActionTag;
+        record[1] = char(command.type);
+        record[2] = char(status);
+        putInt(record + 3, command.src_row);
+        putInt(record + 7, command.src_col);
+        putInt(record + 11, command.dst_row);
+        putInt(record + 15, command.dst_col);
+        actions++;
+        write(record, kActionSize);
+        return status;
+    }
+
+    void ActionRecorder::move(const GridPoint &src_coordinates, const GridPoint &dst_coordinates)
+    {
+        const Command command = {MOVE, src_coordinates.row, src_coordinates.col, dst_coordinates.row, dst_coordinates.col};
+        throwIfFailed(apply(command));
+    }
+
+    void ActionRecorder::attack(const GridPoint &src_coordinates, const GridPoint &dst_coordinates)
+    {
+        const Command command = {ATTACK, src_coordinates.row, src_coordinates.col, dst_coordinates.row, dst_coordinates.col};
+        throwIfFailed(apply(command));
+    }
+
+    void ActionRecorder::reload(const GridPoint &coordinates)
+    {
+        const Command command = {RELOAD, coordinates.row, coordinates.col, coordinates.row, coordinates.col};
+        throwIfFailed(apply(command));
+    }
+
+    int ActionRecorder::getActions() const
+    {
+        return actions;
+    }
+
+    ActionReplayer::ActionReplayer(const char *log_data, std::size_t size) : data(log_data, log_data + size)
+    {
+        std::size_t position = 0;
+        while (position < size)
+        {
+            const char *record = data.data() + position;
+            if (record[0] == kKeyframeTag && size - position >= kKeyframeHeaderSize)
+            {
+                const Keyframe keyframe = {getSignedInt(record + 1), record + kKeyframeHeaderSize, getInt(record + 5)};
+                position += kKeyframeHeaderSize;
+                if (keyframe.action != int(commands.size()) || size - position < keyframe.size)
+                {
+                    throw mtm::IllegalSnapshot();
+                }
+                keyframes.push_back(keyframe);
+                position += keyframe.size;
+            }
+            else if (record[0] == kActionTag && size - position >= kActionSize && !keyframes.empty())
+            {
+                if (record[1] < MOVE || record[1] > RELOAD || record[2] < SUCCESS || record[2] > ILLEGAL_TARGET)
+                {
+                    throw mtm::IllegalSnapshot();
+                }
+                const Command command = {CommandType(record[1]), getSignedInt(record + 3), getSignedInt(record + 7),
+                                         getSignedInt(record + 11), getSignedInt(record + 15)};
+                commands.push_back(command);
+                statuses.push_back(ActionStatus(record[2]));
+                position += kActionSize;
+            }
+            else
+            {
+                throw mtm::IllegalSnapshot();
+            }
+        }
+        if (keyframes.empty())
+        {
+            throw mtm::IllegalSnapshot();
+        }
+    }
+
+    int ActionReplayer::getActions() const
+    {
+        return int(commands.size());
+    }
+
+    const Command &ActionReplayer::getCommand(int action) const
+    {
+        return commands.at(action);
+    }
+
+    ActionStatus ActionReplayer::getStatus(int action) const
+    {
+        return statuses.at(action);
+    }
+
+    Game ActionReplayer::gameAt(int action) const
+    {
+        if (action < 0 || action > getActions())
+        {
+            throw mtm::IllegalArgument();
+        }
+        // the last keyframe at or before the action (the first keyframe is always at action 0)
+        const std::vector<Keyframe>::const_iterator keyframe =
+            std::upper_bound(keyframes.begin(), keyframes.end(), action,
+                             [](int action, const Keyframe &keyframe) { return action < keyframe.action; }) - 1;
+        Game game = Game::loadSnapshot(keyframe->snapshot, keyframe->size);
+        const int count = action - keyframe->action;
+        std::vector<ActionStatus> results(count);
+        game.applyBatch(commands.data() + keyframe->action, count, results.data());
+        if (!std::equal(results.begin(), results.end(), statuses.begin() + keyframe->action))
+        {
+            throw mtm::IllegalSnapshot();
+        }
+        return game;
+    }
+} // namespace mtm
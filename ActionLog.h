@@ -0,0 +1,89 @@
+#ifndef ACTION_LOG_H
+#define ACTION_LOG_H
+#include "Game.h"
+#include <iostream>
+#include <vector>
+
+namespace mtm {
+    const int kDefaultKeyframeInterval = 1024;
+
+    /* class ActionRecorder: Performs the actions of a game and appends each one (the command and its status)
+                             to a binary action log, with a snapshot of the game (a keyframe) before the first action
+                             and before every keyframe_interval actions.
+                             While recording, the game must be changed only through the recorder.
+        The log is a sequence of records (the numbers are 32 bit little endian, as in the snapshots):
+            keyframe:   'K', the number of actions before it, the size of the snapshot, the snapshot (Game::saveSnapshot)
+            action:     'A', the CommandType (1 byte), the ActionStatus (1 byte), src row, src col, dst row, dst col
+    */
+    class ActionRecorder {
+        Game& game;
+        std::ostream& log;
+        const int keyframe_interval;
+        int actions;
+
+        /* writeKeyframe:  appends a snapshot of the game to the log */
+        void writeKeyframe();
+
+        /* write:  appends the given bytes to the log, throws IllegalSnapshot if the writing failed */
+        void write(const char* bytes, std::size_t size);
+
+        public:
+        /* C'tor:  starts recording the actions of game to log (writing the first keyframe),
+                   throws IllegalArgument if keyframe_interval isn't positive, and IllegalSnapshot if the writing
+                   failed  */
+        ActionRecorder(Game& game, std::ostream& log, int keyframe_interval=kDefaultKeyframeInterval);
+
+        /* apply:  performs the command on the game (as Game::applyBatch), logs it and returns its status.
+                   Throws IllegalSnapshot if writing to the log failed: when the keyframe before the action failed,
+                   the action wasn't performed; when the action itself failed, it was performed (and counted) but
+                   the log is incomplete from it on  */
+        ActionStatus apply(const Command& command);
+
+        /* move, attack, reload:  perform and log the action, and throw the exception of an illegal action
+                                  (as Game::move, attack and reload)  */
+        void move(const GridPoint& src_coordinates, const GridPoint& dst_coordinates);
+        void attack(const GridPoint& src_coordinates, const GridPoint& dst_coordinates);
+        void reload(const GridPoint& coordinates);
+
+        /* getActions:  returns the number of actions recorded so far */
+        int getActions() const;
+    };
+
+    /* class ActionReplayer: Reads an action log (of ActionRecorder) and recreates the game at any point of it.
+                             The log is indexed once by the constructor, so seeking to an action only replays the
+                             actions after the nearest keyframe before it.
+    */
+    class ActionReplayer {
+        struct Keyframe {
+            int action;
+            const char* snapshot;
+            std::size_t size;
+        };
+        std::vector<char> data;
+        std::vector<Keyframe> keyframes;
+        std::vector<Command> commands;
+        std::vector<ActionStatus> statuses;
+
+        public:
+        /* C'tor:  reads the log from the given bytes (size bytes at log_data),
+                   throws IllegalSnapshot if they aren't a valid action log  */
+        ActionReplayer(const char* log_data, std::size_t size);
+
+        ActionReplayer(const ActionReplayer&) = delete;
+        ActionReplayer& operator=(const ActionReplayer&) = delete;
+
+        /* getActions:  returns the number of actions in the log */
+        int getActions() const;
+
+        /* getCommand, getStatus:  return the command of the given action and the status it had when it was recorded */
+        const Command& getCommand(int action) const;
+        ActionStatus getStatus(int action) const;
+
+        /* gameAt:  returns the game after the given number of actions (0 to getActions()),
+                    throws IllegalArgument for another number, and IllegalSnapshot if a replayed action
+                    didn't have the recorded status (the log doesn't match the rules of the game)  */
+        Game gameAt(int action) const;
+    };
+}
+
+#endif
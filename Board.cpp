@@ -0,0 +1,37 @@
+#include "Board.h"
+#include "Exceptions.h"
+#include <algorithm>
+
+namespace mtm
+{
+    Board::Board(int height, int width) : rows(height), cols(width), rows_per_chunk(1)
+    {
+        if (height <= 0 || width <= 0)
+        {
+            throw mtm::IllegalArgument();
+        }
+        rows_per_chunk = std::max(1, kCellsPerChunk / width);
+        chunks.reserve((height + rows_per_chunk - 1) / rows_per_chunk);
+        for (int first_row = 0; first_row < height; first_row += rows_per_chunk)
+        {
+            const int chunk_rows = std::min(rows_per_chunk, height - first_row);
+            chunks.push_back(std::make_shared<Chunk>(Dimensions(chunk_rows, width), nullptr));
+        }
+    }
+
+    std::shared_ptr<Character> &Board::writableCell(int row, int col)
+    {
+        std::shared_ptr<Chunk> &chunk = chunks[row / rows_per_chunk];
+        if (chunk.use_count() != 1)
+        {
+            chunk = std::make_shared<Chunk>(*chunk);
+        }
+        return chunk->atUnchecked(row % rows_per_chunk, col);
+    }
+
+    MatrixView<const std::shared_ptr<Character>> Board::row(int row) const
+    {
+        const Chunk &chunk = *chunks[row / rows_per_chunk];
+        return chunk.row(row % rows_per_chunk);
+    }
+} // namespace mtm
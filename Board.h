@@ -0,0 +1,50 @@
+#ifndef BOARD_H
+#define BOARD_H
+#include "Matrix.h"
+#include <memory>
+#include <vector>
+
+namespace mtm {
+    class Character;
+
+    /* class Board: The cells of a game (the character in each cell, or null), kept in chunks of whole rows
+                    (about kCellsPerChunk cells each), each behind its own shared pointer. A copy of a board copies
+                    only the pointers to the chunks and shares the chunks themselves, until one of the boards
+                    changes a cell: writableCell gives the board its own copy of the chunk of that cell first
+                    (copy on write), so a change after a copy copies the chunks it touches and not the whole board.
+                    Note: boards that share chunks must not be changed concurrently by different threads
+    */
+    class Board {
+        typedef Matrix<std::shared_ptr<Character>> Chunk;
+        static const int kCellsPerChunk = 256;
+
+        int rows, cols;
+        int rows_per_chunk;
+        std::vector<std::shared_ptr<Chunk>> chunks;
+
+        public:
+        /* C'tor:  Creates an empty board in the size of height and width, throws IllegalArgument if the size
+                   isn't positive  */
+        Board(int height, int width);
+
+        /* height, width, size:  return the number of rows / columns / cells of the board  */
+        int height() const { return rows; }
+        int width() const { return cols; }
+        int size() const { return rows * cols; }
+
+        /* atUnchecked:  returns the (legal) cell in the given row and column, for reading  */
+        const std::shared_ptr<Character>& atUnchecked(int row, int col) const
+        {
+            return chunks[row / rows_per_chunk]->atUnchecked(row % rows_per_chunk, col);
+        }
+
+        /* writableCell:  returns the (legal) cell in the given row and column for a change, after copying its chunk
+                          if the chunk is shared with a copy of the board  */
+        std::shared_ptr<Character>& writableCell(int row, int col);
+
+        /* row:  returns a view of the cells of the given (legal) row, for reading (see MatrixView)  */
+        MatrixView<const std::shared_ptr<Character>> row(int row) const;
+    };
+}
+
+#endif
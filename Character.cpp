@@ -13,12 +13,32 @@ namespace mtm
         ammo += add_ammo;
     }
 
-    void Character::verifyLegalMove(const GridPoint &point_src, const GridPoint &point_dst) const
+    ActionStatus Character::checkLegalMove(const GridPoint &point_src, const GridPoint &point_dst) const
     {
         if (GridPoint::distance(point_src, point_dst) > move_range)
         {
-            throw mtm::MoveTooFar();
+            return MOVE_TOO_FAR;
         }
+        return SUCCESS;
+    }
+
+    void Character::legalMoves(const GridPoint &point_src, const Occupancy &occupancy,
+                               std::vector<GridPoint> &targets) const
+    {
+        targets.push_back(point_src);
+        occupancy.appendEmptyInRadius(point_src, move_range, targets);
+    }
+
+    void Character::verifyLegalMove(const GridPoint &point_src, const GridPoint &point_dst) const
+    {
+        throwIfFailed(checkLegalMove(point_src, point_dst));
+    }
+
+    void Character::attack(GridPoint attacker_point, GridPoint victim_point, Board &board,
+                           BoardObserver &observer)
+    {
+        throwIfFailed(checkAttack(attacker_point, victim_point, board));
+        performAttack(attacker_point, victim_point, board, observer);
     }
 
     bool Character::isDead() const
@@ -36,6 +56,59 @@ namespace mtm
         return range;
     }
 
+    units_t Character::getPower() const
+    {
+        return power;
+    }
+
+    Team Character::getTeam() const
+    {
+        return team;
+    }
+
+    units_t Character::getHealth() const
+    {
+        return health;
+    }
+
+    units_t Character::getAmmo() const
+    {
+        return ammo;
+    }
+
+    void Character::removeFromBoard(const GridPoint &point, Board &board,
+                                    BoardObserver &observer)
+    {
+        std::shared_ptr<Character> &cell = board.writableCell(point.row, point.col);
+        observer.characterRemoved(point, *cell);
+        cell = nullptr;
+    }
+
+    void Character::damage(const GridPoint &point, const units_t delta, Board &board,
+                           BoardObserver &observer)
+    {
+        std::shared_ptr<Character> &cell = board.writableCell(point.row, point.col);
+        observer.characterChanging(point, *cell);
+        detach(cell)->changeHealth(delta);
+        if (cell->isDead())
+        {
+            removeFromBoard(point, board, observer);
+        }
+        else
+        {
+            observer.characterChanged(point, *cell);
+        }
+    }
+
+    std::shared_ptr<Character> &Character::detach(std::shared_ptr<Character> &cell)
+    {
+        if (cell && cell.use_count() != 1)
+        {
+            cell = cell->cloneShared();
+        }
+        return cell;
+    }
+
     void Character::changeHealth(const units_t damage)
     {
         health -= damage;
@@ -2,11 +2,41 @@
 #define CHARACTER_H
 #include "Auxiliaries.h"
 #include "Exceptions.h"
-#include "Matrix.h"
+#include "Board.h"
+#include "CharacterPool.h"
+#include "Occupancy.h"
 #include <memory>
+#include <vector>
 
 
 namespace mtm {
+    class Character;
+
+    /* class BoardObserver: Interface for the owner of the board (Game),
+                            which is notified by Character::attack about the changes the attack makes to the board
+    */
+    class BoardObserver {
+        public:
+            virtual ~BoardObserver() {}
+
+            /* characterChanging:  called right before the health of the character in the given cell changes */
+            virtual void characterChanging(const GridPoint& point, const Character& character) = 0;
+
+            /* characterChanged:  called right after the health of the (living) character in the given cell changed */
+            virtual void characterChanged(const GridPoint& point, const Character& character) = 0;
+
+            /* characterRemoved:  called right before a dead character is removed from the given cell
+                                  (instead of characterChanged) */
+            virtual void characterRemoved(const GridPoint& point, const Character& character) = 0;
+
+            /* getOccupancy:  returns the cells occupied by each team (for attacks that hit every enemy in an area) */
+            virtual const Occupancy& getOccupancy() const = 0;
+
+            /* cellsBuffer:  returns an empty vector for the cells an attack finds in the occupancy. The observer keeps
+                             it between attacks, so attacks don't allocate a vector each */
+            virtual std::vector<GridPoint>& cellsBuffer() = 0;
+    };
+
     /* class Character: Abstract class for all character type (Soldier,Medic,Sniper)
     */
     class Character {
@@ -28,6 +58,15 @@ namespace mtm {
                             cpp_team: the character char if it belongs to PYTHON team*/
             Character(const Team team,const units_t health,const units_t ammo,const units_t range,const units_t power,
                         const units_t move_range,const units_t add_ammo,const char cpp_team,const char python_team);
+
+            /* removeFromBoard:  removes the (dead) character in the given cell from the board and notifies the observer */
+            static void removeFromBoard(const GridPoint& point, Board& board,
+                                        BoardObserver& observer);
+
+            /* damage:  subtracts delta from the health of the character in the given cell (see changeHealth),
+                        removes it from the board if it died, and notifies the observer about the change */
+            static void damage(const GridPoint& point, const units_t delta, Board& board,
+                               BoardObserver& observer);
             
             public:
             /* Character D'tor:   detroys a character
@@ -38,10 +77,38 @@ namespace mtm {
             is only implemented for derived classes */
             virtual Character* clone() const = 0;
 
-            /* attack:      recieves coordinates for attacker and victim, and a pointer to the victim 
-                            and performs attack action
+            /* cloneShared:   copies a character into the character pools (as makeCharacter creates them)
+                              and returns a shared pointer to it
+            is only implemented for derived classes */
+            virtual std::shared_ptr<Character> cloneShared() const = 0;
+
+            /* getType:   returns the type of the character
             is only implemented for derived classes */
-            virtual void attack(GridPoint attacker_point, GridPoint victim_point,Matrix<std::shared_ptr<Character>>& board) = 0;
+            virtual CharacterType getType() const = 0;
+
+            /* checkAttack:  returns if the character can attack from attacker_point to victim_point
+                             (SUCCESS, or the status of the reason it can't), without changing anything
+                             (both coordinates are assumed to be inside the board - verified by Game)
+            is only implemented for derived classes */
+            virtual ActionStatus checkAttack(const GridPoint& attacker_point, const GridPoint& victim_point,
+                                             const Board& board) const = 0;
+
+            /* performAttack:  performs an attack that checkAttack allowed; characters that die are removed
+                               through removeFromBoard
+            is only implemented for derived classes */
+            virtual void performAttack(const GridPoint& attacker_point, const GridPoint& victim_point,
+                                       Board& board, BoardObserver& observer) = 0;
+
+            /* legalTargets:  appends to targets every cell that checkAttack allows the character to attack from
+                              attacker_point, found from the occupancy of the board instead of checking each cell
+            is only implemented for derived classes */
+            virtual void legalTargets(const GridPoint& attacker_point, const Board& board,
+                                      const Occupancy& occupancy, std::vector<GridPoint>& targets) const = 0;
+
+            /* attack:      recieves coordinates for attacker and victim, and a pointer to the victim 
+                            and performs attack action (throws the exception of an illegal attack) */
+            void attack(GridPoint attacker_point, GridPoint victim_point,Board& board,
+                        BoardObserver& observer);
             
             /* toChar:      returns the sign associated with each character,
                             determined by the character's type and team */
@@ -50,13 +117,37 @@ namespace mtm {
             /* getRange:      returns the character's range */
             units_t getRange() const;
 
+            /* getPower:      returns the character's power */
+            units_t getPower() const;
+
+            /* getTeam:      returns the character's team */
+            Team getTeam() const;
+
+            /* getHealth, getAmmo:      return the character's health and ammo */
+            units_t getHealth() const;
+            units_t getAmmo() const;
+
             /* isDead:      returns if the character health is lower or equal to zero */
             bool isDead() const;
 
+            /* checkLegalMove:  returns if a distance between two given coordinates is within 
+                                    the moving range of the character (SUCCESS or MOVE_TOO_FAR) */
+            ActionStatus checkLegalMove(const GridPoint & point_src,const GridPoint & point_dst) const;
+
+            /* legalMoves:  appends to targets every cell the character can move to from point_src:
+                            the empty cells within its moving range, and point_src itself */
+            void legalMoves(const GridPoint& point_src, const Occupancy& occupancy, std::vector<GridPoint>& targets) const;
+
             /* verifyLegalMove:  checks if a distance between two given coordinates is within 
                                     the moving range of the character */
             void verifyLegalMove(const GridPoint & point_src,const GridPoint & point_dst) const;
 
+            /* detach:      makes the character in the given cell private to the cell before it is changed (copy on write):
+                            a character shared with a copy of the game (or still held by the caller that added it)
+                            is replaced by its clone. Returns the cell.
+                            Note: Games that share characters must not be changed concurrently by different threads */
+            static std::shared_ptr<Character>& detach(std::shared_ptr<Character>& cell);
+
             /* isSameTeam:      returns if 2 characters are on the same team */
             friend bool isSameTeam(const Character& character, const Character& other);
             
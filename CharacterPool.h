@@ -0,0 +1,270 @@
+#ifndef CHARACTER_POOL_H
+#define CHARACTER_POOL_H
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace mtm {
+    /* class PoolBatch:  A scope in which the thread allocates and releases many blocks as one bulk operation
+                         (e.g. cloning or destroying a game with all its characters). While a batch is active,
+                         each BlockPool takes up to a chunk of blocks for the thread under one lock, and keeps the
+                         blocks the thread releases in a list of the thread, instead of locking the pool for every
+                         block. When the outermost batch of the thread ends, each of these lists goes back to its
+                         pool under one lock, so no blocks stay with the thread after the batch.
+                         Batches may be nested, and blocks may still be released by another thread */
+    class PoolBatch {
+        public:
+        /* struct Cache:  the blocks a BlockPool keeps for the thread during a batch (counted as used by the pool),
+                          linked through their first bytes. A cache is enlisted in the batch when it is first used,
+                          and flush gives its blocks back to the pool when the batch ends */
+        struct Cache {
+            void* blocks;
+            long count;
+            bool enlisted;
+            Cache* next;
+            void (*flush)(Cache& cache);
+        };
+
+        PoolBatch() { depth()++; }
+        PoolBatch(const PoolBatch&) = delete;
+        PoolBatch& operator=(const PoolBatch&) = delete;
+
+        ~PoolBatch()
+        {
+            if (--depth() != 0) {
+                return;
+            }
+            Cache* cache = caches();
+            caches() = nullptr;
+            while (cache != nullptr) {
+                Cache* next = cache->next;
+                cache->enlisted = false;
+                cache->flush(*cache);
+                cache = next;
+            }
+        }
+
+        /* active:  returns true if the thread is inside a batch */
+        static bool active() { return depth() > 0; }
+
+        /* enlist:  makes the batch flush the given cache when it ends (once, however many times it's called) */
+        static void enlist(Cache& cache)
+        {
+            if (!cache.enlisted) {
+                cache.enlisted = true;
+                cache.next = caches();
+                caches() = &cache;
+            }
+        }
+
+        private:
+        /* depth, caches:  the number of nested batches of the thread, and the caches used by its batch */
+        static int& depth()
+        {
+            static thread_local int value = 0;
+            return value;
+        }
+
+        static Cache*& caches()
+        {
+            static thread_local Cache* head = nullptr;
+            return head;
+        }
+    };
+
+    /* class BlockPool: A free list of memory blocks of one size, used to allocate the characters.
+                        Blocks are taken from chunks of kBlocksPerChunk blocks (one heap allocation per chunk),
+                        and a released block goes back to the free list to be reused by the next character.
+                        There is one pool per block size for the whole process, behind a mutex, so a block may be
+                        released by any thread and threads that exit don't take blocks with them.
+                        The pool keeps track of its chunks and of the blocks in use: when the last block in use
+                        is released (all the units are gone), all the chunks are returned to the system at once.
+                        Inside a PoolBatch, the blocks are allocated and released through a cache of the thread */
+    template <std::size_t BlockSize>
+    class BlockPool {
+        union Block {
+            Block* next;
+            alignas(std::max_align_t) unsigned char storage[BlockSize];
+        };
+        static const int kBlocksPerChunk = 256;
+
+        std::mutex mutex;
+        Block* free_list;
+        std::vector<Block*> chunks;
+        long used_blocks;
+
+        BlockPool() : free_list(nullptr), used_blocks(0) {}
+
+        /* instance:  returns the pool of the process. It is never destroyed, so characters that are destroyed
+                      after the static objects (or by them) can still release their blocks */
+        static BlockPool& instance()
+        {
+            static BlockPool* const pool = new BlockPool();
+            return *pool;
+        }
+
+        /* refill:  allocates a new chunk and puts all of its blocks in the free list */
+        void refill()
+        {
+            chunks.reserve(chunks.size() + 1);
+            Block* chunk = static_cast<Block*>(::operator new(kBlocksPerChunk * sizeof(Block)));
+            chunks.push_back(chunk);
+            for (int i = 0; i < kBlocksPerChunk; i++) {
+                chunk[i].next = (i + 1 < kBlocksPerChunk) ? &chunk[i + 1] : free_list;
+            }
+            free_list = chunk;
+        }
+
+        /* releaseChunks:  returns all the chunks to the system (when none of their blocks is in use) */
+        void releaseChunks()
+        {
+            for (Block* chunk : chunks) {
+                ::operator delete(chunk);
+            }
+            std::vector<Block*>().swap(chunks);
+            free_list = nullptr;
+        }
+
+        /* cache:  the blocks the pool keeps for the thread during a PoolBatch */
+        static PoolBatch::Cache& cache()
+        {
+            static thread_local PoolBatch::Cache value = { nullptr, 0, false, nullptr, &flush };
+            return value;
+        }
+
+        /* fillCache:  moves up to a chunk of blocks from the free list to the (empty) cache of the thread */
+        void fillCache(PoolBatch::Cache& thread_cache)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (free_list == nullptr) {
+                refill();
+            }
+            Block* last = free_list;
+            long count = 1;
+            while (count < kBlocksPerChunk && last->next != nullptr) {
+                last = last->next;
+                count++;
+            }
+            thread_cache.blocks = free_list;
+            free_list = last->next;
+            last->next = nullptr;
+            thread_cache.count = count;
+            used_blocks += count;
+        }
+
+        /* flush:  moves the blocks of the cache of the thread back to the free list, when its batch ends */
+        static void flush(PoolBatch::Cache& thread_cache)
+        {
+            if (thread_cache.count == 0) {
+                return;
+            }
+            Block* first = static_cast<Block*>(thread_cache.blocks);
+            Block* last = first;
+            while (last->next != nullptr) {
+                last = last->next;
+            }
+            BlockPool& pool = instance();
+            std::lock_guard<std::mutex> lock(pool.mutex);
+            last->next = pool.free_list;
+            pool.free_list = first;
+            pool.used_blocks -= thread_cache.count;
+            thread_cache.blocks = nullptr;
+            thread_cache.count = 0;
+            if (pool.used_blocks == 0) {
+                pool.releaseChunks();
+            }
+        }
+
+        public:
+        /* allocate:  returns a block of BlockSize bytes */
+        static void* allocate()
+        {
+            BlockPool& pool = instance();
+            if (PoolBatch::active()) {
+                PoolBatch::Cache& thread_cache = cache();
+                if (thread_cache.count == 0) {
+                    pool.fillCache(thread_cache);
+                }
+                PoolBatch::enlist(thread_cache);
+                Block* block = static_cast<Block*>(thread_cache.blocks);
+                thread_cache.blocks = block->next;
+                thread_cache.count--;
+                return block;
+            }
+            std::lock_guard<std::mutex> lock(pool.mutex);
+            if (pool.free_list == nullptr) {
+                pool.refill();
+            }
+            Block* block = pool.free_list;
+            pool.free_list = block->next;
+            pool.used_blocks++;
+            return block;
+        }
+
+        /* release:  returns a block that was allocated by the pool (in any thread) to the free list */
+        static void release(void* pointer)
+        {
+            Block* block = static_cast<Block*>(pointer);
+            if (PoolBatch::active()) {
+                PoolBatch::Cache& thread_cache = cache();
+                PoolBatch::enlist(thread_cache);
+                block->next = static_cast<Block*>(thread_cache.blocks);
+                thread_cache.blocks = block;
+                thread_cache.count++;
+                return;
+            }
+            BlockPool& pool = instance();
+            std::lock_guard<std::mutex> lock(pool.mutex);
+            block->next = pool.free_list;
+            pool.free_list = block;
+            if (--pool.used_blocks == 0) {
+                pool.releaseChunks();
+            }
+        }
+    };
+
+    /* class PoolAllocator: A standard allocator that allocates single objects from the BlockPool of their size.
+                            Used with std::allocate_shared, so a character and the control block of its shared_ptr
+                            are one pooled block instead of two heap allocations */
+    template <class T>
+    class PoolAllocator {
+        public:
+        typedef T value_type;
+
+        PoolAllocator() {}
+        template <class U>
+        PoolAllocator(const PoolAllocator<U>&) {}
+
+        T* allocate(std::size_t count)
+        {
+            if (count != 1) {
+                return static_cast<T*>(::operator new(count * sizeof(T)));
+            }
+            return static_cast<T*>(BlockPool<sizeof(T)>::allocate());
+        }
+
+        void deallocate(T* pointer, std::size_t count)
+        {
+            if (count != 1) {
+                ::operator delete(pointer);
+                return;
+            }
+            BlockPool<sizeof(T)>::release(pointer);
+        }
+    };
+
+    template <class T, class U>
+    bool operator==(const PoolAllocator<T>&, const PoolAllocator<U>&)
+    {
+        return true;
+    }
+
+    template <class T, class U>
+    bool operator!=(const PoolAllocator<T>&, const PoolAllocator<U>&)
+    {
+        return false;
+    }
+}
+
+#endif
@@ -0,0 +1,305 @@
+#include "CompactGame.h"
+#include <algorithm>
+
+namespace mtm
+{
+    CompactGame::CompactGame(int height, int width) : height(height), width(width),
+                                                      types(boardDimensions(height, width), kEmptyCell),
+                                                      teams(Dimensions(height, width), CPP),
+                                                      health(Dimensions(height, width), 0),
+                                                      ammo(Dimensions(height, width), 0),
+                                                      range(Dimensions(height, width), 0),
+                                                      power(Dimensions(height, width), 0),
+                                                      attacks_counter(Dimensions(height, width), 0),
+                                                      team_units{0, 0}
+    {
+    }
+
+    Dimensions CompactGame::boardDimensions(int height, int width)
+    {
+        if (height <= 0 || width <= 0)
+        {
+            throw mtm::IllegalArgument();
+        }
+        return Dimensions(height, width);
+    }
+
+    void CompactGame::addCharacter(const GridPoint &coordinates, CharacterType type, Team team, units_t health,
+                                   units_t ammo, units_t range, units_t power)
+    {
+        if (health <= 0 || ammo < 0 || range < 0 || power < 0)
+        {
+            throw mtm::IllegalArgument();
+        }
+        verifyLegalEmptyCell(coordinates);
+        const int row = coordinates.row, col = coordinates.col;
+        types.atUnchecked(row, col) = type;
+        teams.atUnchecked(row, col) = team;
+        this->health.atUnchecked(row, col) = health;
+        this->ammo.atUnchecked(row, col) = ammo;
+        this->range.atUnchecked(row, col) = range;
+        this->power.atUnchecked(row, col) = power;
+        attacks_counter.atUnchecked(row, col) = 0;
+        team_units[team]++;
+    }
+
+    void CompactGame::move(const GridPoint &src_coordinates, const GridPoint &dst_coordinates)
+    {
+        verifyLegalCell(dst_coordinates);
+        verifyLegalOccupiedCell(src_coordinates);
+        if (src_coordinates == dst_coordinates)
+        {
+            return;
+        }
+        const int src_row = src_coordinates.row, src_col = src_coordinates.col;
+        const int dst_row = dst_coordinates.row, dst_col = dst_coordinates.col;
+        if (GridPoint::distance(src_coordinates, dst_coordinates) > moveRange(CharacterType(types.atUnchecked(src_row, src_col))))
+        {
+            throw mtm::MoveTooFar();
+        }
+        verifyLegalEmptyCell(dst_coordinates);
+        types.atUnchecked(dst_row, dst_col) = types.atUnchecked(src_row, src_col);
+        teams.atUnchecked(dst_row, dst_col) = teams.atUnchecked(src_row, src_col);
+        health.atUnchecked(dst_row, dst_col) = health.atUnchecked(src_row, src_col);
+        ammo.atUnchecked(dst_row, dst_col) = ammo.atUnchecked(src_row, src_col);
+        range.atUnchecked(dst_row, dst_col) = range.atUnchecked(src_row, src_col);
+        power.atUnchecked(dst_row, dst_col) = power.atUnchecked(src_row, src_col);
+        attacks_counter.atUnchecked(dst_row, dst_col) = attacks_counter.atUnchecked(src_row, src_col);
+        types.atUnchecked(src_row, src_col) = kEmptyCell;
+    }
+
+    void CompactGame::attack(const GridPoint &src_coordinates, const GridPoint &dst_coordinates)
+    {
+        verifyLegalCell(dst_coordinates);
+        verifyLegalOccupiedCell(src_coordinates);
+        switch (types.atUnchecked(src_coordinates.row, src_coordinates.col))
+        {
+        case SOLDIER:
+            soldierAttack(src_coordinates, dst_coordinates);
+            break;
+        case MEDIC:
+            medicAttack(src_coordinates, dst_coordinates);
+            break;
+        default:
+            assert(types.atUnchecked(src_coordinates.row, src_coordinates.col) == SNIPER);
+            sniperAttack(src_coordinates, dst_coordinates);
+        }
+    }
+
+    void CompactGame::reload(const GridPoint &coordinates)
+    {
+        verifyLegalOccupiedCell(coordinates);
+        const int row = coordinates.row, col = coordinates.col;
+        ammo.atUnchecked(row, col) += addAmmo(CharacterType(types.atUnchecked(row, col)));
+    }
+
+    void CompactGame::soldierAttack(const GridPoint &attacker_point, const GridPoint &victim_point)
+    {
+        const int row = attacker_point.row, col = attacker_point.col;
+        if (GridPoint::distance(attacker_point, victim_point) > range.atUnchecked(row, col))
+        {
+            throw mtm::OutOfRange();
+        }
+        if (ammo.atUnchecked(row, col) == 0)
+        {
+            throw mtm::OutOfAmmo();
+        }
+        if ((attacker_point.row != victim_point.row) && (attacker_point.col != victim_point.col))
+        {
+            throw mtm::IllegalTarget();
+        }
+        ammo.atUnchecked(row, col)--;
+        const char team = teams.atUnchecked(row, col);
+        const units_t attack_power = power.atUnchecked(row, col);
+        if (!isEmpty(victim_point.row, victim_point.col) && teams.atUnchecked(victim_point.row, victim_point.col) != team)
+        {
+            damage(victim_point.row, victim_point.col, attack_power);
+        }
+        //ricochet: the enemies within the danger zone (a diamond around the victim, clipped to the board)
+        const int danger_radius = ceil((double)range.atUnchecked(row, col) / kSoldierDangerZone);
+        const units_t ricochet_damage = ceil((double)attack_power / kSoldierRicochetDamage);
+        const int first_row = std::max(0, victim_point.row - danger_radius);
+        const int last_row = std::min(height - 1, victim_point.row + danger_radius);
+        for (int i = first_row; i <= last_row; i++)
+        {
+            const int row_radius = danger_radius - std::abs(i - victim_point.row);
+            const int first_col = std::max(0, victim_point.col - row_radius);
+            const int last_col = std::min(width - 1, victim_point.col + row_radius);
+            for (int j = first_col; j <= last_col; j++)
+            {
+                if (!isEmpty(i, j) && !(i == victim_point.row && j == victim_point.col) && teams.atUnchecked(i, j) != team)
+                {
+                    damage(i, j, ricochet_damage);
+                }
+            }
+        }
+    }
+
+    void CompactGame::medicAttack(const GridPoint &attacker_point, const GridPoint &victim_point)
+    {
+        const int row = attacker_point.row, col = attacker_point.col;
+        if (GridPoint::distance(attacker_point, victim_point) > range.atUnchecked(row, col))
+        {
+            throw mtm::OutOfRange();
+        }
+        const bool has_victim = !isEmpty(victim_point.row, victim_point.col);
+        const bool is_enemy = has_victim && teams.atUnchecked(victim_point.row, victim_point.col) != teams.atUnchecked(row, col);
+        if (is_enemy && ammo.atUnchecked(row, col) == 0)
+        {
+            throw mtm::OutOfAmmo();
+        }
+        if ((attacker_point == victim_point) || !has_victim)
+        {
+            throw mtm::IllegalTarget();
+        }
+        units_t delta = -power.atUnchecked(row, col);
+        if (is_enemy)
+        {
+            ammo.atUnchecked(row, col)--;
+            delta = -delta;
+        }
+        damage(victim_point.row, victim_point.col, delta);
+    }
+
+    void CompactGame::sniperAttack(const GridPoint &attacker_point, const GridPoint &victim_point)
+    {
+        const int row = attacker_point.row, col = attacker_point.col;
+        const int distance = GridPoint::distance(attacker_point, victim_point);
+        if ((distance < ceil((double)range.atUnchecked(row, col) / kSniperMinRange)) || (distance > range.atUnchecked(row, col)))
+        {
+            throw mtm::OutOfRange();
+        }
+        if (ammo.atUnchecked(row, col) == 0)
+        {
+            throw mtm::OutOfAmmo();
+        }
+        if (isEmpty(victim_point.row, victim_point.col) ||
+            teams.atUnchecked(victim_point.row, victim_point.col) == teams.atUnchecked(row, col))
+        {
+            throw mtm::IllegalTarget();
+        }
+        ammo.atUnchecked(row, col)--;
+        int &counter = attacks_counter.atUnchecked(row, col);
+        counter++;
+        if (counter == kSniperSpecialAttackNum)
+        {
+            counter = 0;
+            damage(victim_point.row, victim_point.col, kSniperSpecialAttackMultiply * power.atUnchecked(row, col));
+        }
+        else
+        {
+            damage(victim_point.row, victim_point.col, power.atUnchecked(row, col));
+        }
+    }
+
+    void CompactGame::damage(int row, int col, units_t delta)
+    {
+        units_t &unit_health = health.atUnchecked(row, col);
+        unit_health -= delta;
+        if (unit_health <= 0)
+        {
+            team_units[int(teams.atUnchecked(row, col))]--;
+            types.atUnchecked(row, col) = kEmptyCell;
+        }
+    }
+
+    std::ostream &operator<<(std::ostream &os, const CompactGame &game)
+    {
+        std::string char_board(game.types.size(), ' ');
+        for (int i = 0; i < game.height; i++)
+        {
+            for (int j = 0; j < game.width; j++)
+            {
+                char_board[i * game.width + j] = game.toChar(i, j);
+            }
+        }
+        return printGameBoard(os, char_board.data(), char_board.data() + char_board.size(), game.width);
+    }
+
+    bool CompactGame::isOver(Team *winningTeam) const
+    {
+        bool cpp_team = team_units[CPP] > 0, python_team = team_units[PYTHON] > 0;
+        if ((!cpp_team && !python_team) || (cpp_team && python_team))
+        {
+            return false;
+        }
+        if (winningTeam != NULL)
+        {
+            *winningTeam = cpp_team ? CPP : PYTHON;
+        }
+        return true;
+    }
+
+    bool CompactGame::isEmpty(int row, int col) const
+    {
+        return types.atUnchecked(row, col) == kEmptyCell;
+    }
+
+    units_t CompactGame::moveRange(CharacterType type)
+    {
+        switch (type)
+        {
+        case SOLDIER:
+            return kSoldierMoveRange;
+        case MEDIC:
+            return kMedicMoveRange;
+        default:
+            return kSniperMoveRange;
+        }
+    }
+
+    units_t CompactGame::addAmmo(CharacterType type)
+    {
+        switch (type)
+        {
+        case SOLDIER:
+            return kSoldierAddAmmo;
+        case MEDIC:
+            return kMedicAddAmmo;
+        default:
+            return kSniperAddAmmo;
+        }
+    }
+
+    char CompactGame::toChar(int row, int col) const
+    {
+        const bool is_cpp = teams.atUnchecked(row, col) == CPP;
+        switch (types.atUnchecked(row, col))
+        {
+        case kEmptyCell:
+            return ' ';
+        case SOLDIER:
+            return is_cpp ? kSoldierCppTeam : kSoldierPythonTeam;
+        case MEDIC:
+            return is_cpp ? kMedicCppTeam : kMedicPythonTeam;
+        default:
+            return is_cpp ? kSniperCppTeam : kSniperPythonTeam;
+        }
+    }
+
+    void CompactGame::verifyLegalCell(const GridPoint &point) const
+    {
+        if ((point.row >= height || point.col >= width) || ((point.row < 0) || (point.col < 0)))
+        {
+            throw mtm::IllegalCell();
+        }
+    }
+
+    void CompactGame::verifyLegalEmptyCell(const GridPoint &point) const
+    {
+        verifyLegalCell(point);
+        if (!isEmpty(point.row, point.col))
+        {
+            throw mtm::CellOccupied();
+        }
+    }
+
+    void CompactGame::verifyLegalOccupiedCell(const GridPoint &point) const
+    {
+        verifyLegalCell(point);
+        if (isEmpty(point.row, point.col))
+        {
+            throw mtm::CellEmpty();
+        }
+    }
+} // namespace mtm
@@ -0,0 +1,93 @@
+#ifndef COMPACT_GAME_H
+#define COMPACT_GAME_H
+#include "Auxiliaries.h"
+#include "Matrix.h"
+#include "Exceptions.h"
+#include "Soldier.h"
+#include "Medic.h"
+#include "Sniper.h"
+
+namespace mtm {
+    /* class CompactGame: Manages the same game as Game (same rules, exceptions and printing),
+                          with the units stored as a structure of arrays instead of a Character object per cell:
+                          every property of the units is a Matrix with an entry per cell, so a scan of the board
+                          reads contiguous memory, and the actions dispatch on the CharacterType of the cell
+                          with a switch instead of a virtual call.
+    */
+    class CompactGame
+    {
+        static const char kEmptyCell = -1;
+        static const units_t kSoldierDangerZone = 3, kSoldierRicochetDamage = 2;
+        static const int kSniperSpecialAttackNum = 3, kSniperSpecialAttackMultiply = 2, kSniperMinRange = 2;
+
+        int height, width;
+
+        /* the units on the board: types holds the CharacterType of each cell (kEmptyCell if the cell is empty),
+           and the other matrices hold the properties of the unit in the cell (undefined for an empty cell) */
+        Matrix<char> types;
+        Matrix<char> teams;
+        Matrix<units_t> health, ammo, range, power;
+        Matrix<int> attacks_counter;
+
+        /* team_units: the number of units of each team (indexed by Team) on the board */
+        int team_units[2];
+
+        /* boardDimensions:  returns the dimensions of the board, throws IllegalArgument if they aren't positive  */
+        static Dimensions boardDimensions(int height, int width);
+
+        /* verifyLegalCell:  checks if a given set of coordinates is positive and within the game board  */
+        void verifyLegalCell(const GridPoint& point) const;
+
+        /* verifyLegalEmptyCell:  checks if the given coordinates is legal and empty  */
+        void verifyLegalEmptyCell(const GridPoint& point) const;
+
+        /* verifyLegalOccupiedCell:  checks if the given coordinates is legal and occupied  */
+        void verifyLegalOccupiedCell(const GridPoint& point) const;
+
+        /* isEmpty:  returns if there is no unit in the given cell (the cell is assumed to be legal)  */
+        bool isEmpty(int row, int col) const;
+
+        /* moveRange, addAmmo:  return the properties that are the same for all the units of a type  */
+        static units_t moveRange(CharacterType type);
+        static units_t addAmmo(CharacterType type);
+
+        /* toChar:  returns the sign of the unit in the given cell (' ' for an empty cell)  */
+        char toChar(int row, int col) const;
+
+        /* damage:  subtracts delta from the health of the unit in the given cell, and removes it if it died  */
+        void damage(int row, int col, units_t delta);
+
+        /* soldierAttack, medicAttack, sniperAttack:  perform an attack by a unit of each type,
+                                                      by the rules of Soldier, Medic and Sniper  */
+        void soldierAttack(const GridPoint& attacker_point, const GridPoint& victim_point);
+        void medicAttack(const GridPoint& attacker_point, const GridPoint& victim_point);
+        void sniperAttack(const GridPoint& attacker_point, const GridPoint& victim_point);
+
+        public:
+        /* C'tor:  Creates a new game in the size of height and width  */
+        CompactGame(int height, int width);
+
+        /* addCharacter:  Adds a new unit to the game to the given coordinates
+            parameters: as in Game::makeCharacter  */
+        void addCharacter(const GridPoint& coordinates, CharacterType type, Team team, units_t health, units_t ammo,
+                          units_t range, units_t power);
+
+        /* move:  moves a unit from one coordinate to another coordinate*/
+        void move(const GridPoint& src_coordinates, const GridPoint& dst_coordinates);
+
+        /* attack:  recieves coordinates for the attacker and the victim,
+                    and performs the attack action */
+        void attack(const GridPoint& src_coordinates, const GridPoint& dst_coordinates);
+
+        /* reload:  reloads ammo for the unit in the given coordinates */
+        void reload(const GridPoint& coordinates);
+
+        /* << operator: returns reference to ostream in order to print the game * */
+        friend std::ostream& operator<<(std::ostream& os, const CompactGame& game);
+
+        /* isOver:  returns if the game is over, as Game::isOver  */
+        bool isOver(Team* winningTeam=NULL) const;
+    };
+}
+
+#endif
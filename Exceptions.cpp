@@ -17,4 +17,26 @@ namespace mtm{
         OutOfRange::OutOfRange() : GameException("OutOfRange") {}
         OutOfAmmo::OutOfAmmo() : GameException("OutOfAmmo") {}
         IllegalTarget::IllegalTarget() :  GameException("IllegalTarget") {}        
+        IllegalSnapshot::IllegalSnapshot() : GameException("IllegalSnapshot") {}
+
+        void throwIfFailed(ActionStatus status) {
+            switch (status) {
+                case SUCCESS:
+                    return;
+                case ILLEGAL_CELL:
+                    throw IllegalCell();
+                case CELL_EMPTY:
+                    throw CellEmpty();
+                case MOVE_TOO_FAR:
+                    throw MoveTooFar();
+                case CELL_OCCUPIED:
+                    throw CellOccupied();
+                case OUT_OF_RANGE:
+                    throw OutOfRange();
+                case OUT_OF_AMMO:
+                    throw OutOfAmmo();
+                default:
+                    throw IllegalTarget();
+            }
+        }
 }
\ No newline at end of file
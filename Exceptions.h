@@ -48,6 +48,18 @@ namespace mtm{
         public:
         IllegalTarget();
     };
+    class IllegalSnapshot : public GameException {
+        public:
+        IllegalSnapshot();
+    };
+
+    /* ActionStatus: the result of a game action of the non-throwing API (Game::tryMove, tryAttack, tryReload).
+                     Each status other than SUCCESS matches the exception the throwing API throws for it */
+    enum ActionStatus { SUCCESS, ILLEGAL_CELL, CELL_EMPTY, MOVE_TOO_FAR, CELL_OCCUPIED, OUT_OF_RANGE, OUT_OF_AMMO,
+                        ILLEGAL_TARGET };
+
+    /* throwIfFailed:  throws the exception matching the given status (does nothing for SUCCESS) */
+    void throwIfFailed(ActionStatus status);
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,224 @@
+#ifndef FIXED_MATRIX_H
+#define FIXED_MATRIX_H
+#include "Matrix.h"
+
+namespace mtm {
+    /** IndexList / MakeIndexList: the indices 0 to N - 1 as a parameter pack (a C++11 stand-in for
+    *   std::make_integer_sequence), built by halving N so a large N doesn't reach the template depth limit.
+    * */
+    template <int... Indices>
+    struct IndexList {};
+
+    template <class First, class Second>
+    struct ConcatIndexLists;
+
+    template <int... First, int... Second>
+    struct ConcatIndexLists<IndexList<First...>, IndexList<Second...>> {
+        typedef IndexList<First..., (int(sizeof...(First)) + Second)...> type;
+    };
+
+    template <int N>
+    struct MakeIndexList {
+        typedef typename ConcatIndexLists<typename MakeIndexList<N / 2>::type,
+                                          typename MakeIndexList<N - N / 2>::type>::type type;
+    };
+
+    template <>
+    struct MakeIndexList<0> {
+        typedef IndexList<> type;
+    };
+
+    template <>
+    struct MakeIndexList<1> {
+        typedef IndexList<0> type;
+    };
+
+    template <class T, int Rows, int Cols, class AccessPolicy = CheckedAccess>
+    class FixedMatrix;
+
+    /** An expression holds a FixedMatrix operand by reference, like a Matrix (see ExpressionOperand),
+    *   and knows its dimensions at compile time (see StaticDimensions).
+    * */
+    template <class T, int Rows, int Cols, class AccessPolicy>
+    struct ExpressionOperand<FixedMatrix<T, Rows, Cols, AccessPolicy>> {
+        typedef const FixedMatrix<T, Rows, Cols, AccessPolicy>& type;
+    };
+
+    template <class T, int Rows, int Cols, class AccessPolicy>
+    struct StaticDimensions<FixedMatrix<T, Rows, Cols, AccessPolicy>> {
+        static const bool kKnown = true;
+        static const int kRows = Rows;
+        static const int kCols = Cols;
+    };
+
+    /** class FixedMatrix - a matrix of Rows x Cols objects of type T, where the dimensions are part of the type.
+    *   The elements are stored inside the object (on the stack for a local variable), so creating, copying,
+    *   and evaluating expressions into a FixedMatrix never allocates - meant for small tables and kernels.
+    *   A FixedMatrix is an expression (see MatrixExpression.h), so it has the operators, all and any of Matrix,
+    *   and can be mixed with Matrix operands. Operands whose dimensions are both known at compile time are
+    *   checked with static_assert instead of throwing DimensionMismatch, and for a literal T the constructors,
+    *   the const accessors and the element-wise operators are constexpr.
+    *   A Matrix can be created from a FixedMatrix (and the other way, which checks the dimensions at run time)
+    *   for the operations only Matrix has.
+    *   Note: it is not Matrix<T, Rows, Cols> because the second template parameter of Matrix is its access policy,
+    *   which FixedMatrix takes as well. Matrix<bool> packs its entries, but FixedMatrix<bool> keeps a bool each.
+    * */
+    template <class T, int Rows, int Cols, class AccessPolicy>
+    class FixedMatrix : public MatrixExpression<FixedMatrix<T, Rows, Cols, AccessPolicy>> {
+        static_assert(Rows > 0 && Cols > 0, "FixedMatrix dimensions must be positive");
+
+        /** elements: all the FixedMatrix objects, in row major order
+        * */
+        T elements[Rows * Cols];
+
+        template <class U, int OtherRows, int OtherCols, class OtherAccessPolicy>
+        friend class FixedMatrix;
+
+        struct TransposeTag {};
+
+        template <int... Indices>
+        constexpr FixedMatrix(const T& value, IndexList<Indices...>) : elements{repeat(Indices, value)...} {}
+
+        template <class E, int... Indices>
+        constexpr FixedMatrix(const MatrixExpression<E>& expression, IndexList<Indices...>) :
+                              elements{T(expression.expression().element(Indices))...} {}
+
+        template <int... Indices>
+        constexpr FixedMatrix(const FixedMatrix<T, Cols, Rows, AccessPolicy>& matrix, TransposeTag,
+                              IndexList<Indices...>) :
+                              elements{matrix.elements[(Indices % Cols) * Rows + Indices / Cols]...} {}
+
+        static constexpr const T& repeat(int, const T& value) { return value; }
+
+        public:
+        typedef T value_type;
+        typedef T* iterator;
+        typedef const T* const_iterator;
+
+        /** AccessIllegalElement, DimensionMismatch:   The Matrix exceptions (see MatrixExceptions)
+        * */
+        typedef typename MatrixExceptions<T>::AccessIllegalElement AccessIllegalElement;
+        typedef typename MatrixExceptions<T>::DimensionMismatch DimensionMismatch;
+
+        private:
+        /** verifyIndex:   Returns the flat index of the given row and column, checks that it is inside the
+        *                  FixedMatrix under CheckedAccess.
+        * */
+        static constexpr int verifyIndex(const int row, const int col)
+        {
+            return !AccessPolicy::kChecked || (row >= 0 && col >= 0 && row < Rows && col < Cols) ?
+                   row * Cols + col : throw AccessIllegalElement();
+        }
+
+        /** verifyDimensions:   Checks at run time that the given expression is Rows x Cols, and returns it.
+        * */
+        template <class E>
+        static constexpr const MatrixExpression<E>& verifyDimensions(const MatrixExpression<E>& expression)
+        {
+            return expression.expression().height() == Rows && expression.expression().width() == Cols ?
+                   expression : throw DimensionMismatch(Dimensions(Rows, Cols),
+                                                        Dimensions(expression.expression().height(),
+                                                                   expression.expression().width()));
+        }
+
+        public:
+        /** FixedMatrix C'tor:   Creates a FixedMatrix with the given value in each entry.
+        *                       If no value was given, each entry is constructed with the default T C'tor
+        * @assumptions: copy c'tor for T
+        * */
+        explicit constexpr FixedMatrix(const T& value = T()) :
+                                       FixedMatrix(value, typename MakeIndexList<Rows * Cols>::type()) {}
+
+        /** FixedMatrix C'tor (values):   Creates a FixedMatrix with the given values in row major order.
+        *                                Exactly Rows * Cols values must be given (checked at compile time).
+        * @assumptions: T can be constructed from each value
+        * */
+        template <class... Values>
+        constexpr FixedMatrix(const T& first, const T& second, const Values&... rest) :
+                              elements{first, second, T(rest)...}
+        {
+            static_assert(sizeof...(Values) + 2 == Rows * Cols, "FixedMatrix needs exactly Rows * Cols values");
+        }
+
+        /** FixedMatrix Expression C'tor:   Creates a FixedMatrix from the result of Matrix operators (or a Matrix).
+        *                                  The dimensions are checked at compile time when the expression has
+        *                                  static dimensions, and throw DimensionMismatch at run time otherwise.
+        * @assumptions: the assumptions of the operators in the expression
+        * */
+        template <class E>
+        constexpr FixedMatrix(const MatrixExpression<E>& expression) :
+                              FixedMatrix(verifyDimensions(expression), typename MakeIndexList<Rows * Cols>::type())
+        {
+            static_assert(StaticDimensionsMayMatch<FixedMatrix, E>::value,
+                          "FixedMatrix must be created from an expression of the same dimensions");
+        }
+
+        /** =(MatrixExpression) operator:   Change the FixedMatrix to be the result of the given expression, which
+        *                                   may refer to the FixedMatrix itself. Dimensions are checked as above.
+        * @assumptions: the assumptions of the operators in the expression, = operator for T
+        * */
+        template <class E>
+        FixedMatrix& operator=(const MatrixExpression<E>& expression)
+        {
+            return *this = FixedMatrix(expression);
+        }
+
+        /** height / width / size:     Returns the number of rows / columns / elements of the FixedMatrix
+        * */
+        constexpr int height() const { return Rows; }
+        constexpr int width() const { return Cols; }
+        constexpr int size() const { return Rows * Cols; }
+
+        /** () operator: returns a reference to the object in the given row and column, under CheckedAccess
+        *                throws AccessIllegalElement if it isn't inside the FixedMatrix
+        * */
+        T& operator()(const int row, const int col) { return elements[verifyIndex(row, col)]; }
+        constexpr const T& operator()(const int row, const int col) const { return elements[verifyIndex(row, col)]; }
+
+        /** atUnchecked: returns a reference to the object in the given row and column without checking it
+        * */
+        T& atUnchecked(const int row, const int col) { return elements[row * Cols + col]; }
+        constexpr const T& atUnchecked(const int row, const int col) const { return elements[row * Cols + col]; }
+
+        /** element: returns the element in the given flat (row major) index, used when evaluating expressions.
+        * */
+        constexpr const T& element(const int index) const { return elements[index]; }
+
+        /** transpose: returns the transposed Cols x Rows FixedMatrix
+        * @assumptions: copy c'tor for T
+        * */
+        constexpr FixedMatrix<T, Cols, Rows, AccessPolicy> transpose() const
+        {
+            return FixedMatrix<T, Cols, Rows, AccessPolicy>(*this, typename FixedMatrix<T, Cols, Rows,
+                                                            AccessPolicy>::TransposeTag(),
+                                                            typename MakeIndexList<Rows * Cols>::type());
+        }
+
+        /** += operator: adds an object of type T to each entry
+        * @assumptions: +,= operators for T
+        * */
+        FixedMatrix& operator+=(const T& object)
+        {
+            return *this = *this + object;
+        }
+
+        /** data / span: the contiguous elements, in row major order (see Matrix::data and MatrixSpan)
+        * */
+        T* data() { return elements; }
+        const T* data() const { return elements; }
+        MatrixSpan<T> span() { return MatrixSpan<T>(elements, Rows * Cols); }
+        MatrixSpan<const T> span() const { return MatrixSpan<const T>(elements, Rows * Cols); }
+
+        /** begin / end: iterators over the elements in row major order. They are plain pointers, so they are not
+        *                checked even under CheckedAccess.
+        * */
+        iterator begin() { return elements; }
+        iterator end() { return elements + Rows * Cols; }
+        const_iterator begin() const { return elements; }
+        const_iterator end() const { return elements + Rows * Cols; }
+        const_iterator cbegin() const { return elements; }
+        const_iterator cend() const { return elements + Rows * Cols; }
+    };
+}
+
+#endif //FIXED_MATRIX_H
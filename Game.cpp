@@ -1,24 +1,24 @@
 #include "Game.h"
 
+/* MTM_CHECK_GAME: define it (-DMTM_CHECK_GAME) to check the hash, the occupancy and the team counters of every game
+                   against a full scan of its board in getHash, getOccupancy and isOver. Each check costs the size of
+                   the board, so they are not part of every debug build (run the tests with it to check a change) */
+
 namespace mtm
 {
 
-    Game::Game(int height, int width) : board(mtm::Dimensions(1, 1), nullptr), height(height), width(width)
+    Game::Game(int height, int width) : height(height), width(width), team_units{0, 0}, hash(0),
+                                        undo_enabled(false), done_actions(0)
     {
-        try
-        {
-            board = Matrix<std::shared_ptr<Character>>(Dimensions(height, width), nullptr);
-        }
-        catch (Matrix<std::shared_ptr<Character>>::IllegalInitialization &e)
-        {
-            throw mtm::IllegalArgument();
-        }
+        board = std::make_shared<Board>(height, width);
+        occupancy = std::make_shared<Occupancy>(height, width);
     }
 
-    Game::Game(const Game &other) : board(mtm::Dimensions(other.board.height(), other.board.width()), nullptr),
-                                    height(other.height), width(other.width)
+    Game::Game(const Game &other) : board(other.board), height(other.height), width(other.width),
+                                    occupancy(other.occupancy),
+                                    team_units{other.team_units[CPP], other.team_units[PYTHON]}, hash(other.hash),
+                                    undo_enabled(other.undo_enabled), done_actions(0)
     {
-        other.copyBoardContentTo((*this).board);
     }
 
     Game &Game::operator=(const Game &other)
@@ -27,18 +27,82 @@ namespace mtm
         {
             return *this;
         }
-        Matrix<std::shared_ptr<Character>> new_matrix(mtm::Dimensions(other.board.height(), other.board.width()), nullptr);
-        other.copyBoardContentTo(new_matrix);
-        board = new_matrix;
+        if (height != other.height || width != other.width)
+        {
+            frame.clear();
+        }
+        board = other.board;
+        occupancy = other.occupancy;
         height = other.height;
         width = other.width;
+        team_units[CPP] = other.team_units[CPP];
+        team_units[PYTHON] = other.team_units[PYTHON];
+        hash = other.hash;
+        undo_enabled = other.undo_enabled;
+        changes.clear();
+        action_starts.clear();
+        done_actions = 0;
         return *this;
     }
 
+    Game Game::clone() const
+    {
+        Game copy(*this);
+        PoolBatch batch;
+        Board &cells = copy.writableBoard();
+        // every chunk of cells is copied and the occupancy is built again, so the clone shares no chunks either
+        copy.occupancy = std::make_shared<Occupancy>(height, width);
+        for (int i = 0; i < height; i++)
+        {
+            for (int j = 0; j < width; j++)
+            {
+                std::shared_ptr<Character> &cell = cells.writableCell(i, j);
+                if (cell)
+                {
+                    cell = cell->cloneShared();
+                    copy.occupancy->set(GridPoint(i, j), cell->getTeam());
+                }
+            }
+        }
+        return copy;
+    }
+
+    int Game::getHeight() const
+    {
+        return height;
+    }
+
+    int Game::getWidth() const
+    {
+        return width;
+    }
+
+    std::uint64_t Game::getHash() const
+    {
+#ifdef MTM_CHECK_GAME
+        assert(hash == computeHash());
+#endif
+        return hash;
+    }
+
+    const Occupancy &Game::getOccupancy() const
+    {
+#ifdef MTM_CHECK_GAME
+        assert(occupancyMatchesBoard());
+#endif
+        return *occupancy;
+    }
+
     void Game::addCharacter(const GridPoint &coordinates, std::shared_ptr<Character> character)
     {
-        verifyLegalEmptyCell(coordinates);
-        board(coordinates.row, coordinates.col) = character;
+        throwIfFailed(checkLegalEmptyCell(coordinates));
+        beginAction();
+        recordChange(coordinates);
+        writableBoard().writableCell(coordinates.row, coordinates.col) = character;
+        occupancy->set(coordinates, character->getTeam());
+        team_units[character->getTeam()]++;
+        hash ^= characterKey(coordinates, *character);
+        endAction();
     }
 
     std::shared_ptr<Character> Game::makeCharacter(CharacterType type, Team team, units_t health, units_t ammo,
@@ -51,77 +115,222 @@ namespace mtm
         switch (type)
         {
         case SOLDIER:
-            return std::shared_ptr<Character>(new Soldier(team, health, ammo, range, power));
+            return std::allocate_shared<Soldier>(PoolAllocator<Soldier>(), team, health, ammo, range, power);
         case MEDIC:
-            return std::shared_ptr<Character>(new Medic(team, health, ammo, range, power));
+            return std::allocate_shared<Medic>(PoolAllocator<Medic>(), team, health, ammo, range, power);
         default:
         {
             assert(type == SNIPER);
-            return std::shared_ptr<Character>(new Sniper(team, health, ammo, range, power));
+            return std::allocate_shared<Sniper>(PoolAllocator<Sniper>(), team, health, ammo, range, power);
         }
         }
     }
 
     void Game::move(const GridPoint &src_coordinates, const GridPoint &dst_coordinates)
     {
-        verifyLegalCell(dst_coordinates);
-        verifyLegalOccupiedCell(src_coordinates);
+        throwIfFailed(tryMove(src_coordinates, dst_coordinates));
+    }
+
+    void Game::attack(const GridPoint &src_coordinates, const GridPoint &dst_coordinates)
+    {
+        throwIfFailed(tryAttack(src_coordinates, dst_coordinates));
+    }
+
+    void Game::reload(const GridPoint &coordinates)
+    {
+        throwIfFailed(tryReload(coordinates));
+    }
+
+    ActionStatus Game::tryMove(const GridPoint &src_coordinates, const GridPoint &dst_coordinates)
+    {
+        ActionStatus status = checkLegalCell(dst_coordinates);
+        if (status == SUCCESS)
+        {
+            status = checkLegalOccupiedCell(src_coordinates);
+        }
+        if (status != SUCCESS)
+        {
+            return status;
+        }
         if (src_coordinates == dst_coordinates)
         {
-            return;
+            // nothing changes, but it is still an action (that undo reverts)
+            beginAction();
+            endAction();
+            return SUCCESS;
+        }
+        status = board->atUnchecked(src_coordinates.row, src_coordinates.col)->Character::checkLegalMove(src_coordinates, dst_coordinates);
+        if (status == SUCCESS)
+        {
+            status = checkLegalEmptyCell(dst_coordinates);
         }
-        board(src_coordinates.row, src_coordinates.col)->Character::verifyLegalMove(src_coordinates, dst_coordinates);
-        verifyLegalEmptyCell(dst_coordinates);
-        board(dst_coordinates.row, dst_coordinates.col) = board(src_coordinates.row, src_coordinates.col);
-        board(src_coordinates.row, src_coordinates.col) = nullptr;
+        if (status != SUCCESS)
+        {
+            return status;
+        }
+        beginAction();
+        recordChange(src_coordinates);
+        recordChange(dst_coordinates);
+        Board &cells = writableBoard();
+        std::shared_ptr<Character> &src_cell = cells.writableCell(src_coordinates.row, src_coordinates.col);
+        std::shared_ptr<Character> &dst_cell = cells.writableCell(dst_coordinates.row, dst_coordinates.col);
+        dst_cell = std::move(src_cell);
+        const Character &character = *dst_cell;
+        hash ^= characterKey(src_coordinates, character) ^ characterKey(dst_coordinates, character);
+        occupancy->reset(src_coordinates, character.getTeam());
+        occupancy->set(dst_coordinates, character.getTeam());
+        src_cell = nullptr;
+        endAction();
+        return SUCCESS;
     }
 
-    void Game::attack(const GridPoint &src_coordinates, const GridPoint &dst_coordinates)
+    ActionStatus Game::tryAttack(const GridPoint &src_coordinates, const GridPoint &dst_coordinates)
     {
-        verifyLegalCell(dst_coordinates);
-        verifyLegalOccupiedCell(src_coordinates);
-        std::shared_ptr<Character> attacker = board(src_coordinates.row, src_coordinates.col);
-        attacker->attack(src_coordinates, dst_coordinates, board);
+        ActionStatus status = checkLegalCell(dst_coordinates);
+        if (status == SUCCESS)
+        {
+            status = checkLegalOccupiedCell(src_coordinates);
+        }
+        if (status == SUCCESS)
+        {
+            status = board->atUnchecked(src_coordinates.row, src_coordinates.col)->checkAttack(src_coordinates, dst_coordinates, *board);
+        }
+        if (status != SUCCESS)
+        {
+            return status;
+        }
+        beginAction();
+        recordChange(src_coordinates);
+        Board &cells = writableBoard();
+        // the attacker is never removed by its own attack, so it is used through the cell (no shared_ptr copy)
+        Character &attacker = *Character::detach(cells.writableCell(src_coordinates.row, src_coordinates.col));
+        hash ^= characterKey(src_coordinates, attacker);
+        attacker.performAttack(src_coordinates, dst_coordinates, cells, *this);
+        hash ^= characterKey(src_coordinates, attacker);
+        endAction();
+        return SUCCESS;
     }
 
-    void Game::reload(const GridPoint &coordinates)
+    ActionStatus Game::tryReload(const GridPoint &coordinates)
+    {
+        ActionStatus status = checkLegalOccupiedCell(coordinates);
+        if (status != SUCCESS)
+        {
+            return status;
+        }
+        beginAction();
+        recordChange(coordinates);
+        Character &character = *Character::detach(writableBoard().writableCell(coordinates.row, coordinates.col));
+        hash ^= characterKey(coordinates, character);
+        character.Character::loadAmmo();
+        hash ^= characterKey(coordinates, character);
+        endAction();
+        return SUCCESS;
+    }
+
+    bool Game::applyBatch(const Command *commands, int count, ActionStatus *results, Team *winningTeam)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            const Command &command = commands[i];
+            const GridPoint src_coordinates(command.src_row, command.src_col);
+            switch (command.type)
+            {
+            case MOVE:
+                results[i] = tryMove(src_coordinates, GridPoint(command.dst_row, command.dst_col));
+                break;
+            case ATTACK:
+                results[i] = tryAttack(src_coordinates, GridPoint(command.dst_row, command.dst_col));
+                break;
+            default:
+                assert(command.type == RELOAD);
+                results[i] = tryReload(src_coordinates);
+            }
+        }
+        return isOver(winningTeam);
+    }
+
+    int Game::legalActions(const GridPoint &unit, std::vector<Command> &actions) const
     {
-        verifyLegalOccupiedCell(coordinates);
-        board(coordinates.row, coordinates.col)->Character::loadAmmo();
+        if (checkLegalOccupiedCell(unit) != SUCCESS)
+        {
+            return 0;
+        }
+        const std::size_t first = actions.size();
+        std::vector<GridPoint> targets;
+        appendLegalActions(unit, targets, actions);
+        return int(actions.size() - first);
+    }
+
+    int Game::legalActions(Team team, std::vector<Command> &actions) const
+    {
+        const std::size_t first = actions.size();
+        std::vector<GridPoint> units, targets;
+        occupancy->appendUnits(team, units);
+        for (std::vector<GridPoint>::const_iterator it = units.begin(); it != units.end(); ++it)
+        {
+            appendLegalActions(*it, targets, actions);
+        }
+        return int(actions.size() - first);
+    }
+
+    void Game::appendLegalActions(const GridPoint &unit, std::vector<GridPoint> &targets,
+                                  std::vector<Command> &actions) const
+    {
+        const Character &character = *board->atUnchecked(unit.row, unit.col);
+        const Command reload = {RELOAD, unit.row, unit.col, unit.row, unit.col};
+        actions.push_back(reload);
+        targets.clear();
+        character.legalMoves(unit, *occupancy, targets);
+        for (std::vector<GridPoint>::const_iterator it = targets.begin(); it != targets.end(); ++it)
+        {
+            const Command move = {MOVE, unit.row, unit.col, it->row, it->col};
+            actions.push_back(move);
+        }
+        targets.clear();
+        character.legalTargets(unit, *board, *occupancy, targets);
+        for (std::vector<GridPoint>::const_iterator it = targets.begin(); it != targets.end(); ++it)
+        {
+            const Command attack = {ATTACK, unit.row, unit.col, it->row, it->col};
+            actions.push_back(attack);
+        }
     }
 
     std::ostream &operator<<(std::ostream &os, const Game &game)
     {
-        char *char_board = game.boardToCharArray();
-        printGameBoard(os, char_board, char_board + game.board.size(), game.width);
-        delete[] char_board;
+        game.renderFrame();
+        os.write(game.frame.data(), game.frame.size());
         return os;
     }
 
-    bool Game::isOver(Team *winningTeam) const
+    std::ostream &Game::printViewport(std::ostream &os, const GridPoint &corner, int height, int width) const
     {
-        bool cpp_team = false, python_team = false;
-        char *char_board = boardToCharArray();
-        for (int i = 0; i < board.size(); i++)
+        if (height <= 0 || width <= 0 || checkLegalCell(corner) != SUCCESS ||
+            checkLegalCell(GridPoint(corner.row + height - 1, corner.col + width - 1)) != SUCCESS)
+        {
+            throw mtm::IllegalCell();
+        }
+        std::string viewport = makeFrame(height, width);
+        char *cell = &viewport[2 * width + 3];
+        for (int i = 0; i < height; i++, cell += 2)
         {
-            if (cpp_team && python_team)
+            const MatrixView<const std::shared_ptr<Character>> cells = board->row(corner.row + i).block(0, corner.col, 1, width);
+            for (int j = 0; j < width; j++, cell += 2)
             {
-                delete[] char_board;
-                return false;
-            }
-            if (char_board[i] != ' ')
-            {
-                if (checkWhichTeam(char_board[i]) == CPP)
-                {
-                    cpp_team = true;
-                }
-                else if (checkWhichTeam(char_board[i]) == PYTHON)
-                {
-                    python_team = true;
-                }
+                const std::shared_ptr<Character> &character = cells.atUnchecked(0, j);
+                *cell = character ? character->toChar() : ' ';
             }
         }
-        delete[] char_board;
+        os.write(viewport.data(), viewport.size());
+        return os;
+    }
+
+    bool Game::isOver(Team *winningTeam) const
+    {
+#ifdef MTM_CHECK_GAME
+        assert(teamUnitsMatchBoard());
+#endif
+        bool cpp_team = team_units[CPP] > 0, python_team = team_units[PYTHON] > 0;
         if ((!cpp_team && !python_team) || (cpp_team && python_team))
         {
             return false;
@@ -141,80 +350,285 @@ namespace mtm
         return true;
     }
 
-    char *Game::boardToCharArray() const
+    void Game::characterChanging(const GridPoint &point, const Character &character)
+    {
+        recordChange(point);
+        hash ^= characterKey(point, character);
+    }
+
+    void Game::characterChanged(const GridPoint &point, const Character &character)
     {
-        char *char_board = new char[board.size()];
-        int k = 0;
+        hash ^= characterKey(point, character);
+    }
+
+    void Game::characterRemoved(const GridPoint &point, const Character &character)
+    {
+        team_units[character.getTeam()]--;
+        occupancy->reset(point, character.getTeam());
+    }
+
+    std::vector<GridPoint> &Game::cellsBuffer()
+    {
+        cells_buffer.clear();
+        return cells_buffer;
+    }
+
+    bool Game::teamUnitsMatchBoard() const
+    {
+        int board_units[2] = {0, 0};
         for (int i = 0; i < height; i++)
         {
             for (int j = 0; j < width; j++)
             {
-                if (board(i, j))
+                if (board->atUnchecked(i, j))
                 {
-                    char_board[k++] = board(i, j)->toChar();
+                    board_units[board->atUnchecked(i, j)->getTeam()]++;
                 }
-                else
+            }
+        }
+        return board_units[CPP] == team_units[CPP] && board_units[PYTHON] == team_units[PYTHON];
+    }
+
+    bool Game::occupancyMatchesBoard() const
+    {
+        for (int i = 0; i < height; i++)
+        {
+            for (int j = 0; j < width; j++)
+            {
+                const std::shared_ptr<Character> &character = board->atUnchecked(i, j);
+                if (occupancy->isOccupied(GridPoint(i, j), CPP) != (character && character->getTeam() == CPP) ||
+                    occupancy->isOccupied(GridPoint(i, j), PYTHON) != (character && character->getTeam() == PYTHON))
                 {
-                    char_board[k++] = ' ';
+                    return false;
                 }
             }
         }
-        return char_board;
+        return true;
     }
 
-    Team Game::checkWhichTeam(char letter)
+    void Game::enableUndo(bool enable)
     {
-        if (letter >= 'a' && letter <= 'z')
+        undo_enabled = enable;
+        if (!enable)
         {
-            return PYTHON;
+            changes.clear();
+            action_starts.clear();
+            done_actions = 0;
         }
-        else
+    }
+
+    bool Game::undo()
+    {
+        if (done_actions == 0)
+        {
+            return false;
+        }
+        done_actions--;
+        const std::size_t first = action_starts[done_actions];
+        const std::size_t last = done_actions + 1 < action_starts.size() ? action_starts[done_actions + 1] : changes.size();
+        for (std::size_t i = last; i > first; i--)
         {
-            return CPP;
+            replaceCell(changes[i - 1].point, changes[i - 1].before);
         }
+        return true;
     }
 
-    void Game::verifyLegalCell(const GridPoint &point) const
+    bool Game::redo()
     {
-        if ((point.row >= board.height() || point.col >= board.width()) || ((point.row < 0) || (point.col < 0)))
+        if (done_actions == action_starts.size())
         {
-            throw mtm::IllegalCell();
+            return false;
+        }
+        const std::size_t first = action_starts[done_actions];
+        done_actions++;
+        const std::size_t last = done_actions < action_starts.size() ? action_starts[done_actions] : changes.size();
+        for (std::size_t i = first; i < last; i++)
+        {
+            replaceCell(changes[i].point, changes[i].after);
+        }
+        return true;
+    }
+
+    void Game::beginAction()
+    {
+        if (!undo_enabled)
+        {
+            return;
+        }
+        if (done_actions < action_starts.size())
+        {
+            changes.erase(changes.begin() + action_starts[done_actions], changes.end());
+            action_starts.resize(done_actions);
+        }
+        action_starts.push_back(changes.size());
+        done_actions++;
+    }
+
+    void Game::recordChange(const GridPoint &point)
+    {
+        if (undo_enabled)
+        {
+            changes.push_back(CellChange{point, board->atUnchecked(point.row, point.col), nullptr});
+        }
+    }
+
+    void Game::endAction()
+    {
+        if (!undo_enabled)
+        {
+            return;
+        }
+        for (std::size_t i = action_starts.back(); i < changes.size(); i++)
+        {
+            changes[i].after = board->atUnchecked(changes[i].point.row, changes[i].point.col);
         }
     }
 
-    void Game::verifyLegalEmptyCell(const GridPoint &point) const
+    void Game::replaceCell(const GridPoint &point, const std::shared_ptr<Character> &character)
+    {
+        std::shared_ptr<Character> &cell = writableBoard().writableCell(point.row, point.col);
+        if (cell)
+        {
+            team_units[cell->getTeam()]--;
+            occupancy->reset(point, cell->getTeam());
+            hash ^= characterKey(point, *cell);
+        }
+        cell = character;
+        if (cell)
+        {
+            team_units[cell->getTeam()]++;
+            occupancy->set(point, cell->getTeam());
+            hash ^= characterKey(point, *cell);
+        }
+    }
+
+    std::uint64_t Game::mixKey(std::uint64_t value)
+    {
+        value += 0x9e3779b97f4a7c15ULL;
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+        return value ^ (value >> 31);
+    }
+
+    std::uint64_t Game::characterKey(const GridPoint &point, const Character &character) const
+    {
+        // instead of a table of random keys (the health and ammo aren't bounded), the key of each property
+        // is mixed into the key of the previous ones
+        std::uint64_t key = mixKey((std::uint64_t(point.row * width + point.col) << 8) |
+                                   std::uint8_t(character.toChar()));
+        key = mixKey(key ^ std::uint32_t(character.getHealth()));
+        return mixKey(key ^ std::uint32_t(character.getAmmo()));
+    }
+
+    std::uint64_t Game::computeHash() const
     {
-        verifyLegalCell(point);
-        if (board(point.row, point.col) != nullptr)
+        std::uint64_t board_hash = 0;
+        for (int i = 0; i < height; i++)
         {
-            throw mtm::CellOccupied();
+            for (int j = 0; j < width; j++)
+            {
+                if (board->atUnchecked(i, j))
+                {
+                    board_hash ^= characterKey(GridPoint(i, j), *board->atUnchecked(i, j));
+                }
+            }
         }
+        return board_hash;
     }
 
-    void Game::verifyLegalOccupiedCell(const GridPoint &point) const
+    std::string Game::makeFrame(int height, int width)
     {
-        verifyLegalCell(point);
-        if (board(point.row, point.col) == nullptr)
+        const std::string delimiter(2 * width + 1, '*');
+        std::string row;
+        for (int j = 0; j < width; j++)
         {
-            throw mtm::CellEmpty();
+            row += "| ";
         }
+        row += "|\n";
+        std::string new_frame;
+        new_frame.reserve(2 * delimiter.size() + 1 + height * row.size());
+        new_frame += delimiter + '\n';
+        for (int i = 0; i < height; i++)
+        {
+            new_frame += row;
+        }
+        new_frame += delimiter;
+        return new_frame;
     }
 
-    void Game::copyBoardContentTo(Matrix<std::shared_ptr<Character>> &other_board) const
+    void Game::renderFrame() const
     {
-        Matrix<std::shared_ptr<Character>>::const_iterator it = board.begin();
-        Matrix<std::shared_ptr<Character>>::iterator other_it = other_board.begin();
-        for (; it != board.end(); it++)
+        if (frame.empty())
         {
-            if (*it)
+            frame = makeFrame(height, width);
+        }
+        const int row_length = 2 * width + 2;
+        char *cell = &frame[row_length + 1];
+        for (int i = 0; i < height; i++, cell += 2)
+        {
+            const MatrixView<const std::shared_ptr<Character>> cells = board->row(i);
+            for (int j = 0; j < width; j++, cell += 2)
             {
-                *other_it = std::shared_ptr<Character>((*it)->clone());
+                const std::shared_ptr<Character> &character = cells.atUnchecked(0, j);
+                *cell = character ? character->toChar() : ' ';
             }
-            other_it++;
         }
     }
 
+    ActionStatus Game::checkLegalCell(const GridPoint &point) const
+    {
+        if ((point.row >= board->height() || point.col >= board->width()) || ((point.row < 0) || (point.col < 0)))
+        {
+            return ILLEGAL_CELL;
+        }
+        return SUCCESS;
+    }
+
+    ActionStatus Game::checkLegalEmptyCell(const GridPoint &point) const
+    {
+        if (checkLegalCell(point) != SUCCESS)
+        {
+            return ILLEGAL_CELL;
+        }
+        if (occupancy->isOccupied(point))
+        {
+            return CELL_OCCUPIED;
+        }
+        return SUCCESS;
+    }
+
+    ActionStatus Game::checkLegalOccupiedCell(const GridPoint &point) const
+    {
+        if (checkLegalCell(point) != SUCCESS)
+        {
+            return ILLEGAL_CELL;
+        }
+        if (!occupancy->isOccupied(point))
+        {
+            return CELL_EMPTY;
+        }
+        return SUCCESS;
+    }
+
+    Board &Game::writableBoard()
+    {
+        if (board.use_count() != 1)
+        {
+            board = std::make_shared<Board>(*board);
+        }
+        if (occupancy.use_count() != 1)
+        {
+            occupancy = std::make_shared<Occupancy>(*occupancy);
+        }
+        return *board;
+    }
+
     Game::~Game()
     {
+        // the characters (of the board and of the history) are released as one bulk operation of the pools
+        PoolBatch batch;
+        changes.clear();
+        board.reset();
+        occupancy.reset();
     }
 } // namespace mtm
\ No newline at end of file
@@ -8,31 +8,86 @@
 #include "Matrix.h"
 #include "Exceptions.h"
 #include <cmath>
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace mtm {
+    /* CommandType: the actions a Command can perform */
+    enum CommandType { MOVE, ATTACK, RELOAD };
+
+    /* struct Command: a game action for Game::applyBatch.
+                       MOVE and ATTACK use both coordinates, RELOAD uses only the src coordinates */
+    struct Command {
+        CommandType type;
+        int src_row, src_col;
+        int dst_row, dst_col;
+    };
+
     /* class Game: Manages the game actions
     */
-    class Game
+    class Game : private BoardObserver
     {
-        Matrix<std::shared_ptr<Character>> board;
+        /* board: the cells of the game. Copies of a game share the board (and the characters on it) until
+                  one of them changes it: writableBoard gives the game its own copy of the board, which shares the
+                  chunks of cells with the original (see Board), an action copies only the chunks of the cells it
+                  changes, and only the characters it changes are cloned (Character::detach) */
+        std::shared_ptr<Board> board;
         int height, width;
+
+        /* occupancy: the cells of each team as bitboards, kept up to date by every action. It is shared by the
+                      copies of the game together with the board (writableBoard copies both, and the copy of the
+                      occupancy shares its words with the original the same way - see Occupancy) */
+        std::shared_ptr<Occupancy> occupancy;
+
+        /* team_units: the number of characters of each team (indexed by Team) on the board,
+                       kept up to date by every action so isOver doesn't need to scan the board */
+        int team_units[2];
+
+        /* hash: the Zobrist hash of the game - the xor of characterKey of every character on the board,
+                 kept up to date by every action */
+        std::uint64_t hash;
+
+        /* cells_buffer: the vector cellsBuffer lends to attacks (not copied with the game) */
+        std::vector<GridPoint> cells_buffer;
+
+        /* frame: the printed board (as printGameBoard prints it), allocated on the first print.
+                  The delimiters, '|' and newlines never change, so printing only rewrites the cells */
+        mutable std::string frame;
+
+        /* struct CellChange: a cell an action changed, with its character before and after the action.
+                              The recorded characters are never changed (the shared pointers in the history make
+                              the next change of such a character clone it - see Character::detach), so they keep
+                              the health, ammo and sniper attack counter the character had */
+        struct CellChange {
+            GridPoint point;
+            std::shared_ptr<Character> before, after;
+        };
+
+        /* the undo history (recorded only when undo is enabled): changes holds the cell changes of all the
+           recorded actions, action_starts the index in changes of the first change of each action, and the first
+           done_actions actions are applied (the rest were undone and can be redone) */
+        bool undo_enabled;
+        std::vector<CellChange> changes;
+        std::vector<std::size_t> action_starts;
+        std::size_t done_actions;
         
-        /* verifyLegalCell:  checks if a given set of coordinates is positive and within the game board  */
-        void verifyLegalCell(const GridPoint& point) const;
+        /* checkLegalCell:  checks if a given set of coordinates is positive and within the game board  */
+        ActionStatus checkLegalCell(const GridPoint& point) const;
 
-        /* verifyLegalEmptyCell:  checks if the given coordinates is legal and empty  */
-        void verifyLegalEmptyCell(const GridPoint& point) const;
+        /* checkLegalEmptyCell:  checks if the given coordinates is legal and empty  */
+        ActionStatus checkLegalEmptyCell(const GridPoint& point) const;
 
-        /* verifyLegalOccupiedCell:  checks if the given coordinates is legal and occupied  */
-        void verifyLegalOccupiedCell(const GridPoint& point) const;
+        /* checkLegalOccupiedCell:  checks if the given coordinates is legal and occupied  */
+        ActionStatus checkLegalOccupiedCell(const GridPoint& point) const;
         
-        /* checkWhichTeam:  returns the team of the character 
-                            based on the given letter that represents it in the board */        
-        static Team checkWhichTeam(char letter);
+        /* makeFrame:  Creates an empty frame for a board of the given size  */
+        static std::string makeFrame(int height, int width);
 
-        /* boardToCharArray:  Creates a array of chars according to each character type and team  */
-        char* boardToCharArray() const;
+        /* renderFrame:  Writes the char of each cell of the board into frame (creating the frame on the first print)  */
+        void renderFrame() const;
         
         /* isSoldier:  checks if a a character is of type soldier  */
         static bool isSoldier(std::shared_ptr<Character> attacker);
@@ -40,8 +95,56 @@ namespace mtm {
         /* soldierAttackRest:  attack rest of the board after soldier attack according to soldiers rules of attack  */
         void soldierAttackRest(std::shared_ptr<Character> attacker,const GridPoint &dst_coordinates,const int attack_strength);
 
-        /* copyBoardContentTo:  Copy all the contect of a game to another board (all the characters are cloned to the board)*/
-        void copyBoardContentTo(Matrix<std::shared_ptr<Character>>& other_board) const;
+        /* writableBoard:  returns the board for a change, after copying the board (and the occupancy) if they are
+                           shared with a copy of the game. The copies hold only the pointers to the chunks of cells
+                           and of bitboard words, and a chunk is copied when a cell of it is changed */
+        Board& writableBoard();
+
+        /* characterChanging, characterChanged:  update the hash when an attack changes the health of a character */
+        void characterChanging(const GridPoint& point, const Character& character) override;
+        void characterChanged(const GridPoint& point, const Character& character) override;
+
+        /* characterRemoved:  updates the team counters and the occupancy when an attack removes a dead character
+                              from the board */
+        void characterRemoved(const GridPoint& point, const Character& character) override;
+
+        /* cellsBuffer:  returns cells_buffer, emptied, to an attack (see BoardObserver) */
+        std::vector<GridPoint>& cellsBuffer() override;
+
+        /* teamUnitsMatchBoard:  checks the team counters against a full scan of the board
+                                 (used by the asserts of MTM_CHECK_GAME - see Game.cpp) */
+        bool teamUnitsMatchBoard() const;
+
+        /* occupancyMatchesBoard:  checks the occupancy against a full scan of the board
+                                   (used by the asserts of MTM_CHECK_GAME - see Game.cpp) */
+        bool occupancyMatchesBoard() const;
+
+        /* beginAction:  starts recording the changes of an action (dropping the actions that can be redone) */
+        void beginAction();
+
+        /* recordChange:  records the content of the given cell before the current action changes it */
+        void recordChange(const GridPoint& point);
+
+        /* endAction:  records the content of the cells the current action changed after it */
+        void endAction();
+
+        /* replaceCell:  puts the given character in the given cell, updating the team counters, the occupancy and the hash */
+        void replaceCell(const GridPoint& point, const std::shared_ptr<Character>& character);
+
+        /* mixKey:  returns a well mixed 64 bit value of the given value (the finalizer of splitmix64)  */
+        static std::uint64_t mixKey(std::uint64_t value);
+
+        /* characterKey:  returns the Zobrist key of the given character (its sign, health and ammo) in the given cell */
+        std::uint64_t characterKey(const GridPoint& point, const Character& character) const;
+
+        /* appendLegalActions:  appends to actions the legal actions of the unit in the given (occupied) cell,
+                                using targets as a buffer for its target cells  */
+        void appendLegalActions(const GridPoint& unit, std::vector<GridPoint>& targets,
+                                std::vector<Command>& actions) const;
+
+        /* computeHash:  returns the hash of the game computed from a full scan of the board
+                         (used by the asserts of MTM_CHECK_GAME - see Game.cpp) */
+        std::uint64_t computeHash() const;
 
 
 
@@ -50,16 +153,68 @@ namespace mtm {
         /* C'tor:  Creates a new game in the size of height and width  */
         Game(int height,  int width);
 
-        /* D'tor:  Destroys a game and frees all its resources */
+        /* D'tor:  Destroys a game and frees all its resources. The characters it frees go back to the
+                   character pools as one bulk operation (see PoolBatch) */
         ~Game();
 
-        /* Copy C'tor:  Creates a new game which is a copy of other */
+        /* Copy C'tor:  Creates a new game which is a copy of other, sharing its board until one of them changes it
+                        (in O(1): the first change of a cell copies the chunks it touches - see board)  */
         Game(const Game& other);
 
         /* =opeartor :  changes the game to be equivalent to other  */
         Game& operator=(const Game& other);
+
+        /* clone:  returns a copy of the game that shares nothing with it (every character is cloned),
+                   unlike a copy, it can be changed by another thread than the game.
+                   The characters are cloned as one bulk operation of the character pools (see PoolBatch) */
+        Game clone() const;
+
+        /* getHeight, getWidth:  return the dimensions of the board  */
+        int getHeight() const;
+        int getWidth() const;
+
+        /* enableUndo:  starts (or stops) recording the actions for undo and redo. The record of each action holds
+                        only the cells it changed; stopping the recording drops the recorded actions.
+                        A copy of the game (copy c'tor, = operator and clone) records its actions if the game
+                        does, and starts with an empty record  */
+        void enableUndo(bool enable=true);
+
+        /* undo:  reverts the last applied action (addCharacter, move, attack or reload) in O(cells it changed),
+                  returns false if there is no recorded action to undo  */
+        bool undo();
+
+        /* redo:  applies again the last undone action, returns false if there is no action to redo.
+                  Any new action drops the actions that can be redone  */
+        bool redo();
+
+        /* saveSnapshot:  writes the game (dimensions and every character with all its properties) to the stream or
+                          the file in the binary snapshot format (GameSnapshot.cpp), throws IllegalSnapshot if
+                          the writing failed  */
+        void saveSnapshot(std::ostream& os) const;
+        void saveSnapshot(const std::string& path) const;
+
+        /* loadSnapshot:  creates a game from a snapshot held in memory (size bytes at data),
+                          throws IllegalSnapshot if the data isn't a valid snapshot  */
+        static Game loadSnapshot(const char* data, std::size_t size);
+
+        /* loadSnapshotFile:  creates a game from a snapshot file (mapped to memory where possible, instead of
+                              being read), throws IllegalSnapshot if the file can't be read or isn't a valid snapshot  */
+        static Game loadSnapshotFile(const std::string& path);
+
+        /* getHash:  returns the (Zobrist) hash of the game: games with the same characters (type, team, health and
+                     ammo) in the same cells have the same hash. The hash is updated by every action in O(1) for
+                     each character the action changes  */
+        std::uint64_t getHash() const;
+
+        /* getOccupancy:  returns the cells occupied by each team, for spatial queries (the units of a team around a
+                          cell, the empty cells of a row or a column) that read 64 cells at a time  */
+        const Occupancy& getOccupancy() const override;
         
-        /* addCharacter:  Adds a new character to the game to the given coordinates */
+        /* addCharacter:  Adds a new character to the game to the given coordinates.
+                          Note: the game shares the character until it changes it (copy on write, see
+                          Character::detach), so if the caller keeps its own pointer to the character, the first
+                          change the game makes to it clones it, and the caller's character doesn't see that change
+                          or any later one  */
         void addCharacter(const GridPoint& coordinates, std::shared_ptr<Character> character);
         
         /* makeCharacter:  makes a new character
@@ -82,9 +237,34 @@ namespace mtm {
         /* reload:  reloads ammo for the character in the given coordinates */
         void reload(const GridPoint & coordinates);
 
+        /* tryMove, tryAttack, tryReload:  perform the same actions as move, attack and reload, but report an illegal
+                                           action by returning its status instead of throwing (SUCCESS if the action
+                                           was performed). An illegal action doesn't change the game */
+        ActionStatus tryMove(const GridPoint & src_coordinates, const GridPoint & dst_coordinates);
+        ActionStatus tryAttack(const GridPoint & src_coordinates, const GridPoint & dst_coordinates);
+        ActionStatus tryReload(const GridPoint & coordinates);
+
+        /* applyBatch:  performs count commands in order (as tryMove, tryAttack and tryReload), writes the status of
+                        commands[i] to results[i] (an array of at least count statuses), and returns isOver(winningTeam)
+                        of the game after the last command  */
+        bool applyBatch(const Command* commands, int count, ActionStatus* results, Team* winningTeam=NULL);
+
+        /* legalActions:  appends to actions every legal action of the unit in the given cell, or of every unit of
+                          the given team: the commands tryMove, tryAttack and tryReload would perform (a move to the
+                          cell of the unit included), without trying them. Each type of unit generates its own targets
+                          from the occupancy of the board. Returns the number of appended actions
+                          (0 for a cell that is illegal or empty). The vector can be reused to avoid allocations  */
+        int legalActions(const GridPoint& unit, std::vector<Command>& actions) const;
+        int legalActions(Team team, std::vector<Command>& actions) const;
+
         /* << operator: returns reference to ostream in order to print the game * */
         friend std::ostream& operator<<(std::ostream& os, const Game& game);
 
+        /* printViewport:  prints the height x width cells of the board whose top left cell is corner
+                           (in the format of <<), reading only those cells through a view of the board,
+                           throws IllegalCell if they aren't all inside the board  */
+        std::ostream& printViewport(std::ostream& os, const GridPoint& corner, int height, int width) const;
+
         /* isOver:  returns if the game is over: when there are characters of only one team on the board.
                     When a pointer to the winning team is received as a parameter, if the game is over the
                     pointer is overwritten to point to the winning team  */
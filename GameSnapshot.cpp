@@ -0,0 +1,182 @@
+#include "Game.h"
+#include "Serialization.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MTM_SNAPSHOT_MMAP
+#endif
+
+/* The snapshot format (all the numbers are little endian):
+   header (24 bytes):   "MTMG", version (uint32), height (int32), width (int32), number of units (uint32), 0 (uint32)
+   a record of 32 bytes for each unit, in row major order of their cells:
+                        row (int32), col (int32), type (uint8), team (uint8), 0 (2 bytes),
+                        health, ammo, range, power (int32), sniper attacks counter (int32, 0 for other types)
+   The records have a fixed size, so loading a snapshot only decodes the records - the cells are never parsed. */
+
+namespace mtm
+{
+    namespace
+    {
+        const char kSnapshotMagic[4] = {'M', 'T', 'M', 'G'};
+        const std::uint32_t kSnapshotVersion = 1;
+        const std::size_t kHeaderSize = 24, kRecordSize = 32;
+        // the records are written through a buffer of this many records
+        const std::size_t kRecordsPerWrite = 4096;
+    }
+
+    using serialization::putInt;
+    using serialization::getInt;
+    using serialization::getSignedInt;
+
+    void Game::saveSnapshot(std::ostream &os) const
+    {
+        char header[kHeaderSize] = {0};
+        std::memcpy(header, kSnapshotMagic, sizeof(kSnapshotMagic));
+        putInt(header + 4, kSnapshotVersion);
+        putInt(header + 8, height);
+        putInt(header + 12, width);
+        putInt(header + 16, team_units[CPP] + team_units[PYTHON]);
+        os.write(header, kHeaderSize);
+
+        std::vector<char> buffer(kRecordsPerWrite * kRecordSize);
+        std::size_t records = 0;
+        for (int i = 0; i < height; i++)
+        {
+            for (int j = 0; j < width; j++)
+            {
+                const std::shared_ptr<Character> &character = board->atUnchecked(i, j);
+                if (!character)
+                {
+                    continue;
+                }
+                char *record = &buffer[records * kRecordSize];
+                putInt(record, i);
+                putInt(record + 4, j);
+                record[8] = char(character->getType());
+                record[9] = char(character->getTeam());
+                record[10] = record[11] = 0;
+                putInt(record + 12, character->getHealth());
+                putInt(record + 16, character->getAmmo());
+                putInt(record + 20, character->getRange());
+                putInt(record + 24, character->getPower());
+                putInt(record + 28, character->getType() == SNIPER ? static_cast<const Sniper &>(*character).attacks_counter : 0);
+                if (++records == kRecordsPerWrite)
+                {
+                    os.write(buffer.data(), records * kRecordSize);
+                    records = 0;
+                }
+            }
+        }
+        os.write(buffer.data(), records * kRecordSize);
+        if (!os)
+        {
+            throw mtm::IllegalSnapshot();
+        }
+    }
+
+    void Game::saveSnapshot(const std::string &path) const
+    {
+        std::ofstream file(path.c_str(), std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            throw mtm::IllegalSnapshot();
+        }
+        saveSnapshot(file);
+        file.close();
+        if (!file)
+        {
+            throw mtm::IllegalSnapshot();
+        }
+    }
+
+    Game Game::loadSnapshot(const char *data, std::size_t size)
+    {
+        if (size < kHeaderSize || std::memcmp(data, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0 ||
+            getInt(data + 4) != kSnapshotVersion)
+        {
+            throw mtm::IllegalSnapshot();
+        }
+        const int height = getSignedInt(data + 8), width = getSignedInt(data + 12);
+        const std::size_t units = getInt(data + 16);
+        if (height <= 0 || width <= 0 || (size - kHeaderSize) / kRecordSize != units ||
+            (size - kHeaderSize) % kRecordSize != 0)
+        {
+            throw mtm::IllegalSnapshot();
+        }
+        Game game(height, width);
+        Board &cells = game.writableBoard();
+        for (const char *record = data + kHeaderSize; record != data + size; record += kRecordSize)
+        {
+            const int row = getSignedInt(record), col = getSignedInt(record + 4);
+            const unsigned char type = record[8], team = record[9];
+            const units_t health = getSignedInt(record + 12), ammo = getSignedInt(record + 16);
+            const units_t range = getSignedInt(record + 20), power = getSignedInt(record + 24);
+            const int attacks_counter = getSignedInt(record + 28);
+            if (game.checkLegalEmptyCell(GridPoint(row, col)) != SUCCESS || type > SNIPER || team > PYTHON ||
+                health <= 0 || ammo < 0 || range < 0 || power < 0 || attacks_counter < 0)
+            {
+                throw mtm::IllegalSnapshot();
+            }
+            std::shared_ptr<Character> character = makeCharacter(CharacterType(type), Team(team), health, ammo, range,
+                                                                 power);
+            if (type == SNIPER)
+            {
+                static_cast<Sniper &>(*character).attacks_counter = attacks_counter;
+            }
+            cells.writableCell(row, col) = character;
+            game.occupancy->set(GridPoint(row, col), Team(team));
+            game.team_units[team]++;
+            game.hash ^= game.characterKey(GridPoint(row, col), *character);
+        }
+        return game;
+    }
+
+    Game Game::loadSnapshotFile(const std::string &path)
+    {
+#ifdef MTM_SNAPSHOT_MMAP
+        const int file = open(path.c_str(), O_RDONLY);
+        if (file < 0)
+        {
+            throw mtm::IllegalSnapshot();
+        }
+        struct stat file_status;
+        if (fstat(file, &file_status) != 0 || file_status.st_size == 0)
+        {
+            close(file);
+            throw mtm::IllegalSnapshot();
+        }
+        const std::size_t size = std::size_t(file_status.st_size);
+        void *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, file, 0);
+        close(file);
+        if (data == MAP_FAILED)
+        {
+            throw mtm::IllegalSnapshot();
+        }
+        try
+        {
+            Game game = loadSnapshot(static_cast<const char *>(data), size);
+            munmap(data, size);
+            return game;
+        }
+        catch (...)
+        {
+            munmap(data, size);
+            throw;
+        }
+#else
+        std::ifstream file(path.c_str(), std::ios::binary);
+        if (!file)
+        {
+            throw mtm::IllegalSnapshot();
+        }
+        std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        return loadSnapshot(data.data(), data.size());
+#endif
+    }
+} // namespace mtm
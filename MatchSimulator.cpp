@@ -0,0 +1,158 @@
+#include "MatchSimulator.h"
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace mtm
+{
+    namespace
+    {
+        // the playouts are handed to the threads in chunks, so a thread that finishes its (short) playouts
+        // takes more work from the executor instead of waiting for the others
+        const int kPlayoutsPerChunk = 16;
+
+        struct ChunkResult
+        {
+            int wins[2];
+            long long actions, illegal_actions;
+        };
+
+        void playout(const Game &start, const PlayoutPolicy &policy, unsigned seed, int index, int max_turns,
+                     ChunkResult &result)
+        {
+            std::seed_seq seed_sequence{seed, unsigned(index)};
+            std::mt19937 rng(seed_sequence);
+            Game game(start);
+            Team winner = CPP;
+            bool over = game.isOver(&winner);
+            for (int turn = 0; turn < max_turns && !over; turn++)
+            {
+                const Command command = policy.nextCommand(game, rng);
+                ActionStatus status;
+                over = game.applyBatch(&command, 1, &status, &winner);
+                result.actions++;
+                if (status != SUCCESS)
+                {
+                    result.illegal_actions++;
+                }
+            }
+            if (over)
+            {
+                result.wins[winner]++;
+            }
+        }
+    }
+
+    namespace
+    {
+        // returns the executor of the simulations with the given number of threads: the calling thread alone,
+        // or a worker pool that is started by the first simulation with this number of threads and kept (until the
+        // program exits) for the next ones. If the workers can't be started, the pool joins the ones that were
+        // and the playouts are played on the calling thread, as kernels::forEachBlockRow does
+        Executor &simulationExecutor(const int threads)
+        {
+            static std::mutex pools_mutex;
+            static std::map<int, std::unique_ptr<ThreadPoolExecutor>> pools;
+            if (threads == 1)
+            {
+                return sequentialExecutor();
+            }
+            std::lock_guard<std::mutex> lock(pools_mutex);
+            std::unique_ptr<ThreadPoolExecutor> &pool = pools[threads];
+            if (!pool)
+            {
+                try
+                {
+                    pool.reset(new ThreadPoolExecutor(threads - 1));
+                }
+                catch (const std::system_error &)
+                {
+                    return sequentialExecutor();
+                }
+            }
+            return *pool;
+        }
+    }
+
+    Command RandomPolicy::nextCommand(const Game &game, std::mt19937 &rng) const
+    {
+        std::uniform_int_distribution<int> type(MOVE, RELOAD);
+        std::uniform_int_distribution<int> row(0, game.getHeight() - 1), col(0, game.getWidth() - 1);
+        Command command;
+        command.type = CommandType(type(rng));
+        command.src_row = row(rng);
+        command.src_col = col(rng);
+        command.dst_row = row(rng);
+        command.dst_col = col(rng);
+        return command;
+    }
+
+    double SimulationResult::winRate(Team team) const
+    {
+        return playouts == 0 ? 0 : double(wins[team]) / playouts;
+    }
+
+    double SimulationResult::playoutsPerSecond() const
+    {
+        return seconds == 0 ? 0 : playouts / seconds;
+    }
+
+    double SimulationResult::actionsPerSecond() const
+    {
+        return seconds == 0 ? 0 : actions / seconds;
+    }
+
+    SimulationResult simulate(const Game &start, const PlayoutPolicy &policy, unsigned seed, int playouts,
+                              int threads, int max_turns)
+    {
+        if (threads < 0)
+        {
+            throw mtm::IllegalArgument();
+        }
+        if (threads == 0)
+        {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        return simulate(start, policy, seed, playouts, simulationExecutor(threads), max_turns);
+    }
+
+    SimulationResult simulate(const Game &start, const PlayoutPolicy &policy, unsigned seed, int playouts,
+                              Executor &executor, int max_turns)
+    {
+        if (playouts < 0 || max_turns < 0)
+        {
+            throw mtm::IllegalArgument();
+        }
+        const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+
+        const int chunks = (playouts + kPlayoutsPerChunk - 1) / kPlayoutsPerChunk;
+        std::vector<ChunkResult> results(chunks, ChunkResult{{0, 0}, 0, 0});
+        executor.run(chunks, [&](const int chunk) {
+            // counted locally and stored once, so the threads don't write to neighbouring results
+            ChunkResult chunk_result = {{0, 0}, 0, 0};
+            const Game chunk_start = start.clone();
+            const int last = std::min(playouts, (chunk + 1) * kPlayoutsPerChunk);
+            for (int index = chunk * kPlayoutsPerChunk; index < last; index++)
+            {
+                playout(chunk_start, policy, seed, index, max_turns, chunk_result);
+            }
+            results[chunk] = chunk_result;
+        });
+
+        SimulationResult result = {playouts, {0, 0}, 0, 0, 0};
+        for (const ChunkResult &chunk_result : results)
+        {
+            result.wins[CPP] += chunk_result.wins[CPP];
+            result.wins[PYTHON] += chunk_result.wins[PYTHON];
+            result.actions += chunk_result.actions;
+            result.illegal_actions += chunk_result.illegal_actions;
+        }
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        return result;
+    }
+} // namespace mtm
@@ -0,0 +1,68 @@
+#ifndef MATCH_SIMULATOR_H
+#define MATCH_SIMULATOR_H
+#include "Game.h"
+#include "MatrixExecution.h"
+#include <random>
+
+namespace mtm {
+    /* class PlayoutPolicy: Interface for the choice of the actions of a playout.
+                            The same policy is used by all the threads of a simulation at the same time,
+                            so nextCommand must not change shared state (all the randomness comes from rng)
+    */
+    class PlayoutPolicy {
+        public:
+            virtual ~PlayoutPolicy() {}
+
+            /* nextCommand:  returns the next command to perform on the game */
+            virtual Command nextCommand(const Game& game, std::mt19937& rng) const = 0;
+    };
+
+    /* class RandomPolicy: Chooses a random action (type and coordinates) on the board, legal or not
+    */
+    class RandomPolicy : public PlayoutPolicy {
+        public:
+            Command nextCommand(const Game& game, std::mt19937& rng) const override;
+    };
+
+    /* struct SimulationResult: The results of the playouts of a simulation
+    */
+    struct SimulationResult {
+        int playouts;
+        /* wins: the number of playouts each team (indexed by Team) won; the rest weren't over after max_turns */
+        int wins[2];
+        long long actions, illegal_actions;
+        double seconds;
+
+        /* winRate:  returns the part of the playouts the given team won */
+        double winRate(Team team) const;
+
+        /* playoutsPerSecond, actionsPerSecond:  return the throughput of the simulation */
+        double playoutsPerSecond() const;
+        double actionsPerSecond() const;
+    };
+
+    const int kDefaultMaxTurns = 1000;
+
+    /* simulate:  plays independent random playouts from a starting game and returns their results
+        parameters: start: the game every playout starts from (not changed)
+                    policy: the choice of the actions of each playout
+                    seed: the seed of the playouts - playout i is played with its own generator seeded by (seed, i),
+                          so the results depend only on the seed and not on the number of threads
+                    playouts: the number of playouts to play
+                    threads: the number of threads (0 for the number of hardware threads), the calling thread included.
+                             The other threads are a ThreadPoolExecutor started by the first simulation with this
+                             number of threads and kept for the next ones. If they can't be started, the playouts
+                             are played on the calling thread
+                    max_turns: the maximal number of actions in a playout
+        The playouts are played in chunks, each from its own clone of start, so the threads share no game state.
+        An exception thrown by the policy stops the simulation and is rethrown  */
+    SimulationResult simulate(const Game& start, const PlayoutPolicy& policy, unsigned seed, int playouts,
+                              int threads=0, int max_turns=kDefaultMaxTurns);
+
+    /* simulate (executor):  as above, with the chunks of playouts run by the given executor (see MatrixExecution.h),
+                             e.g. a ThreadPoolExecutor the caller shares with its Matrix operations */
+    SimulationResult simulate(const Game& start, const PlayoutPolicy& policy, unsigned seed, int playouts,
+                              Executor& executor, int max_turns=kDefaultMaxTurns);
+}
+
+#endif
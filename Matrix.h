@@ -1,24 +1,109 @@
 #ifndef Matrix_H
 #define Matrix_H
 #include "Auxiliaries.h"
+#include <cstddef>
 #include <iostream>
+#include <iterator>
 #include <string>
 #include <cassert>
+#include <utility>
+#include <type_traits>
 #include "Exceptions.h"
+#include "MatrixExpression.h"
+#include "MatrixKernels.h"
+#include "MatrixExecution.h"
 
 namespace mtm {
+    /** Access policies of Matrix - whether the () operator and the iterators check that the accessed
+    *   element is inside the Matrix (and throw AccessIllegalElement otherwise).
+    *   A Matrix that is only accessed with indices that were already validated can be declared
+    *   Matrix<T, UncheckedAccess> to skip the checks; atUnchecked skips them for a single access of any Matrix.
+    * */
+    struct CheckedAccess {
+        static const bool kChecked = true;
+    };
+
+    struct UncheckedAccess {
+        static const bool kChecked = false;
+    };
+
+    /** MatrixExceptions - the exceptions thrown by Matrix<T>
+    * */
+    template <class T>
+    struct MatrixExceptions {
+        /** AccessIllegalElement:   Exception thrown when trying to access an illegal element in the Matrix 
+        * */
+        class AccessIllegalElement : public mtm::Exception{
+            std::string error_string;
+            public:
+            AccessIllegalElement(): error_string("Mtm matrix error: An attempt to access an illegal element"){}
+            const char* what() const noexcept { return error_string.c_str(); }
+        };
+
+        /** IllegalInitialization:   Exception thrown when trying to create a Matrix with illegal dimensions 
+        * */
+        class IllegalInitialization : public mtm::Exception{
+            std::string error_string;
+            public:
+            IllegalInitialization(): error_string("Mtm matrix error: Illegal initialization values"){}
+            const char* what() const noexcept { return error_string.c_str(); }
+        };
+        
+        /** DimensionMismatch:   Exception thrown when trying to operate on two Matrices with different dimensions 
+        * */
+        class DimensionMismatch : public mtm::Exception{
+            std::string error_string;
+            mtm::Dimensions dimensions_a;
+            mtm::Dimensions dimensions_b;
+            public:
+            DimensionMismatch(Dimensions dimensions_a,Dimensions dimensions_b) : 
+                                         error_string("Mtm matrix error: Dimension mismatch: " +
+                                         dimensions_a.toString() + " " + dimensions_b.toString()),
+                                         dimensions_a(dimensions_a),dimensions_b(dimensions_b) {}
+            const char* what() const noexcept { return error_string.c_str(); }
+        };
+    };
+
+    template <class T>
+    class MatrixView;
+
+    /** class MatrixSpan - the contiguous elements of a Matrix as a pointer and a size (a C++11 stand-in for
+    *   std::span): begin / end are plain pointers, so library routines that are specialized for pointers
+    *   (std::copy of trivially copyable types becomes memmove, ...) and C APIs can work on the elements directly.
+    *   Like a view, a span must not outlive its Matrix and is invalidated by assigning to the Matrix.
+    * */
+    template <class T>
+    class MatrixSpan {
+        T* first;
+        int count;
+        public:
+        typedef T element_type;
+        typedef typename std::remove_const<T>::type value_type;
+        typedef T* iterator;
+
+        MatrixSpan(T* first, const int count) : first(first), count(count) {}
+
+        T* data() const { return first; }
+        int size() const { return count; }
+        bool empty() const { return count == 0; }
+        T* begin() const { return first; }
+        T* end() const { return first + count; }
+        T& operator[](const int index) const { return first[index]; }
+    };
+
     /** class Matrix - implements a matrix container for objects of type T.
     * general assumptions on type T:
     * default c'tor, = operator, copy c'tor, d'tor.
     * function specific assumptions are listed per each function
+    * AccessPolicy: CheckedAccess (default) or UncheckedAccess, see above
     */
-    template <class T>
-    class Matrix{
+    template <class T, class AccessPolicy = CheckedAccess>
+    class Matrix : public MatrixExpression<Matrix<T, AccessPolicy>> {
         /** dimensions: the dimensions of the Matrix
-        *   data: all the Matrix objects
+        *   elements: all the Matrix objects, in row major order
         * */
         mtm::Dimensions dimensions;
-        T* data;
+        T* elements;
 
 
 
@@ -30,10 +115,24 @@ namespace mtm {
         * */
         static void verifyDimensions(const Dimensions dimensions);
 
+        /** evaluate:   Sets each entry to the matching element of the given expression (of the same dimensions).
+        *               The common expressions of 2 matrices, or a matrix and an object,
+        *               are evaluated by the vectorized kernels of MatrixKernels.h.
+        * */
+        template <class E>
+        void evaluate(const E& source);
+        void evaluate(const MatrixBinaryExpression<Matrix, Matrix, MatrixPlus<T>>& source);
+        void evaluate(const MatrixBinaryExpression<Matrix, Matrix, MatrixMinus<T>>& source);
+        void evaluate(const MatrixScalarExpression<Matrix, MatrixPlus<T>>& source);
+
+        template <class U, class OtherAccessPolicy>
+        friend class Matrix;
 
 
 
         public:
+        typedef T value_type;
+
         class iterator;
 
         /** iterator begin:   Creates a new iterator for the current Matrix
@@ -53,44 +152,32 @@ namespace mtm {
         * */
         const_iterator end() const;
 
-
-
-        
-        /** AccessIllegalElement:   Exception thrown when trying to access an illegal element in the Matrix 
+        /** cbegin / cend:   Creates const_iterators for the current Matrix, const or not
         * */
-        class AccessIllegalElement : public mtm::Exception{
-                std::string error_string;
-                public:
-                AccessIllegalElement(): error_string("Mtm matrix error: An attempt to access an illegal element"){}
-                const char* what() const noexcept;
-        };
+        const_iterator cbegin() const;
+        const_iterator cend() const;
 
-        /** IllegalInitialization:   Exception thrown when trying to create a Matrix with illegal dimensions 
+        /** data:   Returns a pointer to the first element of the Matrix. The elements are stored contiguously in
+        *           row major order: element (row, col) is data()[row * width() + col].
+        *           The pointer is invalidated by assigning to the Matrix.
         * */
-        class IllegalInitialization : public mtm::Exception{
-            std::string error_string;
-            public:
-            IllegalInitialization(): error_string("Mtm matrix error: Illegal initialization values"){}
-            const char* what() const noexcept;
-        };
-        
-        /** DimensionMismatch:   Exception thrown when trying to operate on two Matrices with different dimensions 
+        T* data();
+        const T* data() const;
+
+        /** span:   Returns the elements of the Matrix as a MatrixSpan (see above)
         * */
-        class DimensionMismatch : public mtm::Exception{
-            std::string error_string;
-            mtm::Dimensions dimensions_a;
-            mtm::Dimensions dimensions_b;
-            public:
-            DimensionMismatch(Dimensions dimensions_a,Dimensions dimensions_b) : 
-                                         dimensions_a(dimensions_a),dimensions_b(dimensions_b),
-                                         error_string("Mtm matrix error: Dimension mismatch: " +
-                                         dimensions_a.toString() + " " + dimensions_b.toString()) {};
-            const char* what() const noexcept;
-        };
-        
+        MatrixSpan<T> span();
+        MatrixSpan<const T> span() const;
 
 
         
+        /** AccessIllegalElement, IllegalInitialization, DimensionMismatch:   The Matrix exceptions (see MatrixExceptions),
+        *   shared by all the Matrices of the same element type regardless of their access policy
+        * */
+        typedef typename MatrixExceptions<T>::AccessIllegalElement AccessIllegalElement;
+        typedef typename MatrixExceptions<T>::IllegalInitialization IllegalInitialization;
+        typedef typename MatrixExceptions<T>::DimensionMismatch DimensionMismatch;
+
         /** Matrix C'tor:   Creates a Matrix in the dimensions given with value given in each entry.
         *                  If no value was given, each entry is constructed with the default T C'tor
         * @assumptions: default c'tor for T, = operator for T
@@ -102,6 +189,19 @@ namespace mtm {
         * */
         Matrix(const Matrix& matrix);
 
+        /** Matrix Move C'tor:  Creates a Matrix that takes over the data of the given Matrix without copying it.
+        *                       The given Matrix is left empty (0x0) and may only be assigned to or destroyed.
+        * @assumptions: none
+        * */
+        Matrix(Matrix&& matrix) noexcept;
+
+        /** Matrix Expression C'tor:  Creates a Matrix from the result of Matrix operators (see MatrixExpression.h).
+        *                             All the operators in the expression are evaluated in a single pass.
+        * @assumptions: the assumptions of the operators in the expression, = operator for T
+        * */
+        template <class E>
+        Matrix(const MatrixExpression<E>& expression);
+
         /** Diagonal:   Creates a Diagonal Matrix in the dimensions given, with given value in the diagonal
         * @assumptions: default c'tor for T, = operator for T
         * */
@@ -112,11 +212,22 @@ namespace mtm {
         * */
         Matrix& operator=(const Matrix& matrix);
 
-        /** - operator:     Creates a Matrix equivalent to the given Matrix, 
-         *                  with '-' operator applied on each entry.
-        * @assumptions:   - operator for T, = operator for T
+        /** =(Matrix&&) operator:   Change current Matrix to take over the data of the given Matrix without copying it.
+        * @assumptions:  none
+        * */
+        Matrix& operator=(Matrix&& matrix) noexcept;
+
+        /** swap:   Exchanges the contents of the current Matrix with the given Matrix.
+        * @assumptions:  none
+        * */
+        void swap(Matrix& matrix) noexcept;
+
+        /** =(MatrixExpression) operator:   Change current Matrix to be the result of the given expression.
+        *                                   The expression may refer to the current Matrix.
+        * @assumptions:  the assumptions of the operators in the expression, = operator for T
         * */
-        Matrix operator-() const;
+        template <class E>
+        Matrix& operator=(const MatrixExpression<E>& expression);
         
         /** height:     Returns the number of rows in the Matrix, 
         * */
@@ -130,10 +241,18 @@ namespace mtm {
         * */
         int size() const;
         
-        /** Transpose: returns a transposed matrix.
+        /** Transpose: returns a transposed matrix. A large matrix of trivially copyable elements is transposed a
+        *             row of tiles per chunk on the given executor.
         * @assumptions: = operator for T, calling Matrix<T> c'tor - default c'tor for T, and = operator for T
         * */
-        Matrix transpose() const;
+        Matrix transpose(Executor& executor = sequentialExecutor()) const;
+
+        /** transposeInPlace: transposes the matrix itself and returns it. A square matrix is transposed
+        *                     in its own data (no allocation), any other matrix is replaced by its transpose.
+        *                     Like transpose, a large matrix runs on the given executor.
+        * @assumptions: = operator for T (and swap for T for a square matrix)
+        * */
+        Matrix& transposeInPlace(Executor& executor = sequentialExecutor());
 
         /** () operator: returns a reference to an object in the matrix in the given row and column.
         * @assumptions:  = operator for T, calling Matrix<T> c'tor - default c'tor for T, and = operator for T; 
@@ -144,6 +263,30 @@ namespace mtm {
         * @assumptions: none
         * */
         const T& operator()(const int row, const int col) const; 
+
+        /** atUnchecked: returns a reference to the object in the given row and column without checking that it is
+        *                inside the Matrix (regardless of the access policy). For indices that were already validated.
+        * @assumptions: none; row and col are assumed to be legal
+        * */
+        T& atUnchecked(const int row, const int col);
+        const T& atUnchecked(const int row, const int col) const;
+
+        /** row / col / block: return a view (MatrixView.h) of a row, a column, or height x width entries starting at
+        *                      (row, col), which refers to the entries of the Matrix instead of copying them.
+        *                      Throw AccessIllegalElement if it isn't inside the Matrix.
+        * @assumptions: none
+        * */
+        MatrixView<T> row(const int row);
+        MatrixView<const T> row(const int row) const;
+        MatrixView<T> col(const int col);
+        MatrixView<const T> col(const int col) const;
+        MatrixView<T> block(const int row, const int col, const int height, const int width);
+        MatrixView<const T> block(const int row, const int col, const int height, const int width) const;
+
+        /** element: returns the element in the given flat (row major) index, used when evaluating expressions.
+        * @assumptions: none; index is assumed to be legal
+        * */
+        const T& element(const int index) const;
  
         /** += operator: adds an object of type T to each matrix entry
         * @assumptions: +,= operators for T, calling Matrix<T> c'tor - default c'tor for T, and = operator for T
@@ -154,7 +297,34 @@ namespace mtm {
         * @assumptions: calling Matrix<T> c'tor - default c'tor for T, and = operator for T
         * */
         template<class action>
-        Matrix<T> apply(action apply_action) const;
+        Matrix<T, AccessPolicy> apply(action apply_action) const;
+
+        /** apply, applyInPlace: apply returns a new matrix of the results of the given action on each entry, and
+        *                        applyInPlace replaces each entry by the result of the action on it. The flat data is
+        *                        split into cache line aligned chunks that run on the given executor, so the action
+        *                        must be safe to call from several threads when the executor runs them in parallel.
+        *                        If the action throws, applyInPlace leaves some entries changed.
+        * @assumptions: calling Matrix<T> c'tor - default c'tor for T, and = operator for T
+        * */
+        template<class action>
+        Matrix<T, AccessPolicy> apply(action apply_action, Executor& executor) const;
+        template<class action>
+        Matrix& applyInPlace(action apply_action, Executor& executor = sequentialExecutor());
+
+        /** reduce: returns the combination of all the entries by the given operation, chunk by chunk on the given
+        *           executor: each chunk is combined starting from init, and the results of the chunks are combined
+        *           in order starting from init. So the operation must be associative and init its identity
+        *           (0 for +, 1 for *).
+        * @assumptions: copy c'tor for U, operation can be called with (U, T) and with (U, U) and returns U
+        * */
+        template<class U, class BinaryOperation>
+        U reduce(U init, BinaryOperation operation, Executor& executor = sequentialExecutor()) const;
+
+        /** countIf: returns the number of entries for which the predicate is true, chunk by chunk on the given executor
+        * @assumptions: predicate can be called with T and its result can be converted to bool
+        * */
+        template<class Predicate>
+        int countIf(Predicate predicate, Executor& executor = sequentialExecutor()) const;
              
         /** Matrix Destructor: frees the data stored in the matrix and destroys the matrix.
         * @assumptions: destructor for T 
@@ -166,102 +336,145 @@ namespace mtm {
     /** << operator: returns reference to ostream in order to print the Matrix
         * @assumptions: = calling printMatrix - assuming that std::to_string can be called for T
     * */
-    template <class T>
-    std::ostream& operator<<(std::ostream& os, const Matrix<T>& matrix);
+    template <class T, class AccessPolicy>
+    std::ostream& operator<<(std::ostream& os, const Matrix<T, AccessPolicy>& matrix);
+
+    /** << operator: evaluates the given expression and prints the resulting Matrix
+        * @assumptions: the assumptions of the operators in the expression and of << for Matrix
+    * */
+    template <class E>
+    std::ostream& operator<<(std::ostream& os, const MatrixExpression<E>& expression);
+
+    /** swap: exchanges the contents of the 2 given matrices
+        * @assumptions: none
+    * */
+    template <class T, class AccessPolicy>
+    void swap(Matrix<T, AccessPolicy>& matrix_a, Matrix<T, AccessPolicy>& matrix_b) noexcept;
+
+    /* The operators below do not create a new Matrix: each of them returns a lightweight expression that
+    *  is evaluated element by element when it is assigned to a Matrix (see MatrixExpression.h).
+    *  An expression can be used wherever a Matrix is expected as an operand of these operators, all and any.
+    * */
+
+    /** - operator: returns a matrix equivalent to the given matrix, with '-' operator applied on each entry.
+        * @assumptions:   - operator for T, = operator for T
+    * */
+    template <class E>
+    constexpr MatrixUnaryExpression<E, MatrixNegate<typename E::value_type>>
+    operator-(const MatrixExpression<E>& matrix);
 
     /** + operator: returns a new matrix that contains the sum of 2 given matrices
         * @assumptions: +,= operators for T, calling Matrix<T> c'tor - default c'tor for T, and = operator for T
     * */
-    template <class T>
-    Matrix<T> operator+(const Matrix<T>& matrix_a, const Matrix<T>& matrix_b);
+    template <class L, class R>
+    constexpr MatrixBinaryExpression<L, R, MatrixPlus<typename L::value_type>>
+    operator+(const MatrixExpression<L>& matrix_a, const MatrixExpression<R>& matrix_b);
 
     /** + operator: returns a new matrix that contains the addition of the object (on the left) to the given matrix (on the right)
-        * @assumptions: calling Matrix<T> c'tor - default c'tor for T, and = operator for T; calling + operator for 2 matrices - +
-        * ,= operators for T
+        * @assumptions: +,= operators for T, calling Matrix<T> c'tor - default c'tor for T, and = operator for T
     * */
-    template <class T>
-    Matrix<T> operator+(const T object, const Matrix<T>& matrix);
+    template <class E>
+    constexpr MatrixScalarExpression<E, MatrixPlusFromLeft<typename E::value_type>>
+    operator+(const typename E::value_type& object, const MatrixExpression<E>& matrix);
 
     /** + operator: returns a new matrix that contains the addition of the object (on the right) to the given matrix (on the left)
-        * @assumptions: calling Matrix<T> c'tor - default c'tor for T, and = operator for T; calling += operator - +,= operators for T
+        * @assumptions: +,= operators for T, calling Matrix<T> c'tor - default c'tor for T, and = operator for T
     * */
-    template <class T>
-    Matrix<T> operator+(const Matrix<T>& matrix, const T object);
+    template <class E>
+    constexpr MatrixScalarExpression<E, MatrixPlus<typename E::value_type>>
+    operator+(const MatrixExpression<E>& matrix, const typename E::value_type& object);
 
     /** - operator: returns a new matrix that contains the subtraction of the right matrix from the left matrix
         * @assumptions: -,= operators for T, calling Matrix<T> c'tor - default c'tor for T
     * */
-    template <class T>
-    Matrix<T> operator-(const Matrix<T>& matrix_a, const Matrix<T>& matrix_b);
+    template <class L, class R>
+    constexpr MatrixBinaryExpression<L, R, MatrixMinus<typename L::value_type>>
+    operator-(const MatrixExpression<L>& matrix_a, const MatrixExpression<R>& matrix_b);
 
-    /** (Matrix)>(T) operator:  Returns a Matrix<bool> with true in the entries where each entry 
+    /** (Matrix)<=(T) operator:  Returns a Matrix<bool> with true in the entries where each entry 
     *                           is small or equal to object , and false otherwise
     * @assumptions:  <,== operator for T
     * */
-    template <class T>
-    Matrix<bool> operator<=(const Matrix<T>& matrix, const T object);
+    template <class E>
+    constexpr MatrixScalarExpression<E, MatrixLessEqual<typename E::value_type>>
+    operator<=(const MatrixExpression<E>& matrix, const typename E::value_type& object);
 
     /** (Matrix)<(T) operator:  Returns a Matrix<bool> with true in the entries where each entry 
     *                           is smaller then the object (determined by < operator on T), and false otherwise
     * @assumptions:  < operator for T
     * */
-    template <class T>
-    Matrix<bool> operator<(const Matrix<T>& matrix, const T object);
+    template <class E>
+    constexpr MatrixScalarExpression<E, MatrixLess<typename E::value_type>>
+    operator<(const MatrixExpression<E>& matrix, const typename E::value_type& object);
 
     /** (Matrix)>(T) operator:  Returns a Matrix<bool> with true in the entries where each entry 
     *                           is bigger then the object, and false otherwise
-    * @assumptions:  <= operator for T
+    * @assumptions:  <,== operator for T
     * */
-    template <class T>
-    Matrix<bool> operator>(const Matrix<T>& matrix, const T object);
+    template <class E>
+    constexpr MatrixScalarExpression<E, MatrixGreater<typename E::value_type>>
+    operator>(const MatrixExpression<E>& matrix, const typename E::value_type& object);
 
     /** (Matrix)>=(T) operator:  Returns a Matrix<bool> with true in the entries where each entry 
-    *                            is bigger or equal to object (determined by >= operator on T), and false otherwise
-    * @assumptions:   -, <= operator for T
+    *                            is bigger or equal to object, and false otherwise
+    * @assumptions:  <,== operator for T
     * */
-    template <class T>
-    Matrix<bool> operator>=(const Matrix<T>& matrix, const T object);
+    template <class E>
+    constexpr MatrixScalarExpression<E, MatrixGreaterEqual<typename E::value_type>>
+    operator>=(const MatrixExpression<E>& matrix, const typename E::value_type& object);
 
     /** (Matrix)==(T) operator:  Returns a Matrix<bool> with true in the entries where each entry 
     *                            is equivalent to object (determined by == operator on T), and false otherwise
     * @assumptions:  == operator for T
     * */
-    template <class T>
-    Matrix<bool> operator==(const Matrix<T>& matrix, const T object);
+    template <class E>
+    constexpr MatrixScalarExpression<E, MatrixEqual<typename E::value_type>>
+    operator==(const MatrixExpression<E>& matrix, const typename E::value_type& object);
 
     /** (Matrix)!=(T) operator:  Returns a Matrix<bool> with true in the entries where each entry 
     *                            is not equivalent to object , and false otherwise
     * @assumptions:  == operator for T
     * */
-    template <class T>
-    Matrix<bool> operator!=(const Matrix<T>& matrix, const T object);
+    template <class E>
+    constexpr MatrixScalarExpression<E, MatrixNotEqual<typename E::value_type>>
+    operator!=(const MatrixExpression<E>& matrix, const typename E::value_type& object);
 
     /** all: returns true if all the elements in the Matrix is equivalent to true after boolean conversion
+    *        (stops at the first element that is false)
     * @assumptions:  bool convertor for T
     * */
-    template <class T>
-    bool all(const Matrix<T>& matrix);
+    template <class E>
+    bool all(const MatrixExpression<E>& matrix);
     
     /** any: returns true if there is any element in the Matrix that is equivalent to true after boolean conversion
+    *        (stops at the first element that is true)
     * @assumptions:  bool convertor for T
     * */
-    template <class T>
-    bool any(const Matrix<T>& matrix);
+    template <class E>
+    bool any(const MatrixExpression<E>& matrix);
+
+    /** all / any with an executor: check the elements chunk by chunk on the executor; once the result is known
+    *                               the chunks that haven't started are skipped
+    * @assumptions:  bool convertor for T
+    * */
+    template <class E>
+    bool all(const MatrixExpression<E>& matrix, Executor& executor);
+    template <class E>
+    bool any(const MatrixExpression<E>& matrix, Executor& executor);
 
     
     
 
-
-    template <class T>
-    void Matrix<T>::verifyIndex(const int row,const int col) const
+    template <class T, class AccessPolicy>
+    void Matrix<T, AccessPolicy>::verifyIndex(const int row,const int col) const
     {
         if ((row < 0 || col < 0) || (row >= height() || col >= width())){
             throw AccessIllegalElement();
         }
     } 
 
-    template <class T>
-    void Matrix<T>::verifyDimensions(const Dimensions dimensions)
+    template <class T, class AccessPolicy>
+    void Matrix<T, AccessPolicy>::verifyDimensions(const Dimensions dimensions)
     {
         if(dimensions.getRow()<=0 || dimensions.getCol()<=0)
         {
@@ -271,206 +484,270 @@ namespace mtm {
 
     
 
-    template <class T>
-    const char* Matrix<T>::AccessIllegalElement::what() const noexcept{
-        return error_string.c_str();
-    }
-    
-    template <class T>
-    const char* Matrix<T>::IllegalInitialization::what() const noexcept{
-        return error_string.c_str();
-    }
-
-    template <class T>
-    const char* Matrix<T>::DimensionMismatch::what() const noexcept{
-        return error_string.c_str();
-    }
-
-    /**Iterator Class: used to iterate over the elements of a matrix
+    /**Iterator Classes: used to iterate over the elements of a matrix in row major order.
+    *  iterator and const_iterator are random access iterators (with the arithmetic and comparisons of a pointer),
+    *  so the standard algorithms - std::sort, std::nth_element, std::lower_bound, ... - run directly on a Matrix.
+    *  The elements are contiguous: &*(it + n) == &*it + n, and begin() points to data().
+    *  Under CheckedAccess, dereferencing an iterator outside the Matrix throws AccessIllegalElement.
     * */
-    template <class T>
-    class Matrix<T>::iterator {
-        const Matrix<T>* matrix;
+    template <class T, class AccessPolicy>
+    class Matrix<T, AccessPolicy>::iterator {
+        const Matrix<T, AccessPolicy>* matrix;
         int index;
-        
-        /**Iterator C'tor: Creates an iterator for the given matrix
+
+        /** Iterator C'tor: Creates an iterator for the given matrix
         * */
-        iterator(const Matrix<T>* matrix,int index);
-        friend class Matrix<T>;
+        iterator(const Matrix<T, AccessPolicy>* matrix, int index);
+        friend class Matrix<T, AccessPolicy>;
+        friend class const_iterator;
         public:
-        /**dereference (operator*) returns the element pointed to by the iterator by reference
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef T* pointer;
+        typedef T& reference;
+
+        /** iterator default C'tor: Creates an iterator that doesn't point to any matrix (it may only be assigned to)
         * */
-        T& operator*();
+        iterator();
 
-        /** prefix ++ operator (++it): advances the iterator one element forward
+        /** dereference (operator* / operator->): returns the element pointed to by the iterator by reference
         * */
-        iterator& operator++(); 
-        
-        /** postfix ++ operator (it++): advances the iterator one element forward after performing the rest of the code in the line
+        T& operator*() const;
+        T* operator->() const;
+
+        /** [] operator: returns the element n elements after the one pointed to by the iterator (checked like the dereference)
         * */
-        iterator operator++(int); 
-        
-        /** == operator: returns true if the 2 given iterators point to the same element in the matrix, returns false otherwise 
+        T& operator[](const difference_type n) const;
+
+        /** ++ / -- operators (++it, it++, --it, it--): advance the iterator one element forward / backward
+        * */
+        iterator& operator++();
+        iterator operator++(int);
+        iterator& operator--();
+        iterator operator--(int);
+
+        /** +=, -=, +, - operators: advance the iterator n elements forward (or backward for a negative n)
+        * */
+        iterator& operator+=(const difference_type n);
+        iterator& operator-=(const difference_type n);
+        iterator operator+(const difference_type n) const;
+        iterator operator-(const difference_type n) const;
+        friend iterator operator+(const difference_type n, const iterator& it) { return it + n; }
+
+        /** - operator (iterator): returns the number of elements from the given iterator to this one
+        *                      (both must point into the same matrix)
+        * */
+        difference_type operator-(const iterator& other) const;
+
+        /** == operator: returns true if the 2 given iterators point to the same element in the matrix, returns false otherwise
         * */
         bool operator==(const iterator& other) const;
 
-        /** == operator: returns true if the 2 given iterators point to different elements in the matrix, returns false otherwise 
+        /** != operator: returns true if the 2 given iterators point to different elements in the matrix, returns false otherwise
         * */
         bool operator!=(const iterator& other) const;
+
+        /** <, >, <=, >= operators: compare the positions of 2 iterators of the same matrix (in row major order)
+        * */
+        bool operator<(const iterator& other) const;
+        bool operator>(const iterator& other) const;
+        bool operator<=(const iterator& other) const;
+        bool operator>=(const iterator& other) const;
     };
 
-    template <class T>
-    class Matrix<T>::const_iterator {
-        const Matrix<T>* matrix;
+    template <class T, class AccessPolicy>
+    class Matrix<T, AccessPolicy>::const_iterator {
+        const Matrix<T, AccessPolicy>* matrix;
         int index;
+
         /** Const Iterator C'tor: Creates an iterator for the given matrix
         * */
-        const_iterator(const Matrix<T>* const matrix, int index);
-        friend class Matrix<T>;
+        const_iterator(const Matrix<T, AccessPolicy>* matrix, int index);
+        friend class Matrix<T, AccessPolicy>;
         public:
-        /**dereference (operator*) returns the element pointed to by the const_iterator by reference
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const T* pointer;
+        typedef const T& reference;
+
+        /** const_iterator default C'tor: Creates an iterator that doesn't point to any matrix (it may only be assigned to)
+        * */
+        const_iterator();
+
+        /** const_iterator conversion C'tor: Creates a const_iterator to the element pointed to by the given iterator
+        * */
+        const_iterator(const iterator& it);
+
+        /** dereference (operator* / operator->): returns the element pointed to by the const_iterator by reference
         * */
         const T& operator*() const;
+        const T* operator->() const;
 
-        /** prefix ++ operator (++it): advances the const_iterator one element forward
+        /** [] operator: returns the element n elements after the one pointed to by the const_iterator (checked like the dereference)
         * */
-        const_iterator& operator++(); 
+        const T& operator[](const difference_type n) const;
 
-        /** postfix ++ operator (it++): advances the iterator one element forward after performing the rest of the code in the line
+        /** ++ / -- operators (++it, it++, --it, it--): advance the const_iterator one element forward / backward
         * */
+        const_iterator& operator++();
         const_iterator operator++(int);
+        const_iterator& operator--();
+        const_iterator operator--(int);
 
-        /** == operator: returns true if the 2 given const_iterators point to the same element in the matrix, returns false otherwise 
+        /** +=, -=, +, - operators: advance the const_iterator n elements forward (or backward for a negative n)
+        * */
+        const_iterator& operator+=(const difference_type n);
+        const_iterator& operator-=(const difference_type n);
+        const_iterator operator+(const difference_type n) const;
+        const_iterator operator-(const difference_type n) const;
+        friend const_iterator operator+(const difference_type n, const const_iterator& it) { return it + n; }
+
+        /** - operator (const_iterator): returns the number of elements from the given const_iterator to this one
+        *                      (both must point into the same matrix)
+        * */
+        difference_type operator-(const const_iterator& other) const;
+
+        /** == operator: returns true if the 2 given const_iterators point to the same element in the matrix, returns false otherwise
         * */
         bool operator==(const const_iterator& other) const;
 
-        /** == operator: returns true if the 2 given const_iterators point to different elements in the matrix, returns false otherwise 
+        /** != operator: returns true if the 2 given const_iterators point to different elements in the matrix, returns false otherwise
         * */
         bool operator!=(const const_iterator& other) const;
+
+        /** <, >, <=, >= operators: compare the positions of 2 const_iterators of the same matrix (in row major order)
+        * */
+        bool operator<(const const_iterator& other) const;
+        bool operator>(const const_iterator& other) const;
+        bool operator<=(const const_iterator& other) const;
+        bool operator>=(const const_iterator& other) const;
     };
 
 
-    template <class T>
-    Matrix<T>::Matrix(const Dimensions dimensions, const T value) : dimensions(dimensions)
+    template <class T, class AccessPolicy>
+    Matrix<T, AccessPolicy>::Matrix(const Dimensions dimensions, const T value) : dimensions(dimensions)
         {
             verifyDimensions(dimensions);
             int total_size = dimensions.getRow()*dimensions.getCol();
-            data = new T[total_size]();
+            elements = new T[total_size]();
             for(int i = 0; i < total_size; i++){
-                data[i] = value;
+                elements[i] = value;
             }
         }
 
 
-    template <class T>
-    Matrix<T>::Matrix(const Matrix<T>& matrix) : dimensions(matrix.dimensions),data(new T[matrix.size()])
+    template <class T, class AccessPolicy>
+    Matrix<T, AccessPolicy>::Matrix(const Matrix<T, AccessPolicy>& matrix) : dimensions(matrix.dimensions),elements(new T[matrix.size()])
     {
         for(int i = 0; i < matrix.size(); i++){
-            data[i] = matrix.data[i];
+            elements[i] = matrix.elements[i];
         }
     }   
 
-    template <class T>
-    Matrix<T> Matrix<T>::Diagonal(const int dimension,const T value)
+    template <class T, class AccessPolicy>
+    Matrix<T, AccessPolicy>::Matrix(Matrix<T, AccessPolicy>&& matrix) noexcept : dimensions(matrix.dimensions),elements(matrix.elements)
+    {
+        matrix.dimensions = Dimensions(0,0);
+        matrix.elements = nullptr;
+    }
+
+    template <class T, class AccessPolicy>
+    Matrix<T, AccessPolicy> Matrix<T, AccessPolicy>::Diagonal(const int dimension,const T value)
     {
         Dimensions dimensions(dimension,dimension);
         verifyDimensions(dimensions);
-        Matrix<T> matrix(dimensions);
+        Matrix<T, AccessPolicy> matrix(dimensions);
         for (int i=0; i<dimension; i++){
             matrix(i,i) = value;
         }
         return matrix;
     }
 
-    template <class T>
-    Matrix<T> Matrix<T>::transpose() const{
+    template <class T, class AccessPolicy>
+    Matrix<T, AccessPolicy> Matrix<T, AccessPolicy>::transpose(Executor& executor) const{
         Dimensions result_dimensions(dimensions.getCol(), dimensions.getRow());
-        Matrix<T> result(result_dimensions);
-        int result_row = result.dimensions.getRow();
-        int result_col = result.dimensions.getCol();
-        for(int i=0; i < result_row; i++){
-            for(int j=0; j < result_col; j++){
-                result(i,j) = (*this)(j,i);
-            }
-        }
+        Matrix<T, AccessPolicy> result(result_dimensions);
+        kernels::transpose(elements, result.elements, height(), width(), executor);
         return result;
-    }    
+    }
+
+    template <class T, class AccessPolicy>
+    Matrix<T, AccessPolicy>& Matrix<T, AccessPolicy>::transposeInPlace(Executor& executor){
+        if(height() == width()){
+            kernels::transposeSquare(elements, height(), executor);
+        }
+        else{
+            *this = transpose(executor);
+        }
+        return *this;
+    }
         
-    template <class T>
-    Matrix<T>& Matrix<T>::operator+=(const T object){
-        Matrix<T> object_matrix((*this).dimensions, object);
-        *this = *this + object_matrix;
+    template <class T, class AccessPolicy>
+    Matrix<T, AccessPolicy>& Matrix<T, AccessPolicy>::operator+=(const T object){
+        *this = *this + object;
         return *this;
     }
-    
-    template <class T>
-    Matrix<T> Matrix<T>::operator-() const
+
+    /** verifyDimensionsMatch:   Checks that the 2 given expressions have the same dimensions, and returns the first.
+    *                           (A single expression, so that the operators using it can be constexpr.)
+    * */
+    template <class L, class R>
+    constexpr const L& verifyDimensionsMatch(const MatrixExpression<L>& matrix_a, const MatrixExpression<R>& matrix_b)
     {
-        Matrix<T> result = *this;
-        for(int i=0;i<(*this).height();i++){
-            for (int j=0; j<(*this).width(); j++)
-            {
-                result(i,j) = -(*this)(i,j);
-            }
-        }
-        return result;
+        return matrix_a.expression().height() == matrix_b.expression().height() &&
+               matrix_a.expression().width() == matrix_b.expression().width() ? matrix_a.expression() :
+               throw typename MatrixExceptions<typename L::value_type>::DimensionMismatch(
+                   Dimensions(matrix_a.expression().height(), matrix_a.expression().width()),
+                   Dimensions(matrix_b.expression().height(), matrix_b.expression().width()));
     }
 
-    template <class T>
-    Matrix<T> operator+(const Matrix<T>& matrix_a, const Matrix<T>& matrix_b)
+    template <class E>
+    constexpr MatrixUnaryExpression<E, MatrixNegate<typename E::value_type>>
+    operator-(const MatrixExpression<E>& matrix)
     {
-        Dimensions dimensions_a(matrix_a.height(), matrix_a.width());
-        Dimensions dimensions_b(matrix_b.height(), matrix_b.width());
-        if(dimensions_a != dimensions_b)
-        {
-            throw typename Matrix<T>::DimensionMismatch(dimensions_a, dimensions_b);
-        }
-        Matrix<T> result = matrix_a;
-        for(int i=0;i<matrix_a.height();i++){
-            for (int j=0; j<matrix_a.width(); j++)
-            {
-                result(i,j) = matrix_a(i,j) + matrix_b(i,j);
-            }
-        }
-        return result;
+        return MatrixUnaryExpression<E, MatrixNegate<typename E::value_type>>(matrix.expression());
     }
 
-    template <class T>
-    Matrix<T> operator+(const T object, const Matrix<T>& matrix)
+    template <class L, class R>
+    constexpr MatrixBinaryExpression<L, R, MatrixPlus<typename L::value_type>>
+    operator+(const MatrixExpression<L>& matrix_a, const MatrixExpression<R>& matrix_b)
     {
-        Dimensions dimensions(matrix.height(), matrix.width());
-        Matrix<T> object_matrix(dimensions, object);
-        return object_matrix+matrix; 
+        static_assert(std::is_same<typename L::value_type, typename R::value_type>::value,
+                      "Matrix operands must have the same element type");
+        static_assert(StaticDimensionsMayMatch<L, R>::value, "Matrix operands must have the same dimensions");
+        return MatrixBinaryExpression<L, R, MatrixPlus<typename L::value_type>>(
+                   verifyDimensionsMatch(matrix_a, matrix_b), matrix_b.expression());
     }
 
-    template <class T>
-    Matrix<T> operator+(const Matrix<T>& matrix, const T object)
+    template <class E>
+    constexpr MatrixScalarExpression<E, MatrixPlusFromLeft<typename E::value_type>>
+    operator+(const typename E::value_type& object, const MatrixExpression<E>& matrix)
     {
-        Matrix<T> result = matrix;    
-        return result+=object;
+        return MatrixScalarExpression<E, MatrixPlusFromLeft<typename E::value_type>>(matrix.expression(), object);
     }
 
-    template <class T>
-    Matrix<T> operator-(const Matrix<T>& matrix_a, const Matrix<T>& matrix_b){
-        Dimensions dimensions_a(matrix_a.height(), matrix_a.width());
-        Dimensions dimensions_b(matrix_b.height(), matrix_b.width());
-        if(dimensions_a != dimensions_b)
-        {
-            throw typename Matrix<T>::DimensionMismatch(dimensions_a, dimensions_b);
-        }
-        Matrix<T> result = matrix_a;
-        for(int i=0;i<matrix_a.height();i++){
-            for (int j=0; j<matrix_a.width(); j++)
-            {
-                result(i,j) = matrix_a(i,j) - matrix_b(i,j);
-            }
-        }
-        return result;
+    template <class E>
+    constexpr MatrixScalarExpression<E, MatrixPlus<typename E::value_type>>
+    operator+(const MatrixExpression<E>& matrix, const typename E::value_type& object)
+    {
+        return MatrixScalarExpression<E, MatrixPlus<typename E::value_type>>(matrix.expression(), object);
     }
 
-    
-    template <class T>
-    Matrix<T>& Matrix<T>::operator=(const Matrix<T>& matrix)
+    template <class L, class R>
+    constexpr MatrixBinaryExpression<L, R, MatrixMinus<typename L::value_type>>
+    operator-(const MatrixExpression<L>& matrix_a, const MatrixExpression<R>& matrix_b)
+    {
+        static_assert(std::is_same<typename L::value_type, typename R::value_type>::value,
+                      "Matrix operands must have the same element type");
+        static_assert(StaticDimensionsMayMatch<L, R>::value, "Matrix operands must have the same dimensions");
+        return MatrixBinaryExpression<L, R, MatrixMinus<typename L::value_type>>(
+                   verifyDimensionsMatch(matrix_a, matrix_b), matrix_b.expression());
+    }
+
+    template <class T, class AccessPolicy>
+    Matrix<T, AccessPolicy>& Matrix<T, AccessPolicy>::operator=(const Matrix<T, AccessPolicy>& matrix)
     {
         if(this == &matrix){
             return *this;
@@ -478,205 +755,445 @@ namespace mtm {
         T* new_data = new T[matrix.size()];
         try {
             for (int i = 0; i < matrix.size(); ++i) {
-                new_data[i] = matrix.data[i];
+                new_data[i] = matrix.elements[i];
             }
         } catch (...) {
             delete[] new_data;
             throw;
         }
-        delete[] data;
-        data=new_data;
+        delete[] elements;
+        elements=new_data;
         dimensions=matrix.dimensions;
         return *this;
     }
+
+    template <class T, class AccessPolicy>
+    Matrix<T, AccessPolicy>& Matrix<T, AccessPolicy>::operator=(Matrix<T, AccessPolicy>&& matrix) noexcept
+    {
+        swap(matrix);
+        return *this;
+    }
+
+    template <class T, class AccessPolicy>
+    void Matrix<T, AccessPolicy>::swap(Matrix<T, AccessPolicy>& matrix) noexcept
+    {
+        std::swap(dimensions, matrix.dimensions);
+        std::swap(elements, matrix.elements);
+    }
+
+    template <class T, class AccessPolicy>
+    void swap(Matrix<T, AccessPolicy>& matrix_a, Matrix<T, AccessPolicy>& matrix_b) noexcept
+    {
+        matrix_a.swap(matrix_b);
+    }
     
-    template <class T>
-    Matrix<bool> operator<(const Matrix<T>& matrix,const T object){
-        Dimensions dimensions(matrix.height(), matrix.width());
-        Matrix<bool> result(dimensions);
-        for(int i=0;i<result.height();i++){
-            for (int j=0; j<result.width(); j++)
-            {
-                if (matrix(i,j) < object){
-                    result(i,j) = true;
-                }
-            }
+    template <class T, class AccessPolicy>
+    template <class E>
+    Matrix<T, AccessPolicy>::Matrix(const MatrixExpression<E>& expression) :
+        dimensions(expression.expression().height(), expression.expression().width()),
+        elements(new T[expression.expression().size()])
+    {
+        static_assert(std::is_same<T, typename E::value_type>::value,
+                      "Matrix can only be created from an expression of the same element type");
+        try {
+            evaluate(expression.expression());
+        } catch (...) {
+            delete[] elements;
+            throw;
         }
-        return result;
     }
 
-    template <class T>
-    Matrix<bool> operator==(const Matrix<T>& matrix,const T object){
-        Dimensions dimensions(matrix.height(), matrix.width());
-        Matrix<bool> result(dimensions);
-        for(int i=0;i<result.height();i++){
-            for (int j=0; j<result.width(); j++)
-            {
-                if (matrix(i,j) == object){
-                    result(i,j) = true;
-                }
-            }
+    template <class T, class AccessPolicy>
+    template <class E>
+    void Matrix<T, AccessPolicy>::evaluate(const E& source)
+    {
+        int total_size = size();
+        for (int i = 0; i < total_size; ++i) {
+            elements[i] = source.element(i);
         }
-        return result;
     }
-    
-    template <class T>
-    Matrix<bool> operator<=(const Matrix<T>& matrix, const T object){
-        Dimensions dimensions(matrix.height(), matrix.width());
-        Matrix<bool> result(dimensions);
-        return result+(matrix<object)+(matrix==object);
+
+    template <class T, class AccessPolicy>
+    void Matrix<T, AccessPolicy>::evaluate(const MatrixBinaryExpression<Matrix<T, AccessPolicy>, Matrix<T, AccessPolicy>, MatrixPlus<T>>& source)
+    {
+        kernels::add(source.getLeft().elements, source.getRight().elements, elements, size());
     }
 
-    template <class T>
-    Matrix<bool> operator>=(const Matrix<T>& matrix,const T object){
-        Dimensions dimensions(matrix.height(), matrix.width());
-        Matrix<bool> result(dimensions);
-        return result+(matrix>object)+(matrix==object);
+    template <class T, class AccessPolicy>
+    void Matrix<T, AccessPolicy>::evaluate(const MatrixBinaryExpression<Matrix<T, AccessPolicy>, Matrix<T, AccessPolicy>, MatrixMinus<T>>& source)
+    {
+        kernels::subtract(source.getLeft().elements, source.getRight().elements, elements, size());
     }
 
-    template <class T>
-    Matrix<bool> operator>(const Matrix<T>& matrix,const T object){
-        Dimensions dimensions(matrix.height(), matrix.width());
-        Matrix<bool> result(dimensions,true);
-        return result-(matrix<=object);
+    template <class T, class AccessPolicy>
+    void Matrix<T, AccessPolicy>::evaluate(const MatrixScalarExpression<Matrix<T, AccessPolicy>, MatrixPlus<T>>& source)
+    {
+        kernels::addObject(source.getOperand().elements, source.getObject(), elements, size());
     }
 
-    template <class T>
-    Matrix<bool> operator!=(const Matrix<T>& matrix,const T object){
-        Dimensions dimensions(matrix.height(), matrix.width());
-        Matrix<bool> result(dimensions,true);
-        return result-(matrix==object);
-    }    
+    template <class T, class AccessPolicy>
+    template <class E>
+    Matrix<T, AccessPolicy>& Matrix<T, AccessPolicy>::operator=(const MatrixExpression<E>& expression)
+    {
+        Matrix<T, AccessPolicy> result(expression);
+        swap(result);
+        return *this;
+    }
 
-    template <class T>
-    T& Matrix<T>::operator()(const int row, const int col)
+    template <class E>
+    constexpr MatrixScalarExpression<E, MatrixLess<typename E::value_type>>
+    operator<(const MatrixExpression<E>& matrix, const typename E::value_type& object)
     {
-        verifyIndex(row, col);
-        return data[width()*row + col];
+        return MatrixScalarExpression<E, MatrixLess<typename E::value_type>>(matrix.expression(), object);
     }
 
-    template <class T>
-    const T& Matrix<T>::operator()(const int row, const int col) const
+    template <class E>
+    constexpr MatrixScalarExpression<E, MatrixEqual<typename E::value_type>>
+    operator==(const MatrixExpression<E>& matrix, const typename E::value_type& object)
     {
-        verifyIndex(row, col);
-        return data[width()*row + col];
+        return MatrixScalarExpression<E, MatrixEqual<typename E::value_type>>(matrix.expression(), object);
     }
 
-    template <class T>
-    int Matrix<T>::height() const
+    template <class E>
+    constexpr MatrixScalarExpression<E, MatrixLessEqual<typename E::value_type>>
+    operator<=(const MatrixExpression<E>& matrix, const typename E::value_type& object)
+    {
+        return MatrixScalarExpression<E, MatrixLessEqual<typename E::value_type>>(matrix.expression(), object);
+    }
+
+    template <class E>
+    constexpr MatrixScalarExpression<E, MatrixGreaterEqual<typename E::value_type>>
+    operator>=(const MatrixExpression<E>& matrix, const typename E::value_type& object)
+    {
+        return MatrixScalarExpression<E, MatrixGreaterEqual<typename E::value_type>>(matrix.expression(), object);
+    }
+
+    template <class E>
+    constexpr MatrixScalarExpression<E, MatrixGreater<typename E::value_type>>
+    operator>(const MatrixExpression<E>& matrix, const typename E::value_type& object)
+    {
+        return MatrixScalarExpression<E, MatrixGreater<typename E::value_type>>(matrix.expression(), object);
+    }
+
+    template <class E>
+    constexpr MatrixScalarExpression<E, MatrixNotEqual<typename E::value_type>>
+    operator!=(const MatrixExpression<E>& matrix, const typename E::value_type& object)
+    {
+        return MatrixScalarExpression<E, MatrixNotEqual<typename E::value_type>>(matrix.expression(), object);
+    }
+
+    template <class T, class AccessPolicy>
+    T& Matrix<T, AccessPolicy>::operator()(const int row, const int col)
+    {
+        if (AccessPolicy::kChecked) {
+            verifyIndex(row, col);
+        }
+        return elements[width()*row + col];
+    }
+
+    template <class T, class AccessPolicy>
+    const T& Matrix<T, AccessPolicy>::operator()(const int row, const int col) const
+    {
+        if (AccessPolicy::kChecked) {
+            verifyIndex(row, col);
+        }
+        return elements[width()*row + col];
+    }
+
+    template <class T, class AccessPolicy>
+    T& Matrix<T, AccessPolicy>::atUnchecked(const int row, const int col)
+    {
+        assert(row >= 0 && col >= 0 && row < height() && col < width());
+        return elements[width()*row + col];
+    }
+
+    template <class T, class AccessPolicy>
+    const T& Matrix<T, AccessPolicy>::atUnchecked(const int row, const int col) const
+    {
+        assert(row >= 0 && col >= 0 && row < height() && col < width());
+        return elements[width()*row + col];
+    }
+
+    template <class T, class AccessPolicy>
+    const T& Matrix<T, AccessPolicy>::element(const int index) const
+    {
+        return elements[index];
+    }
+
+    template <class T, class AccessPolicy>
+    int Matrix<T, AccessPolicy>::height() const
     {
         return dimensions.getRow();
     }
 
-    template <class T>
-    int Matrix<T>::width() const
+    template <class T, class AccessPolicy>
+    int Matrix<T, AccessPolicy>::width() const
     {
         return dimensions.getCol();
     }
 
-    template <class T>
-    int Matrix<T>::size() const
+    template <class T, class AccessPolicy>
+    int Matrix<T, AccessPolicy>::size() const
     {
         return dimensions.getRow()*dimensions.getCol();
     }
 
-    template <class T>
-    std::ostream& operator<<(std::ostream& os, const Matrix<T>& matrix)
+    template <class T, class AccessPolicy>
+    std::ostream& operator<<(std::ostream& os, const Matrix<T, AccessPolicy>& matrix)
     {
-        typename Matrix<T>::const_iterator begin = matrix.begin();
-        typename Matrix<T>::const_iterator end = matrix.end();
+        typename Matrix<T, AccessPolicy>::const_iterator begin = matrix.begin();
+        typename Matrix<T, AccessPolicy>::const_iterator end = matrix.end();
         printMatrix(os,begin,end, matrix.width());
         return os;
     }
 
-    template <class T>
-    bool all(const Matrix<T>& matrix)
-    {
-        int height=matrix.height();
-        int width=matrix.width();
-        for(int i=0;i<height;i++){
-            for (int j=0; j<width; j++){
-                if (!(bool)matrix(i,j)){
-                    return false;
-                }
+    template <class E>
+    std::ostream& operator<<(std::ostream& os, const MatrixExpression<E>& expression)
+    {
+        return os << Matrix<typename E::value_type>(expression);
+    }
+
+    template <class E>
+    bool all(const MatrixExpression<E>& matrix)
+    {
+        const E& source = matrix.expression();
+        int size = source.size();
+        for (int i = 0; i < size; i++){
+            if (!(bool)source.element(i)){
+                return false;
             }
         }
         return true;
     }
 
-    template <class T>
-    bool any(const Matrix<T>& matrix)
-    {
-        int height=matrix.height();
-        int width=matrix.width();
-        for(int i=0;i<height;i++){
-            for (int j=0; j<width; j++){
-                if ((bool)matrix(i,j)){
-                    return true;
-                }
+    template <class E>
+    bool any(const MatrixExpression<E>& matrix)
+    {
+        const E& source = matrix.expression();
+        int size = source.size();
+        for (int i = 0; i < size; i++){
+            if ((bool)source.element(i)){
+                return true;
             }
         }
         return false;
     }        
     
-    template <class T>
+    template <class E>
+    bool all(const MatrixExpression<E>& matrix, Executor& executor)
+    {
+        const E& source = matrix.expression();
+        std::atomic<bool> result(true);
+        execution::Chunks<typename E::value_type> chunks(nullptr, source.size());
+        execution::forEachChunk(executor, chunks, [&](const int, const int first, const int last){
+            for (int i = first; i < last && result.load(std::memory_order_relaxed); i++){
+                if (!(bool)source.element(i)){
+                    result = false;
+                }
+            }
+        });
+        return result;
+    }
+
+    template <class E>
+    bool any(const MatrixExpression<E>& matrix, Executor& executor)
+    {
+        const E& source = matrix.expression();
+        std::atomic<bool> result(false);
+        execution::Chunks<typename E::value_type> chunks(nullptr, source.size());
+        execution::forEachChunk(executor, chunks, [&](const int, const int first, const int last){
+            for (int i = first; i < last && !result.load(std::memory_order_relaxed); i++){
+                if ((bool)source.element(i)){
+                    result = true;
+                }
+            }
+        });
+        return result;
+    }
+
+    template <class T, class AccessPolicy>
     template<class action>
-    Matrix<T> Matrix<T>::apply(action apply_action) const
-    {
-        Matrix<T> new_matrix = *this;
-        int height=(*this).height();
-        int width=(*this).width();
-        for(int i=0;i<height;i++){
-            for (int j=0; j<width; j++){
-                new_matrix(i,j)=apply_action(new_matrix(i,j));
+    Matrix<T, AccessPolicy> Matrix<T, AccessPolicy>::apply(action apply_action) const
+    {
+        return apply(apply_action, sequentialExecutor());
+    }
+
+    template <class T, class AccessPolicy>
+    template<class action>
+    Matrix<T, AccessPolicy> Matrix<T, AccessPolicy>::apply(action apply_action, Executor& executor) const
+    {
+        Matrix<T, AccessPolicy> new_matrix(dimensions);
+        T* new_data = new_matrix.elements;
+        execution::forEachChunk(executor, execution::Chunks<T>(new_data, size()),
+                                [&](const int, const int first, const int last){
+            for (int i = first; i < last; i++){
+                new_data[i] = apply_action(elements[i]);
             }
-        }
+        });
         return new_matrix;
     }
 
-    template <class T>
-    Matrix<T>::~Matrix()
+    template <class T, class AccessPolicy>
+    template<class action>
+    Matrix<T, AccessPolicy>& Matrix<T, AccessPolicy>::applyInPlace(action apply_action, Executor& executor)
+    {
+        execution::forEachChunk(executor, execution::Chunks<T>(elements, size()),
+                                [&](const int, const int first, const int last){
+            for (int i = first; i < last; i++){
+                elements[i] = apply_action(elements[i]);
+            }
+        });
+        return *this;
+    }
+
+    template <class T, class AccessPolicy>
+    template<class U, class BinaryOperation>
+    U Matrix<T, AccessPolicy>::reduce(U init, BinaryOperation operation, Executor& executor) const
     {
-        delete[] data;
+        const execution::Chunks<T> chunks(elements, size());
+        std::vector<U> partials(chunks.count(), init);
+        execution::forEachChunk(executor, chunks, [&](const int chunk, const int first, const int last){
+            U partial = init;
+            for (int i = first; i < last; i++){
+                partial = operation(partial, elements[i]);
+            }
+            partials[chunk] = partial;
+        });
+        for (int i = 0; i < int(partials.size()); i++){
+            init = operation(init, partials[i]);
+        }
+        return init;
     }
 
-    template <class T>
-    typename Matrix<T>::iterator Matrix<T>::begin(){
+    template <class T, class AccessPolicy>
+    template<class Predicate>
+    int Matrix<T, AccessPolicy>::countIf(Predicate predicate, Executor& executor) const
+    {
+        std::atomic<int> count(0);
+        execution::forEachChunk(executor, execution::Chunks<T>(elements, size()),
+                                [&](const int, const int first, const int last){
+            int chunk_count = 0;
+            for (int i = first; i < last; i++){
+                if ((bool)predicate(elements[i])){
+                    chunk_count++;
+                }
+            }
+            count += chunk_count;
+        });
+        return count;
+    }
+
+    template <class T, class AccessPolicy>
+    Matrix<T, AccessPolicy>::~Matrix()
+    {
+        delete[] elements;
+    }
+
+    template <class T, class AccessPolicy>
+    typename Matrix<T, AccessPolicy>::iterator Matrix<T, AccessPolicy>::begin(){
         return iterator(this, 0);
     }
     
-    template <class T>
-    typename Matrix<T>::iterator Matrix<T>::end(){
+    template <class T, class AccessPolicy>
+    typename Matrix<T, AccessPolicy>::iterator Matrix<T, AccessPolicy>::end(){
         return iterator(this,size());
     }
 
-    template <class T>
-    Matrix<T>::iterator::iterator(const Matrix<T>* matrix,int index): matrix(matrix),index(index)
+    template <class T, class AccessPolicy>
+    Matrix<T, AccessPolicy>::iterator::iterator(const Matrix<T, AccessPolicy>* matrix, int index) : matrix(matrix), index(index)
     { }
 
-    template <class T>
-    T& Matrix<T>::iterator::operator*(){
-        matrix->verifyIndex(index/matrix->width(),index%matrix->width());
-        return matrix->data[index];
+    template <class T, class AccessPolicy>
+    Matrix<T, AccessPolicy>::iterator::iterator() : matrix(nullptr), index(0)
+    { }
+
+    template <class T, class AccessPolicy>
+    T& Matrix<T, AccessPolicy>::iterator::operator*() const
+    {
+        if (AccessPolicy::kChecked && (index < 0 || index >= matrix->size())) {
+            throw AccessIllegalElement();
+        }
+        return matrix->elements[index];
     }
 
-    template <class T>
-    typename Matrix<T>::iterator& Matrix<T>::iterator::operator++() // prefix (++it)
+    template <class T, class AccessPolicy>
+    T* Matrix<T, AccessPolicy>::iterator::operator->() const
+    {
+        return &**this;
+    }
+
+    template <class T, class AccessPolicy>
+    T& Matrix<T, AccessPolicy>::iterator::operator[](const difference_type n) const
+    {
+        return *(*this + n);
+    }
+
+    template <class T, class AccessPolicy>
+    typename Matrix<T, AccessPolicy>::iterator& Matrix<T, AccessPolicy>::iterator::operator++() // prefix (++it)
     {
         ++index;
         return *this;
     }
 
-    template <class T>
-    typename Matrix<T>::iterator Matrix<T>::iterator::operator++(int)
+    template <class T, class AccessPolicy>
+    typename Matrix<T, AccessPolicy>::iterator Matrix<T, AccessPolicy>::iterator::operator++(int)
     {
         iterator result = *this;
         ++*this;
         return result;
     }
 
-    template <class T>
-    bool Matrix<T>::iterator::operator==(const iterator& other) const
+    template <class T, class AccessPolicy>
+    typename Matrix<T, AccessPolicy>::iterator& Matrix<T, AccessPolicy>::iterator::operator--() // prefix (--it)
+    {
+        --index;
+        return *this;
+    }
+
+    template <class T, class AccessPolicy>
+    typename Matrix<T, AccessPolicy>::iterator Matrix<T, AccessPolicy>::iterator::operator--(int)
+    {
+        iterator result = *this;
+        --*this;
+        return result;
+    }
+
+    template <class T, class AccessPolicy>
+    typename Matrix<T, AccessPolicy>::iterator& Matrix<T, AccessPolicy>::iterator::operator+=(const difference_type n)
+    {
+        index += int(n);
+        return *this;
+    }
+
+    template <class T, class AccessPolicy>
+    typename Matrix<T, AccessPolicy>::iterator& Matrix<T, AccessPolicy>::iterator::operator-=(const difference_type n)
+    {
+        index -= int(n);
+        return *this;
+    }
+
+    template <class T, class AccessPolicy>
+    typename Matrix<T, AccessPolicy>::iterator Matrix<T, AccessPolicy>::iterator::operator+(const difference_type n) const
+    {
+        iterator result = *this;
+        return result += n;
+    }
+
+    template <class T, class AccessPolicy>
+    typename Matrix<T, AccessPolicy>::iterator Matrix<T, AccessPolicy>::iterator::operator-(const difference_type n) const
+    {
+        iterator result = *this;
+        return result -= n;
+    }
+
+    template <class T, class AccessPolicy>
+    typename Matrix<T, AccessPolicy>::iterator::difference_type Matrix<T, AccessPolicy>::iterator::operator-(const iterator& other) const
+    {
+        return difference_type(index) - other.index;
+    }
+
+    template <class T, class AccessPolicy>
+    bool Matrix<T, AccessPolicy>::iterator::operator==(const iterator& other) const
     {
         if(other.matrix != matrix){
             return false;
@@ -684,49 +1201,179 @@ namespace mtm {
         return index == other.index;
     }
 
-    template <class T>
-    bool Matrix<T>::iterator::operator!=(const iterator& other) const
+    template <class T, class AccessPolicy>
+    bool Matrix<T, AccessPolicy>::iterator::operator!=(const iterator& other) const
     {
         return !(*this==other);
     }
 
-    template <class T>
-    typename Matrix<T>::const_iterator Matrix<T>::begin() const{
+    template <class T, class AccessPolicy>
+    bool Matrix<T, AccessPolicy>::iterator::operator<(const iterator& other) const
+    {
+        return index < other.index;
+    }
+
+    template <class T, class AccessPolicy>
+    bool Matrix<T, AccessPolicy>::iterator::operator>(const iterator& other) const
+    {
+        return other < *this;
+    }
+
+    template <class T, class AccessPolicy>
+    bool Matrix<T, AccessPolicy>::iterator::operator<=(const iterator& other) const
+    {
+        return !(other < *this);
+    }
+
+    template <class T, class AccessPolicy>
+    bool Matrix<T, AccessPolicy>::iterator::operator>=(const iterator& other) const
+    {
+        return !(*this < other);
+    }
+
+    template <class T, class AccessPolicy>
+    typename Matrix<T, AccessPolicy>::const_iterator Matrix<T, AccessPolicy>::begin() const{
         return const_iterator(this, 0);
     }
     
-    template <class T>
-    typename Matrix<T>::const_iterator Matrix<T>::end() const{
+    template <class T, class AccessPolicy>
+    typename Matrix<T, AccessPolicy>::const_iterator Matrix<T, AccessPolicy>::end() const{
         return const_iterator(this,size());
     }
 
-    template <class T>
-    Matrix<T>::const_iterator::const_iterator(const Matrix<T>* matrix,int index): matrix(matrix),index(index)
+    template <class T, class AccessPolicy>
+    typename Matrix<T, AccessPolicy>::const_iterator Matrix<T, AccessPolicy>::cbegin() const{
+        return begin();
+    }
+
+    template <class T, class AccessPolicy>
+    typename Matrix<T, AccessPolicy>::const_iterator Matrix<T, AccessPolicy>::cend() const{
+        return end();
+    }
+
+    template <class T, class AccessPolicy>
+    T* Matrix<T, AccessPolicy>::data()
+    {
+        return elements;
+    }
+
+    template <class T, class AccessPolicy>
+    const T* Matrix<T, AccessPolicy>::data() const
+    {
+        return elements;
+    }
+
+    template <class T, class AccessPolicy>
+    MatrixSpan<T> Matrix<T, AccessPolicy>::span()
+    {
+        return MatrixSpan<T>(elements, size());
+    }
+
+    template <class T, class AccessPolicy>
+    MatrixSpan<const T> Matrix<T, AccessPolicy>::span() const
+    {
+        return MatrixSpan<const T>(elements, size());
+    }
+
+    template <class T, class AccessPolicy>
+    Matrix<T, AccessPolicy>::const_iterator::const_iterator(const Matrix<T, AccessPolicy>* matrix, int index) : matrix(matrix), index(index)
     { }
 
-    template <class T>
-    const T& Matrix<T>::const_iterator::operator*() const{
-        matrix->verifyIndex(index/matrix->width(),index%matrix->width());
-        return matrix->data[index];
+    template <class T, class AccessPolicy>
+    Matrix<T, AccessPolicy>::const_iterator::const_iterator() : matrix(nullptr), index(0)
+    { }
+
+    template <class T, class AccessPolicy>
+    Matrix<T, AccessPolicy>::const_iterator::const_iterator(const iterator& it) : matrix(it.matrix), index(it.index)
+    { }
+
+    template <class T, class AccessPolicy>
+    const T& Matrix<T, AccessPolicy>::const_iterator::operator*() const
+    {
+        if (AccessPolicy::kChecked && (index < 0 || index >= matrix->size())) {
+            throw AccessIllegalElement();
+        }
+        return matrix->elements[index];
     }
 
-    template <class T>
-    typename Matrix<T>::const_iterator& Matrix<T>::const_iterator::operator++() // prefix (++it)
+    template <class T, class AccessPolicy>
+    const T* Matrix<T, AccessPolicy>::const_iterator::operator->() const
+    {
+        return &**this;
+    }
+
+    template <class T, class AccessPolicy>
+    const T& Matrix<T, AccessPolicy>::const_iterator::operator[](const difference_type n) const
+    {
+        return *(*this + n);
+    }
+
+    template <class T, class AccessPolicy>
+    typename Matrix<T, AccessPolicy>::const_iterator& Matrix<T, AccessPolicy>::const_iterator::operator++() // prefix (++it)
     {
         ++index;
         return *this;
     }
 
-    template <class T>
-    typename Matrix<T>::const_iterator Matrix<T>::const_iterator::operator++(int)
+    template <class T, class AccessPolicy>
+    typename Matrix<T, AccessPolicy>::const_iterator Matrix<T, AccessPolicy>::const_iterator::operator++(int)
     {
         const_iterator result = *this;
         ++*this;
         return result;
     }
 
-    template <class T>
-    bool Matrix<T>::const_iterator::operator==(const const_iterator& other) const
+    template <class T, class AccessPolicy>
+    typename Matrix<T, AccessPolicy>::const_iterator& Matrix<T, AccessPolicy>::const_iterator::operator--() // prefix (--it)
+    {
+        --index;
+        return *this;
+    }
+
+    template <class T, class AccessPolicy>
+    typename Matrix<T, AccessPolicy>::const_iterator Matrix<T, AccessPolicy>::const_iterator::operator--(int)
+    {
+        const_iterator result = *this;
+        --*this;
+        return result;
+    }
+
+    template <class T, class AccessPolicy>
+    typename Matrix<T, AccessPolicy>::const_iterator& Matrix<T, AccessPolicy>::const_iterator::operator+=(const difference_type n)
+    {
+        index += int(n);
+        return *this;
+    }
+
+    template <class T, class AccessPolicy>
+    typename Matrix<T, AccessPolicy>::const_iterator& Matrix<T, AccessPolicy>::const_iterator::operator-=(const difference_type n)
+    {
+        index -= int(n);
+        return *this;
+    }
+
+    template <class T, class AccessPolicy>
+    typename Matrix<T, AccessPolicy>::const_iterator Matrix<T, AccessPolicy>::const_iterator::operator+(const difference_type n) const
+    {
+        const_iterator result = *this;
+        return result += n;
+    }
+
+    template <class T, class AccessPolicy>
+    typename Matrix<T, AccessPolicy>::const_iterator Matrix<T, AccessPolicy>::const_iterator::operator-(const difference_type n) const
+    {
+        const_iterator result = *this;
+        return result -= n;
+    }
+
+    template <class T, class AccessPolicy>
+    typename Matrix<T, AccessPolicy>::const_iterator::difference_type Matrix<T, AccessPolicy>::const_iterator::operator-(const const_iterator& other) const
+    {
+        return difference_type(index) - other.index;
+    }
+
+    template <class T, class AccessPolicy>
+    bool Matrix<T, AccessPolicy>::const_iterator::operator==(const const_iterator& other) const
     {
         if(other.matrix != matrix){
             return false;
@@ -734,14 +1381,39 @@ namespace mtm {
         return index == other.index;
     }
 
-    template <class T>
-    bool Matrix<T>::const_iterator::operator!=(const const_iterator& other) const
+    template <class T, class AccessPolicy>
+    bool Matrix<T, AccessPolicy>::const_iterator::operator!=(const const_iterator& other) const
     {
         return !(*this==other);
     }
-}
 
+    template <class T, class AccessPolicy>
+    bool Matrix<T, AccessPolicy>::const_iterator::operator<(const const_iterator& other) const
+    {
+        return index < other.index;
+    }
+
+    template <class T, class AccessPolicy>
+    bool Matrix<T, AccessPolicy>::const_iterator::operator>(const const_iterator& other) const
+    {
+        return other < *this;
+    }
+
+    template <class T, class AccessPolicy>
+    bool Matrix<T, AccessPolicy>::const_iterator::operator<=(const const_iterator& other) const
+    {
+        return !(other < *this);
+    }
+
+    template <class T, class AccessPolicy>
+    bool Matrix<T, AccessPolicy>::const_iterator::operator>=(const const_iterator& other) const
+    {
+        return !(*this < other);
+    }
+}
 
+#include "MatrixBool.h"
+#include "MatrixView.h"
 
 #endif //Matrix_H
 
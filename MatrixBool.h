@@ -0,0 +1,730 @@
+#ifndef MATRIX_BOOL_H
+#define MATRIX_BOOL_H
+#include "Matrix.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace mtm {
+    /** class Matrix<bool> - a Matrix of booleans, packed 64 entries per word.
+    *   This is what every comparison operator of Matrix produces, so masks of huge boards take
+    *   a bit per entry instead of a byte. It has the same interface as Matrix<T>, except that the
+    *   non const () operator and iterator return a proxy (Matrix<bool>::reference) instead of bool&,
+    *   and that it has no row / col / block views, data() or span() (a single entry has no address) - for
+    *   the same reason its iterators are only forward iterators.
+    *   The bits past the last entry of the last word are always 0.
+    *   Like Matrix<T>, the access policy decides whether the () operator and iterators check the index.
+    */
+    template <class AccessPolicy>
+    class Matrix<bool, AccessPolicy> : public MatrixExpression<Matrix<bool, AccessPolicy>> {
+        typedef kernels::word_t word_t;
+        static const int kBitsPerWord = kernels::kBitsPerWord;
+
+        /** dimensions: the dimensions of the Matrix
+        *   words: the bits of the Matrix entries, in row major order
+        * */
+        mtm::Dimensions dimensions;
+        word_t* words;
+
+        /** verifyIndex:   Checks if the index is a legal index.
+        * */
+        void verifyIndex(const int row, const int col) const;
+
+        /** verifyDimensions:   Checks if the dimensions are legal dimensions (bigger then zero).
+        * */
+        static void verifyDimensions(const Dimensions dimensions);
+
+        /** wordCount:   Returns the number of words needed for the Matrix entries.
+        * */
+        int wordCount() const;
+
+        /** lastWordMask:   Returns the bits of the last word that hold Matrix entries.
+        * */
+        word_t lastWordMask() const;
+
+        /** getBit / setBit:   Reads / writes the entry in the given flat index.
+        * */
+        bool getBit(const int index) const;
+        void setBit(const int index, const bool value);
+
+        /** fill:   Sets all the entries to value.
+        * */
+        void fill(const bool value);
+
+        /** evaluate:   Sets each entry to the matching element of the given expression (of the same dimensions).
+        *               A Matrix compared to an object is evaluated by the vectorized kernels of MatrixKernels.h.
+        * */
+        template <class E>
+        void evaluate(const E& source);
+        template <class T, class OtherAccessPolicy>
+        void evaluate(const MatrixScalarExpression<Matrix<T, OtherAccessPolicy>, MatrixLess<T>>& source);
+        template <class T, class OtherAccessPolicy>
+        void evaluate(const MatrixScalarExpression<Matrix<T, OtherAccessPolicy>, MatrixLessEqual<T>>& source);
+        template <class T, class OtherAccessPolicy>
+        void evaluate(const MatrixScalarExpression<Matrix<T, OtherAccessPolicy>, MatrixGreater<T>>& source);
+        template <class T, class OtherAccessPolicy>
+        void evaluate(const MatrixScalarExpression<Matrix<T, OtherAccessPolicy>, MatrixGreaterEqual<T>>& source);
+        template <class T, class OtherAccessPolicy>
+        void evaluate(const MatrixScalarExpression<Matrix<T, OtherAccessPolicy>, MatrixEqual<T>>& source);
+        template <class T, class OtherAccessPolicy>
+        void evaluate(const MatrixScalarExpression<Matrix<T, OtherAccessPolicy>, MatrixNotEqual<T>>& source);
+
+        /** evaluate:   The sum / difference of 2 boolean matrices is evaluated a word at a time
+        *               (+ is a logical or and - is a logical xor, the same results as converting the sum/difference to bool)
+        * */
+        template <class LeftAccessPolicy, class RightAccessPolicy>
+        void evaluate(const MatrixBinaryExpression<Matrix<bool, LeftAccessPolicy>, Matrix<bool, RightAccessPolicy>,
+                                                   MatrixPlus<bool>>& source);
+        template <class LeftAccessPolicy, class RightAccessPolicy>
+        void evaluate(const MatrixBinaryExpression<Matrix<bool, LeftAccessPolicy>, Matrix<bool, RightAccessPolicy>,
+                                                   MatrixMinus<bool>>& source);
+
+        /** evaluateComparison:   Evaluates a Matrix compared to an object with the kernels
+        *                         (a Matrix<bool> operand has no flat data, so it is evaluated element by element)
+        * */
+        template <class T, class OtherAccessPolicy, class Operation>
+        void evaluateComparison(const MatrixScalarExpression<Matrix<T, OtherAccessPolicy>, Operation>& source,
+                                const kernels::Comparison comparison);
+        template <class OtherAccessPolicy, class Operation>
+        void evaluateComparison(const MatrixScalarExpression<Matrix<bool, OtherAccessPolicy>, Operation>& source,
+                                const kernels::Comparison comparison);
+
+        template <class U, class OtherAccessPolicy>
+        friend class Matrix;
+
+        public:
+        typedef bool value_type;
+
+        class reference;
+        class iterator;
+        class const_iterator;
+
+        /** iterator begin / end:   Creates iterators for the current Matrix
+        * */
+        iterator begin();
+        iterator end();
+
+        /** const_iterator begin / end:   Creates const_iterators for the current const Matrix
+        * */
+        const_iterator begin() const;
+        const_iterator end() const;
+
+        /** AccessIllegalElement, IllegalInitialization, DimensionMismatch:   The Matrix exceptions (see MatrixExceptions)
+        * */
+        typedef typename MatrixExceptions<bool>::AccessIllegalElement AccessIllegalElement;
+        typedef typename MatrixExceptions<bool>::IllegalInitialization IllegalInitialization;
+        typedef typename MatrixExceptions<bool>::DimensionMismatch DimensionMismatch;
+
+        /** Matrix C'tor:   Creates a Matrix in the dimensions given with value given in each entry (false by default)
+        * */
+        Matrix(const mtm::Dimensions dimensions,const bool value = false);
+
+        /** Matrix Copy C'tor:  Creates a Matrix with the same values as the Matrix given
+        * */
+        Matrix(const Matrix& matrix);
+
+        /** Matrix Move C'tor:  Creates a Matrix that takes over the data of the given Matrix without copying it.
+        *                       The given Matrix is left empty (0x0) and may only be assigned to or destroyed.
+        * */
+        Matrix(Matrix&& matrix) noexcept;
+
+        /** Matrix Expression C'tor:  Creates a Matrix from the result of Matrix operators,
+        *                             packing 64 evaluated entries at a time.
+        * */
+        template <class E>
+        Matrix(const MatrixExpression<E>& expression);
+
+        /** Diagonal:   Creates a Diagonal Matrix in the dimensions given, with given value in the diagonal
+        * */
+        static Matrix Diagonal(const int dimension,const bool value);
+
+        /** =(Matrix) operator:   Change current Matrix to be equivalent to the given Matrix.
+        * */
+        Matrix& operator=(const Matrix& matrix);
+
+        /** =(Matrix&&) operator:   Change current Matrix to take over the data of the given Matrix without copying it.
+        * */
+        Matrix& operator=(Matrix&& matrix) noexcept;
+
+        /** =(MatrixExpression) operator:   Change current Matrix to be the result of the given expression.
+        * */
+        template <class E>
+        Matrix& operator=(const MatrixExpression<E>& expression);
+
+        /** swap:   Exchanges the contents of the current Matrix with the given Matrix.
+        * */
+        void swap(Matrix& matrix) noexcept;
+
+        /** height / width / size:     Returns the number of rows / columns / elements in the Matrix
+        * */
+        int height() const;
+        int width() const;
+        int size() const;
+
+        /** Transpose: returns a transposed matrix.
+        * */
+        Matrix transpose() const;
+
+        /** transposeInPlace: replaces the matrix by its transpose and returns it.
+        * */
+        Matrix& transposeInPlace();
+
+        /** () operator: returns a proxy reference to the entry in the given row and column.
+        * */
+        reference operator()(const int row, const int col);
+
+        /** () operator: returns the entry of a const matrix in the given row and column.
+        * */
+        bool operator()(const int row, const int col) const;
+
+        /** atUnchecked: returns the entry in the given row and column without checking that it is inside the Matrix
+        * */
+        reference atUnchecked(const int row, const int col);
+        bool atUnchecked(const int row, const int col) const;
+
+        /** element: returns the element in the given flat (row major) index, used when evaluating expressions.
+        * */
+        bool element(const int index) const;
+
+        /** += operator: adds (logical or) an object to each matrix entry
+        * */
+        Matrix& operator+=(const bool object);
+
+        /** apply: creates a new matrix - each entry contains the value after application of the given action
+        * @assumptions: action can be called with a bool, and its result can be converted to bool
+        * */
+        template<class action>
+        Matrix apply(action apply_action) const;
+
+        /** apply, applyInPlace, reduce, countIf: as in Matrix<T>, the chunks are whole words of entries
+        *                                         (so chunks run in parallel never write to the same word)
+        * */
+        template<class action>
+        Matrix apply(action apply_action, Executor& executor) const;
+        template<class action>
+        Matrix& applyInPlace(action apply_action, Executor& executor = sequentialExecutor());
+        template<class U, class BinaryOperation>
+        U reduce(U init, BinaryOperation operation, Executor& executor = sequentialExecutor()) const;
+        template<class Predicate>
+        int countIf(Predicate predicate, Executor& executor = sequentialExecutor()) const;
+
+        /** Matrix Destructor: frees the data stored in the matrix and destroys the matrix.
+        * */
+        ~Matrix();
+
+        /** all / any: checks a word at a time and stops at the first deciding word
+        * */
+        friend bool all(const Matrix& matrix)
+        {
+            int last = matrix.wordCount() - 1;
+            for (int i = 0; i < last; i++){
+                if (matrix.words[i] != ~word_t(0)){
+                    return false;
+                }
+            }
+            return last < 0 || matrix.words[last] == matrix.lastWordMask();
+        }
+
+        friend bool any(const Matrix& matrix)
+        {
+            for (int i = 0; i < matrix.wordCount(); i++){
+                if (matrix.words[i] != 0){
+                    return true;
+                }
+            }
+            return false;
+        }
+    };
+
+    /** reference: a proxy to a single entry of a Matrix<bool>
+    * */
+    template <class AccessPolicy>
+    class Matrix<bool, AccessPolicy>::reference {
+        word_t* word;
+        word_t mask;
+        reference(word_t* word, word_t mask) : word(word), mask(mask) {}
+        friend class Matrix<bool, AccessPolicy>;
+        public:
+        reference(const reference& other)=default;
+        operator bool() const { return (*word & mask) != 0; }
+        reference& operator=(const bool value) {
+            if (value) {
+                *word |= mask;
+            } else {
+                *word &= ~mask;
+            }
+            return *this;
+        }
+        reference& operator=(const reference& other) {
+            return *this = (bool)other;
+        }
+    };
+
+    /**Iterator Class: used to iterate over the elements of a matrix
+    * */
+    template <class AccessPolicy>
+    class Matrix<bool, AccessPolicy>::iterator {
+        Matrix<bool, AccessPolicy>* matrix;
+        int index;
+        iterator(Matrix<bool, AccessPolicy>* matrix,int index) : matrix(matrix), index(index) {}
+        friend class Matrix<bool, AccessPolicy>;
+        public:
+        reference operator*();
+        iterator& operator++() { ++index; return *this; }
+        iterator operator++(int) { iterator result = *this; ++*this; return result; }
+        bool operator==(const iterator& other) const { return matrix == other.matrix && index == other.index; }
+        bool operator!=(const iterator& other) const { return !(*this==other); }
+    };
+
+    template <class AccessPolicy>
+    class Matrix<bool, AccessPolicy>::const_iterator {
+        const Matrix<bool, AccessPolicy>* matrix;
+        int index;
+        const_iterator(const Matrix<bool, AccessPolicy>* matrix,int index) : matrix(matrix), index(index) {}
+        friend class Matrix<bool, AccessPolicy>;
+        public:
+        bool operator*() const;
+        const_iterator& operator++() { ++index; return *this; }
+        const_iterator operator++(int) { const_iterator result = *this; ++*this; return result; }
+        bool operator==(const const_iterator& other) const { return matrix == other.matrix && index == other.index; }
+        bool operator!=(const const_iterator& other) const { return !(*this==other); }
+    };
+
+
+    template <class AccessPolicy>
+    void Matrix<bool, AccessPolicy>::verifyIndex(const int row,const int col) const
+    {
+        if ((row < 0 || col < 0) || (row >= height() || col >= width())){
+            throw AccessIllegalElement();
+        }
+    }
+
+    template <class AccessPolicy>
+    void Matrix<bool, AccessPolicy>::verifyDimensions(const Dimensions dimensions)
+    {
+        if(dimensions.getRow()<=0 || dimensions.getCol()<=0)
+        {
+            throw IllegalInitialization();
+        }
+    }
+
+    template <class AccessPolicy>
+    int Matrix<bool, AccessPolicy>::wordCount() const
+    {
+        return (size() + kBitsPerWord - 1) / kBitsPerWord;
+    }
+
+    template <class AccessPolicy>
+    typename Matrix<bool, AccessPolicy>::word_t Matrix<bool, AccessPolicy>::lastWordMask() const
+    {
+        int used_bits = size() % kBitsPerWord;
+        return used_bits == 0 ? ~word_t(0) : (word_t(1) << used_bits) - 1;
+    }
+
+    template <class AccessPolicy>
+    bool Matrix<bool, AccessPolicy>::getBit(const int index) const
+    {
+        return (words[index / kBitsPerWord] >> (index % kBitsPerWord)) & 1;
+    }
+
+    template <class AccessPolicy>
+    void Matrix<bool, AccessPolicy>::setBit(const int index, const bool value)
+    {
+        word_t mask = word_t(1) << (index % kBitsPerWord);
+        if (value) {
+            words[index / kBitsPerWord] |= mask;
+        } else {
+            words[index / kBitsPerWord] &= ~mask;
+        }
+    }
+
+    template <class AccessPolicy>
+    void Matrix<bool, AccessPolicy>::fill(const bool value)
+    {
+        int word_count = wordCount();
+        if (word_count == 0) {
+            return;
+        }
+        std::fill(words, words + word_count, value ? ~word_t(0) : word_t(0));
+        words[word_count - 1] &= lastWordMask();
+    }
+
+    template <class AccessPolicy>
+    Matrix<bool, AccessPolicy>::Matrix(const Dimensions dimensions, const bool value) : dimensions(dimensions), words(nullptr)
+    {
+        verifyDimensions(dimensions);
+        words = new word_t[wordCount()];
+        fill(value);
+    }
+
+    template <class AccessPolicy>
+    Matrix<bool, AccessPolicy>::Matrix(const Matrix<bool, AccessPolicy>& matrix) :
+        dimensions(matrix.dimensions), words(new word_t[matrix.wordCount()])
+    {
+        std::copy(matrix.words, matrix.words + matrix.wordCount(), words);
+    }
+
+    template <class AccessPolicy>
+    Matrix<bool, AccessPolicy>::Matrix(Matrix<bool, AccessPolicy>&& matrix) noexcept : dimensions(matrix.dimensions), words(matrix.words)
+    {
+        matrix.dimensions = Dimensions(0,0);
+        matrix.words = nullptr;
+    }
+
+    template <class AccessPolicy>
+    template <class E>
+    Matrix<bool, AccessPolicy>::Matrix(const MatrixExpression<E>& expression) :
+        dimensions(expression.expression().height(), expression.expression().width()), words(nullptr)
+    {
+        static_assert(std::is_same<bool, typename E::value_type>::value,
+                      "Matrix can only be created from an expression of the same element type");
+        words = new word_t[wordCount()];
+        try {
+            evaluate(expression.expression());
+        } catch (...) {
+            delete[] words;
+            throw;
+        }
+    }
+
+    template <class AccessPolicy>
+    template <class E>
+    void Matrix<bool, AccessPolicy>::evaluate(const E& source)
+    {
+        int total_size = size();
+        for (int word_index = 0; word_index < wordCount(); ++word_index) {
+            int first = word_index * kBitsPerWord;
+            int last = std::min(first + kBitsPerWord, total_size);
+            word_t word = 0;
+            for (int i = first; i < last; ++i) {
+                word |= word_t(source.element(i) ? 1 : 0) << (i - first);
+            }
+            words[word_index] = word;
+        }
+    }
+
+    template <class AccessPolicy>
+    template <class T, class OtherAccessPolicy>
+    void Matrix<bool, AccessPolicy>::evaluate(const MatrixScalarExpression<Matrix<T, OtherAccessPolicy>, MatrixLess<T>>& source)
+    {
+        evaluateComparison(source, kernels::LESS);
+    }
+
+    template <class AccessPolicy>
+    template <class T, class OtherAccessPolicy>
+    void Matrix<bool, AccessPolicy>::evaluate(const MatrixScalarExpression<Matrix<T, OtherAccessPolicy>, MatrixLessEqual<T>>& source)
+    {
+        evaluateComparison(source, kernels::LESS_EQUAL);
+    }
+
+    template <class AccessPolicy>
+    template <class T, class OtherAccessPolicy>
+    void Matrix<bool, AccessPolicy>::evaluate(const MatrixScalarExpression<Matrix<T, OtherAccessPolicy>, MatrixGreater<T>>& source)
+    {
+        evaluateComparison(source, kernels::GREATER);
+    }
+
+    template <class AccessPolicy>
+    template <class T, class OtherAccessPolicy>
+    void Matrix<bool, AccessPolicy>::evaluate(const MatrixScalarExpression<Matrix<T, OtherAccessPolicy>, MatrixGreaterEqual<T>>& source)
+    {
+        evaluateComparison(source, kernels::GREATER_EQUAL);
+    }
+
+    template <class AccessPolicy>
+    template <class T, class OtherAccessPolicy>
+    void Matrix<bool, AccessPolicy>::evaluate(const MatrixScalarExpression<Matrix<T, OtherAccessPolicy>, MatrixEqual<T>>& source)
+    {
+        evaluateComparison(source, kernels::EQUAL);
+    }
+
+    template <class AccessPolicy>
+    template <class T, class OtherAccessPolicy>
+    void Matrix<bool, AccessPolicy>::evaluate(const MatrixScalarExpression<Matrix<T, OtherAccessPolicy>, MatrixNotEqual<T>>& source)
+    {
+        evaluateComparison(source, kernels::NOT_EQUAL);
+    }
+
+    template <class AccessPolicy>
+    template <class LeftAccessPolicy, class RightAccessPolicy>
+    void Matrix<bool, AccessPolicy>::evaluate(const MatrixBinaryExpression<Matrix<bool, LeftAccessPolicy>,
+                                              Matrix<bool, RightAccessPolicy>, MatrixPlus<bool>>& source)
+    {
+        for (int i = 0; i < wordCount(); i++){
+            words[i] = source.getLeft().words[i] | source.getRight().words[i];
+        }
+    }
+
+    template <class AccessPolicy>
+    template <class LeftAccessPolicy, class RightAccessPolicy>
+    void Matrix<bool, AccessPolicy>::evaluate(const MatrixBinaryExpression<Matrix<bool, LeftAccessPolicy>,
+                                              Matrix<bool, RightAccessPolicy>, MatrixMinus<bool>>& source)
+    {
+        for (int i = 0; i < wordCount(); i++){
+            words[i] = source.getLeft().words[i] ^ source.getRight().words[i];
+        }
+    }
+
+    template <class AccessPolicy>
+    template <class T, class OtherAccessPolicy, class Operation>
+    void Matrix<bool, AccessPolicy>::evaluateComparison(
+        const MatrixScalarExpression<Matrix<T, OtherAccessPolicy>, Operation>& source, const kernels::Comparison comparison)
+    {
+        kernels::compare(source.getOperand().elements, source.getObject(), words, size(), comparison);
+    }
+
+    template <class AccessPolicy>
+    template <class OtherAccessPolicy, class Operation>
+    void Matrix<bool, AccessPolicy>::evaluateComparison(
+        const MatrixScalarExpression<Matrix<bool, OtherAccessPolicy>, Operation>& source, const kernels::Comparison)
+    {
+        evaluate<MatrixScalarExpression<Matrix<bool, OtherAccessPolicy>, Operation>>(source);
+    }
+
+    template <class AccessPolicy>
+    Matrix<bool, AccessPolicy> Matrix<bool, AccessPolicy>::Diagonal(const int dimension, const bool value)
+    {
+        Dimensions dimensions(dimension,dimension);
+        verifyDimensions(dimensions);
+        Matrix<bool, AccessPolicy> matrix(dimensions);
+        for (int i=0; i<dimension; i++){
+            matrix.setBit(i * dimension + i, value);
+        }
+        return matrix;
+    }
+
+    template <class AccessPolicy>
+    Matrix<bool, AccessPolicy>& Matrix<bool, AccessPolicy>::operator=(const Matrix<bool, AccessPolicy>& matrix)
+    {
+        if(this == &matrix){
+            return *this;
+        }
+        Matrix<bool, AccessPolicy> copy(matrix);
+        swap(copy);
+        return *this;
+    }
+
+    template <class AccessPolicy>
+    Matrix<bool, AccessPolicy>& Matrix<bool, AccessPolicy>::operator=(Matrix<bool, AccessPolicy>&& matrix) noexcept
+    {
+        swap(matrix);
+        return *this;
+    }
+
+    template <class AccessPolicy>
+    template <class E>
+    Matrix<bool, AccessPolicy>& Matrix<bool, AccessPolicy>::operator=(const MatrixExpression<E>& expression)
+    {
+        Matrix<bool, AccessPolicy> result(expression);
+        swap(result);
+        return *this;
+    }
+
+    template <class AccessPolicy>
+    void Matrix<bool, AccessPolicy>::swap(Matrix<bool, AccessPolicy>& matrix) noexcept
+    {
+        std::swap(dimensions, matrix.dimensions);
+        std::swap(words, matrix.words);
+    }
+
+    template <class AccessPolicy>
+    int Matrix<bool, AccessPolicy>::height() const
+    {
+        return dimensions.getRow();
+    }
+
+    template <class AccessPolicy>
+    int Matrix<bool, AccessPolicy>::width() const
+    {
+        return dimensions.getCol();
+    }
+
+    template <class AccessPolicy>
+    int Matrix<bool, AccessPolicy>::size() const
+    {
+        return dimensions.getRow()*dimensions.getCol();
+    }
+
+    template <class AccessPolicy>
+    Matrix<bool, AccessPolicy> Matrix<bool, AccessPolicy>::transpose() const
+    {
+        Matrix<bool, AccessPolicy> result(Dimensions(width(), height()));
+        for(int i=0; i < height(); i++){
+            for(int j=0; j < width(); j++){
+                if (getBit(i * width() + j)) {
+                    result.setBit(j * height() + i, true);
+                }
+            }
+        }
+        return result;
+    }
+
+    template <class AccessPolicy>
+    Matrix<bool, AccessPolicy>& Matrix<bool, AccessPolicy>::transposeInPlace()
+    {
+        *this = transpose();
+        return *this;
+    }
+
+    template <class AccessPolicy>
+    typename Matrix<bool, AccessPolicy>::reference Matrix<bool, AccessPolicy>::operator()(const int row, const int col)
+    {
+        if (AccessPolicy::kChecked) {
+            verifyIndex(row, col);
+        }
+        return atUnchecked(row, col);
+    }
+
+    template <class AccessPolicy>
+    typename Matrix<bool, AccessPolicy>::reference Matrix<bool, AccessPolicy>::atUnchecked(const int row, const int col)
+    {
+        assert(row >= 0 && col >= 0 && row < height() && col < width());
+        int index = width()*row + col;
+        return reference(&words[index / kBitsPerWord], word_t(1) << (index % kBitsPerWord));
+    }
+
+    template <class AccessPolicy>
+    bool Matrix<bool, AccessPolicy>::operator()(const int row, const int col) const
+    {
+        if (AccessPolicy::kChecked) {
+            verifyIndex(row, col);
+        }
+        return atUnchecked(row, col);
+    }
+
+    template <class AccessPolicy>
+    bool Matrix<bool, AccessPolicy>::atUnchecked(const int row, const int col) const
+    {
+        assert(row >= 0 && col >= 0 && row < height() && col < width());
+        return getBit(width()*row + col);
+    }
+
+    template <class AccessPolicy>
+    bool Matrix<bool, AccessPolicy>::element(const int index) const
+    {
+        return getBit(index);
+    }
+
+    template <class AccessPolicy>
+    Matrix<bool, AccessPolicy>& Matrix<bool, AccessPolicy>::operator+=(const bool object)
+    {
+        if (object) {
+            fill(true);
+        }
+        return *this;
+    }
+
+    template <class AccessPolicy>
+    template<class action>
+    Matrix<bool, AccessPolicy> Matrix<bool, AccessPolicy>::apply(action apply_action) const
+    {
+        return apply(apply_action, sequentialExecutor());
+    }
+
+    template <class AccessPolicy>
+    template<class action>
+    Matrix<bool, AccessPolicy> Matrix<bool, AccessPolicy>::apply(action apply_action, Executor& executor) const
+    {
+        Matrix<bool, AccessPolicy> new_matrix(dimensions);
+        execution::forEachChunk(executor, execution::Chunks<word_t>(new_matrix.words, wordCount()),
+                                [&](const int, const int first, const int last){
+            for (int i = first * kBitsPerWord; i < std::min(size(), last * kBitsPerWord); i++){
+                new_matrix.setBit(i, apply_action(getBit(i)));
+            }
+        });
+        return new_matrix;
+    }
+
+    template <class AccessPolicy>
+    template<class action>
+    Matrix<bool, AccessPolicy>& Matrix<bool, AccessPolicy>::applyInPlace(action apply_action, Executor& executor)
+    {
+        execution::forEachChunk(executor, execution::Chunks<word_t>(words, wordCount()),
+                                [&](const int, const int first, const int last){
+            for (int i = first * kBitsPerWord; i < std::min(size(), last * kBitsPerWord); i++){
+                setBit(i, apply_action(getBit(i)));
+            }
+        });
+        return *this;
+    }
+
+    template <class AccessPolicy>
+    template<class U, class BinaryOperation>
+    U Matrix<bool, AccessPolicy>::reduce(U init, BinaryOperation operation, Executor& executor) const
+    {
+        const execution::Chunks<word_t> chunks(words, wordCount());
+        std::vector<U> partials(chunks.count(), init);
+        execution::forEachChunk(executor, chunks, [&](const int chunk, const int first, const int last){
+            U partial = init;
+            for (int i = first * kBitsPerWord; i < std::min(size(), last * kBitsPerWord); i++){
+                partial = operation(partial, getBit(i));
+            }
+            partials[chunk] = partial;
+        });
+        for (int i = 0; i < int(partials.size()); i++){
+            init = operation(init, partials[i]);
+        }
+        return init;
+    }
+
+    template <class AccessPolicy>
+    template<class Predicate>
+    int Matrix<bool, AccessPolicy>::countIf(Predicate predicate, Executor& executor) const
+    {
+        std::atomic<int> count(0);
+        execution::forEachChunk(executor, execution::Chunks<word_t>(words, wordCount()),
+                                [&](const int, const int first, const int last){
+            int chunk_count = 0;
+            for (int i = first * kBitsPerWord; i < std::min(size(), last * kBitsPerWord); i++){
+                if ((bool)predicate(getBit(i))){
+                    chunk_count++;
+                }
+            }
+            count += chunk_count;
+        });
+        return count;
+    }
+
+    template <class AccessPolicy>
+    Matrix<bool, AccessPolicy>::~Matrix()
+    {
+        delete[] words;
+    }
+
+    template <class AccessPolicy>
+    typename Matrix<bool, AccessPolicy>::iterator Matrix<bool, AccessPolicy>::begin()
+    {
+        return iterator(this, 0);
+    }
+
+    template <class AccessPolicy>
+    typename Matrix<bool, AccessPolicy>::iterator Matrix<bool, AccessPolicy>::end()
+    {
+        return iterator(this, size());
+    }
+
+    template <class AccessPolicy>
+    typename Matrix<bool, AccessPolicy>::const_iterator Matrix<bool, AccessPolicy>::begin() const
+    {
+        return const_iterator(this, 0);
+    }
+
+    template <class AccessPolicy>
+    typename Matrix<bool, AccessPolicy>::const_iterator Matrix<bool, AccessPolicy>::end() const
+    {
+        return const_iterator(this, size());
+    }
+
+    template <class AccessPolicy>
+    typename Matrix<bool, AccessPolicy>::reference Matrix<bool, AccessPolicy>::iterator::operator*()
+    {
+        return (*matrix)(index / matrix->width(), index % matrix->width());
+    }
+
+    template <class AccessPolicy>
+    bool Matrix<bool, AccessPolicy>::const_iterator::operator*() const
+    {
+        return (*matrix)(index / matrix->width(), index % matrix->width());
+    }
+}
+
+#endif //MATRIX_BOOL_H
@@ -0,0 +1,129 @@
+#include "MatrixExecution.h"
+
+namespace mtm {
+    namespace {
+        /* running_pool:  the pool whose chunk the thread is running, if any. A chunk that calls run on the same pool
+                          runs the nested job itself - the pool is busy with the job of the chunk, and waiting for it
+                          would wait for the chunk */
+        thread_local const ThreadPoolExecutor* running_pool = nullptr;
+    }
+
+    void SequentialExecutor::run(const int chunks, const std::function<void(int)>& chunk)
+    {
+        for (int i = 0; i < chunks; i++) {
+            chunk(i);
+        }
+    }
+
+    SequentialExecutor& sequentialExecutor()
+    {
+        static SequentialExecutor executor;
+        return executor;
+    }
+
+    ThreadPoolExecutor::ThreadPoolExecutor(int threads) : job(nullptr), job_chunks(0), next_chunk(0),
+                                                          busy_workers(0), generation(0), stopping(false)
+    {
+        if (threads < 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency()) - 1;
+        }
+        try {
+            for (int i = 0; i < threads; i++) {
+                workers.push_back(std::thread([this]() { workerLoop(); }));
+            }
+        } catch (...) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (std::thread& worker : workers) {
+                worker.join();
+            }
+            throw;
+        }
+    }
+
+    ThreadPoolExecutor::~ThreadPoolExecutor()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+    int ThreadPoolExecutor::threads() const
+    {
+        return int(workers.size()) + 1;
+    }
+
+    void ThreadPoolExecutor::work()
+    {
+        const ThreadPoolExecutor* const outer_pool = running_pool;
+        running_pool = this;
+        for (int i = next_chunk++; i < job_chunks; i = next_chunk++) {
+            try {
+                (*job)(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                next_chunk = job_chunks;
+            }
+        }
+        running_pool = outer_pool;
+    }
+
+    void ThreadPoolExecutor::workerLoop()
+    {
+        std::uint64_t done_generation = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [&]() { return stopping || generation != done_generation; });
+            if (stopping) {
+                return;
+            }
+            done_generation = generation;
+            lock.unlock();
+            work();
+            lock.lock();
+            if (--busy_workers == 0) {
+                finished.notify_one();
+            }
+        }
+    }
+
+    void ThreadPoolExecutor::run(const int chunks, const std::function<void(int)>& chunk)
+    {
+        if (workers.empty() || chunks <= 1 || running_pool == this) {
+            sequentialExecutor().run(chunks, chunk);
+            return;
+        }
+        std::lock_guard<std::mutex> run_lock(run_mutex);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &chunk;
+            job_chunks = chunks;
+            next_chunk = 0;
+            busy_workers = int(workers.size());
+            generation++;
+        }
+        wake.notify_all();
+        work();
+        std::exception_ptr job_error;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            finished.wait(lock, [this]() { return busy_workers == 0; });
+            job = nullptr;
+            std::swap(job_error, error);
+        }
+        if (job_error) {
+            std::rethrow_exception(job_error);
+        }
+    }
+}
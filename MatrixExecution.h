@@ -0,0 +1,142 @@
+#ifndef MATRIX_EXECUTION_H
+#define MATRIX_EXECUTION_H
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mtm {
+    /** class Executor - runs the chunks of an element-wise Matrix operation (apply, applyInPlace, reduce,
+    *   countIf, all, any). The operation decides what each chunk does, the executor decides where the chunks run.
+    * */
+    class Executor {
+        public:
+        virtual ~Executor() {}
+
+        /** run: calls chunk(i) once for each i from 0 to chunks - 1, in any order and from any thread, and returns
+        *       when all of them returned. If a chunk throws, the chunks that haven't started yet are skipped and the
+        *       (first) exception is rethrown.
+        * */
+        virtual void run(const int chunks, const std::function<void(int)>& chunk) = 0;
+    };
+
+    /** class SequentialExecutor - runs the chunks one after another in the calling thread
+    * */
+    class SequentialExecutor : public Executor {
+        public:
+        void run(const int chunks, const std::function<void(int)>& chunk) override;
+    };
+
+    /** sequentialExecutor: returns the executor the Matrix operations use by default
+    * */
+    SequentialExecutor& sequentialExecutor();
+
+    /** class ThreadPoolExecutor - runs the chunks on a fixed set of worker threads, started once by the
+    *   constructor (so an operation doesn't pay for creating threads) and the calling thread, which takes chunks too.
+    *   The chunks are taken from a shared counter, so faster threads take more of them.
+    *   Operations run from several threads on the same pool run one after another. A chunk may itself run an
+    *   operation on the same pool (e.g. a Matrix operation on the shared executor): that nested operation runs
+    *   sequentially in the thread of the chunk.
+    * */
+    class ThreadPoolExecutor : public Executor {
+        std::vector<std::thread> workers;
+        std::mutex run_mutex;
+        std::mutex mutex;
+        std::condition_variable wake, finished;
+        const std::function<void(int)>* job;
+        int job_chunks;
+        std::atomic<int> next_chunk;
+        int busy_workers;
+        std::uint64_t generation;
+        bool stopping;
+        std::exception_ptr error;
+
+        /** work: runs chunks of the current job until none is left
+        * */
+        void work();
+
+        /** workerLoop: the loop of each worker thread - waits for a job, works on it, and reports it finished
+        * */
+        void workerLoop();
+
+        public:
+        /** ThreadPoolExecutor C'tor: starts the given number of worker threads besides the calling thread
+        *                             (-1 for one less than the number of hardware threads)
+        * */
+        explicit ThreadPoolExecutor(int threads = -1);
+
+        /** ThreadPoolExecutor D'tor: stops and joins the worker threads
+        * */
+        ~ThreadPoolExecutor();
+
+        ThreadPoolExecutor(const ThreadPoolExecutor&) = delete;
+        ThreadPoolExecutor& operator=(const ThreadPoolExecutor&) = delete;
+
+        /** threads: returns the number of threads that run chunks (the workers and the calling thread)
+        * */
+        int threads() const;
+
+        void run(const int chunks, const std::function<void(int)>& chunk) override;
+    };
+
+    namespace execution {
+        /** kCacheLineBytes: the size of a cache line; chunks start at cache line boundaries of the data,
+        *   so the chunks written by different threads never share a line.
+        *   kChunkBytes: the (approximate) size of a chunk - big enough that running a chunk costs much more than
+        *   handing it to a thread, small enough that a large matrix has many more chunks than threads.
+        * */
+        const std::size_t kCacheLineBytes = 64;
+        const std::size_t kChunkBytes = 64 * 1024;
+
+        /** class Chunks - the split of the size elements at data into chunks. The first chunk ends (and every
+        *   other chunk starts) at a cache line boundary of data; data may be null for elements that are only read
+        *   (the chunks then start at multiples of the chunk size).
+        * */
+        template <class T>
+        class Chunks {
+            int size, per_chunk, offset;
+            public:
+            Chunks(const T* data, const int size) : size(size)
+            {
+                const std::size_t line = kCacheLineBytes % sizeof(T) == 0 ? kCacheLineBytes / sizeof(T) : 1;
+                per_chunk = int(std::max(line, kChunkBytes / sizeof(T) / line * line));
+                offset = int((line - (reinterpret_cast<std::uintptr_t>(data) / sizeof(T)) % line) % line);
+            }
+
+            /** count: returns the number of chunks (0 for no elements)
+            * */
+            int count() const
+            {
+                return size <= 0 ? 0 : size <= offset + per_chunk ? 1 : 1 + (size - offset - 1) / per_chunk;
+            }
+
+            /** first / last: return the first element of the given chunk and the element after its last one
+            * */
+            int first(const int chunk) const { return chunk == 0 ? 0 : offset + chunk * per_chunk; }
+            int last(const int chunk) const { return std::min(size, offset + (chunk + 1) * per_chunk); }
+        };
+
+        /** forEachChunk: calls chunk_range(chunk, first, last) for each chunk of the given chunks on the executor
+        *                 (a single chunk runs in the calling thread)
+        * */
+        template <class T, class Function>
+        void forEachChunk(Executor& executor, const Chunks<T>& chunks, Function chunk_range)
+        {
+            if (chunks.count() == 1) {
+                chunk_range(0, chunks.first(0), chunks.last(0));
+                return;
+            }
+            executor.run(chunks.count(), [&](const int chunk) {
+                chunk_range(chunk, chunks.first(chunk), chunks.last(chunk));
+            });
+        }
+    }
+}
+
+#endif //MATRIX_EXECUTION_H
@@ -0,0 +1,193 @@
+#ifndef MATRIX_EXPRESSION_H
+#define MATRIX_EXPRESSION_H
+#include <type_traits>
+
+namespace mtm {
+    template <class T, class AccessPolicy>
+    class Matrix;
+
+    /** class MatrixExpression - base class for every object that can be evaluated element by element
+    *   as a Matrix: the Matrix itself and the lazy results of the Matrix operators.
+    *   The element-wise operators build a tree of expressions instead of a new Matrix, and the whole tree is
+    *   evaluated in a single loop only when it is assigned to a Matrix (or passed to all/any/<<).
+    *   Each derived class E must provide:  value_type, height(), width(), size() and element(index),
+    *   where index is the flat (row major) index of the element.
+    *   Note: an expression keeps references to the matrices it was built from, so it must not outlive them.
+    */
+    template <class E>
+    class MatrixExpression {
+        public:
+        /** expression:   Returns the derived expression
+        * */
+        constexpr const E& expression() const {
+            return static_cast<const E&>(*this);
+        }
+    };
+
+    /** ExpressionOperand: the way an expression holds its operands -
+    *   a Matrix is held by reference, and a (small) expression is held by value.
+    * */
+    template <class E>
+    struct ExpressionOperand {
+        typedef const E type;
+    };
+
+    template <class T, class AccessPolicy>
+    struct ExpressionOperand<Matrix<T, AccessPolicy>> {
+        typedef const Matrix<T, AccessPolicy>& type;
+    };
+
+    /** MatrixBinaryExpression: The lazy result of an operation between 2 expressions of the same dimensions
+    * */
+    template <class L, class R, class Operation>
+    class MatrixBinaryExpression : public MatrixExpression<MatrixBinaryExpression<L, R, Operation>> {
+        typename ExpressionOperand<L>::type left;
+        typename ExpressionOperand<R>::type right;
+        public:
+        typedef typename Operation::value_type value_type;
+
+        constexpr MatrixBinaryExpression(const L& left, const R& right) : left(left), right(right) {}
+        constexpr int height() const { return left.height(); }
+        constexpr int width() const { return left.width(); }
+        constexpr int size() const { return left.size(); }
+        constexpr value_type element(const int index) const {
+            return Operation()(left.element(index), right.element(index));
+        }
+        constexpr const L& getLeft() const { return left; }
+        constexpr const R& getRight() const { return right; }
+    };
+
+    /** MatrixScalarExpression: The lazy result of an operation between an expression and a single object
+    * */
+    template <class E, class Operation>
+    class MatrixScalarExpression : public MatrixExpression<MatrixScalarExpression<E, Operation>> {
+        typename ExpressionOperand<E>::type operand;
+        const typename E::value_type object;
+        public:
+        typedef typename Operation::value_type value_type;
+
+        constexpr MatrixScalarExpression(const E& operand, const typename E::value_type& object) :
+                                operand(operand), object(object) {}
+        constexpr int height() const { return operand.height(); }
+        constexpr int width() const { return operand.width(); }
+        constexpr int size() const { return operand.size(); }
+        constexpr value_type element(const int index) const {
+            return Operation()(operand.element(index), object);
+        }
+        constexpr const E& getOperand() const { return operand; }
+        constexpr const typename E::value_type& getObject() const { return object; }
+    };
+
+    /** MatrixUnaryExpression: The lazy result of an operation on each element of an expression
+    * */
+    template <class E, class Operation>
+    class MatrixUnaryExpression : public MatrixExpression<MatrixUnaryExpression<E, Operation>> {
+        typename ExpressionOperand<E>::type operand;
+        public:
+        typedef typename Operation::value_type value_type;
+
+        explicit constexpr MatrixUnaryExpression(const E& operand) : operand(operand) {}
+        constexpr int height() const { return operand.height(); }
+        constexpr int width() const { return operand.width(); }
+        constexpr int size() const { return operand.size(); }
+        constexpr value_type element(const int index) const {
+            return Operation()(operand.element(index));
+        }
+    };
+
+    /** StaticDimensions: the dimensions of an expression when they are known at compile time (a FixedMatrix and
+    *   the expressions built from it). kKnown is false for a Matrix, whose dimensions are only known at run time.
+    * */
+    template <class E>
+    struct StaticDimensions {
+        static const bool kKnown = false;
+        static const int kRows = 0;
+        static const int kCols = 0;
+    };
+
+    template <class L, class R, class Operation>
+    struct StaticDimensions<MatrixBinaryExpression<L, R, Operation>> :
+        std::conditional<StaticDimensions<L>::kKnown, StaticDimensions<L>, StaticDimensions<R>>::type {};
+
+    template <class E, class Operation>
+    struct StaticDimensions<MatrixScalarExpression<E, Operation>> : StaticDimensions<E> {};
+
+    template <class E, class Operation>
+    struct StaticDimensions<MatrixUnaryExpression<E, Operation>> : StaticDimensions<E> {};
+
+    /** StaticDimensionsMayMatch: false only if the dimensions of both expressions are known and differ,
+    *   so the binary operators reject such operands at compile time (the rest are checked at run time)
+    * */
+    template <class L, class R>
+    struct StaticDimensionsMayMatch {
+        static const bool value = !StaticDimensions<L>::kKnown || !StaticDimensions<R>::kKnown ||
+                                  (StaticDimensions<L>::kRows == StaticDimensions<R>::kRows &&
+                                   StaticDimensions<L>::kCols == StaticDimensions<R>::kCols);
+    };
+
+    /** Element operations used by the Matrix operators.
+    *   The results of + and - are converted back to T (as assigning them to a Matrix<T> entry always did),
+    *   and the comparisons only use the < and == operators of T.
+    * */
+    template <class T>
+    struct MatrixPlus {
+        typedef T value_type;
+        constexpr T operator()(const T& element_a, const T& element_b) const { return element_a + element_b; }
+    };
+
+    template <class T>
+    struct MatrixPlusFromLeft {
+        typedef T value_type;
+        constexpr T operator()(const T& element, const T& object) const { return object + element; }
+    };
+
+    template <class T>
+    struct MatrixMinus {
+        typedef T value_type;
+        constexpr T operator()(const T& element_a, const T& element_b) const { return element_a - element_b; }
+    };
+
+    template <class T>
+    struct MatrixNegate {
+        typedef T value_type;
+        constexpr T operator()(const T& element) const { return -element; }
+    };
+
+    template <class T>
+    struct MatrixLess {
+        typedef bool value_type;
+        constexpr bool operator()(const T& element, const T& object) const { return element < object; }
+    };
+
+    template <class T>
+    struct MatrixLessEqual {
+        typedef bool value_type;
+        constexpr bool operator()(const T& element, const T& object) const { return element < object || element == object; }
+    };
+
+    template <class T>
+    struct MatrixGreater {
+        typedef bool value_type;
+        constexpr bool operator()(const T& element, const T& object) const { return !(element < object || element == object); }
+    };
+
+    template <class T>
+    struct MatrixGreaterEqual {
+        typedef bool value_type;
+        constexpr bool operator()(const T& element, const T& object) const { return !(element < object) || element == object; }
+    };
+
+    template <class T>
+    struct MatrixEqual {
+        typedef bool value_type;
+        constexpr bool operator()(const T& element, const T& object) const { return element == object; }
+    };
+
+    template <class T>
+    struct MatrixNotEqual {
+        typedef bool value_type;
+        constexpr bool operator()(const T& element, const T& object) const { return !(element == object); }
+    };
+}
+
+#endif //MATRIX_EXPRESSION_H
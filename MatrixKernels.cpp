@@ -0,0 +1,346 @@
+#include "MatrixKernels.h"
+#include <atomic>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define MTM_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace mtm
+{
+    namespace kernels
+    {
+#ifdef MTM_X86_KERNELS
+        /* Each vector type provides: load, store, set (all lanes to one value), add, subtract,
+           and less/equal which return one bit per lane (lane i in bit i). */
+        struct Sse2Int
+        {
+            typedef int value_t;
+            typedef __m128i vector_t;
+            static const int kLanes = 4;
+            static vector_t load(const int *p) { return _mm_loadu_si128((const __m128i *)p); }
+            static void store(int *p, vector_t v) { _mm_storeu_si128((__m128i *)p, v); }
+            static vector_t set(int x) { return _mm_set1_epi32(x); }
+            static vector_t add(vector_t a, vector_t b) { return _mm_add_epi32(a, b); }
+            static vector_t subtract(vector_t a, vector_t b) { return _mm_sub_epi32(a, b); }
+            static unsigned less(vector_t a, vector_t b) { return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(a, b))); }
+            static unsigned equal(vector_t a, vector_t b) { return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b))); }
+        };
+
+        struct Sse2Float
+        {
+            typedef float value_t;
+            typedef __m128 vector_t;
+            static const int kLanes = 4;
+            static vector_t load(const float *p) { return _mm_loadu_ps(p); }
+            static void store(float *p, vector_t v) { _mm_storeu_ps(p, v); }
+            static vector_t set(float x) { return _mm_set1_ps(x); }
+            static vector_t add(vector_t a, vector_t b) { return _mm_add_ps(a, b); }
+            static vector_t subtract(vector_t a, vector_t b) { return _mm_sub_ps(a, b); }
+            static unsigned less(vector_t a, vector_t b) { return _mm_movemask_ps(_mm_cmplt_ps(a, b)); }
+            static unsigned equal(vector_t a, vector_t b) { return _mm_movemask_ps(_mm_cmpeq_ps(a, b)); }
+        };
+
+        struct Sse2Double
+        {
+            typedef double value_t;
+            typedef __m128d vector_t;
+            static const int kLanes = 2;
+            static vector_t load(const double *p) { return _mm_loadu_pd(p); }
+            static void store(double *p, vector_t v) { _mm_storeu_pd(p, v); }
+            static vector_t set(double x) { return _mm_set1_pd(x); }
+            static vector_t add(vector_t a, vector_t b) { return _mm_add_pd(a, b); }
+            static vector_t subtract(vector_t a, vector_t b) { return _mm_sub_pd(a, b); }
+            static unsigned less(vector_t a, vector_t b) { return _mm_movemask_pd(_mm_cmplt_pd(a, b)); }
+            static unsigned equal(vector_t a, vector_t b) { return _mm_movemask_pd(_mm_cmpeq_pd(a, b)); }
+        };
+
+        /* The loops over the vectors are the same for every vector type, but the AVX2 instantiations must be
+           compiled for AVX2 and the SSE2 ones must not, so they are defined once per instruction set. */
+        namespace sse2
+        {
+            template <class V>
+            void add(const typename V::value_t *matrix_a, const typename V::value_t *matrix_b,
+                     typename V::value_t *result, const int size)
+            {
+                int i = 0;
+                for (; i + V::kLanes <= size; i += V::kLanes)
+                {
+                    V::store(result + i, V::add(V::load(matrix_a + i), V::load(matrix_b + i)));
+                }
+                kernels::add<typename V::value_t>(matrix_a + i, matrix_b + i, result + i, size - i);
+            }
+
+            template <class V>
+            void subtract(const typename V::value_t *matrix_a, const typename V::value_t *matrix_b,
+                          typename V::value_t *result, const int size)
+            {
+                int i = 0;
+                for (; i + V::kLanes <= size; i += V::kLanes)
+                {
+                    V::store(result + i, V::subtract(V::load(matrix_a + i), V::load(matrix_b + i)));
+                }
+                kernels::subtract<typename V::value_t>(matrix_a + i, matrix_b + i, result + i, size - i);
+            }
+
+            template <class V>
+            void addObject(const typename V::value_t *matrix, const typename V::value_t &object,
+                           typename V::value_t *result, const int size)
+            {
+                typename V::vector_t objects = V::set(object);
+                int i = 0;
+                for (; i + V::kLanes <= size; i += V::kLanes)
+                {
+                    V::store(result + i, V::add(V::load(matrix + i), objects));
+                }
+                kernels::addObject<typename V::value_t>(matrix + i, object, result + i, size - i);
+            }
+
+            template <class V>
+            void compare(const typename V::value_t *matrix, const typename V::value_t &object, word_t *words,
+                         const int size, const Comparison comparison)
+            {
+                typename V::vector_t objects = V::set(object);
+                int full_words = size / kBitsPerWord;
+                for (int w = 0; w < full_words; w++)
+                {
+                    const typename V::value_t *first = matrix + w * kBitsPerWord;
+                    word_t less = 0, equal = 0;
+                    for (int i = 0; i < kBitsPerWord; i += V::kLanes)
+                    {
+                        typename V::vector_t elements = V::load(first + i);
+                        less |= word_t(V::less(elements, objects)) << i;
+                        equal |= word_t(V::equal(elements, objects)) << i;
+                    }
+                    words[w] = combineComparison(comparison, less, equal);
+                }
+                int done = full_words * kBitsPerWord;
+                kernels::compare<typename V::value_t>(matrix + done, object, words + full_words, size - done, comparison);
+            }
+        }
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+        struct Avx2Int
+        {
+            typedef int value_t;
+            typedef __m256i vector_t;
+            static const int kLanes = 8;
+            static vector_t load(const int *p) { return _mm256_loadu_si256((const __m256i *)p); }
+            static void store(int *p, vector_t v) { _mm256_storeu_si256((__m256i *)p, v); }
+            static vector_t set(int x) { return _mm256_set1_epi32(x); }
+            static vector_t add(vector_t a, vector_t b) { return _mm256_add_epi32(a, b); }
+            static vector_t subtract(vector_t a, vector_t b) { return _mm256_sub_epi32(a, b); }
+            static unsigned less(vector_t a, vector_t b) { return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(b, a))); }
+            static unsigned equal(vector_t a, vector_t b) { return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b))); }
+        };
+
+        struct Avx2Float
+        {
+            typedef float value_t;
+            typedef __m256 vector_t;
+            static const int kLanes = 8;
+            static vector_t load(const float *p) { return _mm256_loadu_ps(p); }
+            static void store(float *p, vector_t v) { _mm256_storeu_ps(p, v); }
+            static vector_t set(float x) { return _mm256_set1_ps(x); }
+            static vector_t add(vector_t a, vector_t b) { return _mm256_add_ps(a, b); }
+            static vector_t subtract(vector_t a, vector_t b) { return _mm256_sub_ps(a, b); }
+            static unsigned less(vector_t a, vector_t b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LT_OQ)); }
+            static unsigned equal(vector_t a, vector_t b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)); }
+        };
+
+        struct Avx2Double
+        {
+            typedef double value_t;
+            typedef __m256d vector_t;
+            static const int kLanes = 4;
+            static vector_t load(const double *p) { return _mm256_loadu_pd(p); }
+            static void store(double *p, vector_t v) { _mm256_storeu_pd(p, v); }
+            static vector_t set(double x) { return _mm256_set1_pd(x); }
+            static vector_t add(vector_t a, vector_t b) { return _mm256_add_pd(a, b); }
+            static vector_t subtract(vector_t a, vector_t b) { return _mm256_sub_pd(a, b); }
+            static unsigned less(vector_t a, vector_t b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LT_OQ)); }
+            static unsigned equal(vector_t a, vector_t b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)); }
+        };
+
+        namespace avx2
+        {
+            template <class V>
+            void add(const typename V::value_t *matrix_a, const typename V::value_t *matrix_b,
+                     typename V::value_t *result, const int size)
+            {
+                int i = 0;
+                for (; i + V::kLanes <= size; i += V::kLanes)
+                {
+                    V::store(result + i, V::add(V::load(matrix_a + i), V::load(matrix_b + i)));
+                }
+                kernels::add<typename V::value_t>(matrix_a + i, matrix_b + i, result + i, size - i);
+            }
+
+            template <class V>
+            void subtract(const typename V::value_t *matrix_a, const typename V::value_t *matrix_b,
+                          typename V::value_t *result, const int size)
+            {
+                int i = 0;
+                for (; i + V::kLanes <= size; i += V::kLanes)
+                {
+                    V::store(result + i, V::subtract(V::load(matrix_a + i), V::load(matrix_b + i)));
+                }
+                kernels::subtract<typename V::value_t>(matrix_a + i, matrix_b + i, result + i, size - i);
+            }
+
+            template <class V>
+            void addObject(const typename V::value_t *matrix, const typename V::value_t &object,
+                           typename V::value_t *result, const int size)
+            {
+                typename V::vector_t objects = V::set(object);
+                int i = 0;
+                for (; i + V::kLanes <= size; i += V::kLanes)
+                {
+                    V::store(result + i, V::add(V::load(matrix + i), objects));
+                }
+                kernels::addObject<typename V::value_t>(matrix + i, object, result + i, size - i);
+            }
+
+            template <class V>
+            void compare(const typename V::value_t *matrix, const typename V::value_t &object, word_t *words,
+                         const int size, const Comparison comparison)
+            {
+                typename V::vector_t objects = V::set(object);
+                int full_words = size / kBitsPerWord;
+                for (int w = 0; w < full_words; w++)
+                {
+                    const typename V::value_t *first = matrix + w * kBitsPerWord;
+                    word_t less = 0, equal = 0;
+                    for (int i = 0; i < kBitsPerWord; i += V::kLanes)
+                    {
+                        typename V::vector_t elements = V::load(first + i);
+                        less |= word_t(V::less(elements, objects)) << i;
+                        equal |= word_t(V::equal(elements, objects)) << i;
+                    }
+                    words[w] = combineComparison(comparison, less, equal);
+                }
+                int done = full_words * kBitsPerWord;
+                kernels::compare<typename V::value_t>(matrix + done, object, words + full_words, size - done, comparison);
+            }
+        }
+#pragma GCC pop_options
+#endif
+
+        static Level detectLevel()
+        {
+#ifdef MTM_X86_KERNELS
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2"))
+            {
+                return AVX2;
+            }
+            return SSE2;
+#else
+            return SCALAR;
+#endif
+        }
+
+        /* The level is read by every kernel call, possibly from the threads of a parallel operation while another
+           thread calls setLevel, so it is atomic. Each call only needs some valid level, hence relaxed order. */
+        static std::atomic<Level> active_level(detectLevel());
+
+        Level supportedLevel()
+        {
+            return detectLevel();
+        }
+
+        Level activeLevel()
+        {
+            return active_level.load(std::memory_order_relaxed);
+        }
+
+        Level setLevel(Level level)
+        {
+            Level supported = supportedLevel();
+            const Level active = level > supported ? supported : level;
+            active_level.store(active, std::memory_order_relaxed);
+            return active;
+        }
+
+#ifdef MTM_X86_KERNELS
+#define MTM_DISPATCH(kernel, sse2_vector, avx2_vector, ...)             \
+    switch (active_level.load(std::memory_order_relaxed))               \
+    {                                                                   \
+    case AVX2:                                                          \
+        return avx2::kernel<avx2_vector>(__VA_ARGS__);                  \
+    case SSE2:                                                          \
+        return sse2::kernel<sse2_vector>(__VA_ARGS__);                  \
+    default:                                                            \
+        return kernel<sse2_vector::value_t>(__VA_ARGS__);               \
+    }
+#else
+#define MTM_DISPATCH(kernel, sse2_vector, avx2_vector, ...) return kernel<>(__VA_ARGS__);
+#endif
+
+        void add(const int *matrix_a, const int *matrix_b, int *result, const int size)
+        {
+            MTM_DISPATCH(add, Sse2Int, Avx2Int, matrix_a, matrix_b, result, size)
+        }
+
+        void add(const float *matrix_a, const float *matrix_b, float *result, const int size)
+        {
+            MTM_DISPATCH(add, Sse2Float, Avx2Float, matrix_a, matrix_b, result, size)
+        }
+
+        void add(const double *matrix_a, const double *matrix_b, double *result, const int size)
+        {
+            MTM_DISPATCH(add, Sse2Double, Avx2Double, matrix_a, matrix_b, result, size)
+        }
+
+        void subtract(const int *matrix_a, const int *matrix_b, int *result, const int size)
+        {
+            MTM_DISPATCH(subtract, Sse2Int, Avx2Int, matrix_a, matrix_b, result, size)
+        }
+
+        void subtract(const float *matrix_a, const float *matrix_b, float *result, const int size)
+        {
+            MTM_DISPATCH(subtract, Sse2Float, Avx2Float, matrix_a, matrix_b, result, size)
+        }
+
+        void subtract(const double *matrix_a, const double *matrix_b, double *result, const int size)
+        {
+            MTM_DISPATCH(subtract, Sse2Double, Avx2Double, matrix_a, matrix_b, result, size)
+        }
+
+        void addObject(const int *matrix, const int &object, int *result, const int size)
+        {
+            MTM_DISPATCH(addObject, Sse2Int, Avx2Int, matrix, object, result, size)
+        }
+
+        void addObject(const float *matrix, const float &object, float *result, const int size)
+        {
+            MTM_DISPATCH(addObject, Sse2Float, Avx2Float, matrix, object, result, size)
+        }
+
+        void addObject(const double *matrix, const double &object, double *result, const int size)
+        {
+            MTM_DISPATCH(addObject, Sse2Double, Avx2Double, matrix, object, result, size)
+        }
+
+        void compare(const int *matrix, const int &object, word_t *words, const int size,
+                     const Comparison comparison)
+        {
+            MTM_DISPATCH(compare, Sse2Int, Avx2Int, matrix, object, words, size, comparison)
+        }
+
+        void compare(const float *matrix, const float &object, word_t *words, const int size,
+                     const Comparison comparison)
+        {
+            MTM_DISPATCH(compare, Sse2Float, Avx2Float, matrix, object, words, size, comparison)
+        }
+
+        void compare(const double *matrix, const double &object, word_t *words, const int size,
+                     const Comparison comparison)
+        {
+            MTM_DISPATCH(compare, Sse2Double, Avx2Double, matrix, object, words, size, comparison)
+        }
+
+#undef MTM_DISPATCH
+    } // namespace kernels
+} // namespace mtm
@@ -0,0 +1,206 @@
+#ifndef MATRIX_KERNELS_H
+#define MATRIX_KERNELS_H
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include "MatrixExecution.h"
+
+namespace mtm {
+    /** kernels - element-wise loops over the flat data of matrices, used by Matrix when it evaluates
+    *   the common expressions (matrix+matrix, matrix-matrix, matrix+object and matrix compared to object).
+    *   The templates below are the plain (scalar) loops and work for any T.
+    *   For int, float and double there are overloads (MatrixKernels.cpp) that use SSE2 or AVX2
+    *   according to what the running CPU supports, and give bit-identical results to the scalar loops.
+    * */
+    namespace kernels {
+        typedef std::uint64_t word_t;
+        const int kBitsPerWord = 64;
+
+        /** Level: the instruction sets a kernel can be run with
+        * */
+        enum Level { SCALAR, SSE2, AVX2 };
+
+        /** supportedLevel: returns the best level the running CPU supports
+        * */
+        Level supportedLevel();
+
+        /** activeLevel: returns the level currently used by the int/float/double kernels
+        * */
+        Level activeLevel();
+
+        /** setLevel: changes the level used by the int/float/double kernels (limited to the supported level)
+        *             and returns the level that was actually set
+        * */
+        Level setLevel(Level level);
+
+        /** Comparison: the comparison between each element and an object,
+        *   defined (as in the Matrix operators) only by the < and == operators of T.
+        * */
+        enum Comparison { LESS, LESS_EQUAL, GREATER, GREATER_EQUAL, EQUAL, NOT_EQUAL };
+
+        /** combineComparison: returns the bits of the comparison given the bits of < and == of each element
+        * */
+        inline word_t combineComparison(const Comparison comparison, const word_t less, const word_t equal)
+        {
+            switch (comparison) {
+            case LESS:
+                return less;
+            case LESS_EQUAL:
+                return less | equal;
+            case GREATER:
+                return ~(less | equal);
+            case GREATER_EQUAL:
+                return ~less | equal;
+            case EQUAL:
+                return equal;
+            default:
+                return ~equal;
+            }
+        }
+
+        /** add: result[i] = matrix_a[i] + matrix_b[i]
+        * */
+        template <class T>
+        void add(const T* matrix_a, const T* matrix_b, T* result, const int size)
+        {
+            for (int i = 0; i < size; i++) {
+                result[i] = matrix_a[i] + matrix_b[i];
+            }
+        }
+
+        /** subtract: result[i] = matrix_a[i] - matrix_b[i]
+        * */
+        template <class T>
+        void subtract(const T* matrix_a, const T* matrix_b, T* result, const int size)
+        {
+            for (int i = 0; i < size; i++) {
+                result[i] = matrix_a[i] - matrix_b[i];
+            }
+        }
+
+        /** addObject: result[i] = matrix[i] + object
+        * */
+        template <class T>
+        void addObject(const T* matrix, const T& object, T* result, const int size)
+        {
+            for (int i = 0; i < size; i++) {
+                result[i] = matrix[i] + object;
+            }
+        }
+
+        /** compare: sets bit i of words to the result of comparing matrix[i] to object.
+        *            The bits past size in the last word are set to 0.
+        * */
+        template <class T>
+        void compare(const T* matrix, const T& object, word_t* words, const int size, const Comparison comparison)
+        {
+            for (int first = 0; first < size; first += kBitsPerWord) {
+                int count = size - first < kBitsPerWord ? size - first : kBitsPerWord;
+                word_t less = 0, equal = 0;
+                for (int i = 0; i < count; i++) {
+                    less |= word_t(matrix[first + i] < object ? 1 : 0) << i;
+                    equal |= word_t(matrix[first + i] == object ? 1 : 0) << i;
+                }
+                word_t valid = count == kBitsPerWord ? ~word_t(0) : (word_t(1) << count) - 1;
+                words[first / kBitsPerWord] = combineComparison(comparison, less, equal) & valid;
+            }
+        }
+
+        /** kTransposeBlock: the side of the square tiles the transpose kernels work on - a tile of the source
+        *   and a tile of the result fit in the L1 cache together, so every cache line is read and written once
+        *   instead of a cache miss for every element of the result.
+        *   kParallelTransposeSize: the number of elements from which the transpose kernels run the rows of tiles
+        *   on the given executor (only for types whose copy can't throw) - below it a chunk is too small to pay for
+        *   handing it to another thread.
+        * */
+        const int kTransposeBlock = 32;
+        const int kParallelTransposeSize = 1 << 20;
+
+        /** forEachBlockRow: calls block_row(i) for each row of tiles i (0 to block_rows - 1): each row is a chunk
+        *                    of the executor when parallel is true, and they run in order in the calling thread
+        *                    otherwise. The executor hands the rows out one at a time, so rows of different costs
+        *                    (the shrinking rows of transposeSquare) are spread evenly.
+        * */
+        template <class Function>
+        void forEachBlockRow(const int block_rows, const bool parallel, Executor& executor, Function block_row)
+        {
+            if (parallel && block_rows > 1) {
+                executor.run(block_rows, std::function<void(int)>(block_row));
+                return;
+            }
+            for (int i = 0; i < block_rows; i++) {
+                block_row(i);
+            }
+        }
+
+        /** transpose: result[j * rows + i] = matrix[i * cols + j], for a matrix of rows x cols,
+        *              a tile of kTransposeBlock x kTransposeBlock at a time
+        * */
+        template <class T>
+        void transpose(const T* matrix, T* result, const int rows, const int cols,
+                       Executor& executor = sequentialExecutor())
+        {
+            const bool parallel = std::is_trivially_copyable<T>::value && rows * cols >= kParallelTransposeSize;
+            const int block_rows = (rows + kTransposeBlock - 1) / kTransposeBlock;
+            forEachBlockRow(block_rows, parallel, executor, [=](const int block_row) {
+                const int first_row = block_row * kTransposeBlock;
+                const int last_row = std::min(rows, first_row + kTransposeBlock);
+                for (int first_col = 0; first_col < cols; first_col += kTransposeBlock) {
+                    const int last_col = std::min(cols, first_col + kTransposeBlock);
+                    for (int i = first_row; i < last_row; i++) {
+                        for (int j = first_col; j < last_col; j++) {
+                            result[j * rows + i] = matrix[i * cols + j];
+                        }
+                    }
+                }
+            });
+        }
+
+        /** transposeSquare: transposes the dimension x dimension matrix in place, by swapping each tile above
+        *                    the diagonal with the matching tile below it (the tiles on the diagonal are transposed
+        *                    within themselves)
+        * */
+        template <class T>
+        void transposeSquare(T* matrix, const int dimension, Executor& executor = sequentialExecutor())
+        {
+            const bool parallel = std::is_trivially_copyable<T>::value &&
+                                  dimension * dimension >= kParallelTransposeSize;
+            const int block_rows = (dimension + kTransposeBlock - 1) / kTransposeBlock;
+            forEachBlockRow(block_rows, parallel, executor, [=](const int block_row) {
+                using std::swap;
+                const int first_row = block_row * kTransposeBlock;
+                const int last_row = std::min(dimension, first_row + kTransposeBlock);
+                for (int first_col = first_row; first_col < dimension; first_col += kTransposeBlock) {
+                    const int last_col = std::min(dimension, first_col + kTransposeBlock);
+                    for (int i = first_row; i < last_row; i++) {
+                        for (int j = std::max(first_col, i + 1); j < last_col; j++) {
+                            swap(matrix[i * dimension + j], matrix[j * dimension + i]);
+                        }
+                    }
+                }
+            });
+        }
+
+        void add(const int* matrix_a, const int* matrix_b, int* result, const int size);
+        void add(const float* matrix_a, const float* matrix_b, float* result, const int size);
+        void add(const double* matrix_a, const double* matrix_b, double* result, const int size);
+
+        void subtract(const int* matrix_a, const int* matrix_b, int* result, const int size);
+        void subtract(const float* matrix_a, const float* matrix_b, float* result, const int size);
+        void subtract(const double* matrix_a, const double* matrix_b, double* result, const int size);
+
+        void addObject(const int* matrix, const int& object, int* result, const int size);
+        void addObject(const float* matrix, const float& object, float* result, const int size);
+        void addObject(const double* matrix, const double& object, double* result, const int size);
+
+        void compare(const int* matrix, const int& object, word_t* words, const int size,
+                     const Comparison comparison);
+        void compare(const float* matrix, const float& object, word_t* words, const int size,
+                     const Comparison comparison);
+        void compare(const double* matrix, const double& object, word_t* words, const int size,
+                     const Comparison comparison);
+    }
+}
+
+#endif //MATRIX_KERNELS_H
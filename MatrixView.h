@@ -0,0 +1,215 @@
+#ifndef MATRIX_VIEW_H
+#define MATRIX_VIEW_H
+#include "Matrix.h"
+#include <type_traits>
+
+namespace mtm {
+    /** class MatrixView - a rectangular part of a Matrix (a row, a column or a block) that refers to the entries of
+    *   the Matrix instead of copying them. Element (i, j) of the view is origin[i * row_stride + j * col_stride].
+    *   A view is an expression (see MatrixExpression.h), so it can be an operand of the element-wise operators,
+    *   all and any, and be assigned to or used to create a Matrix. A MatrixView<T> can also change the entries it
+    *   refers to; a MatrixView<const T> (of a const Matrix) can only read them.
+    *   Note: a view must not outlive its Matrix, and is invalidated by assigning to the Matrix.
+    *   Views are created by Matrix::row, col and block, and by the same members of a view.
+    * */
+    template <class T>
+    class MatrixView : public MatrixExpression<MatrixView<T>> {
+        public:
+        typedef typename std::remove_const<T>::type value_type;
+
+        private:
+        typedef typename MatrixExceptions<value_type>::AccessIllegalElement AccessIllegalElement;
+        typedef typename MatrixExceptions<value_type>::DimensionMismatch DimensionMismatch;
+
+        /** origin: the first element of the view
+        *   rows / cols: the dimensions of the view
+        *   row_stride / col_stride: the distance (in elements) between neighbouring rows / columns of the view
+        * */
+        T* origin;
+        int rows, cols;
+        int row_stride, col_stride;
+
+        /** verifyIndex:   Checks if the index is inside the view.
+        * */
+        void verifyIndex(const int row, const int col) const
+        {
+            if (row < 0 || col < 0 || row >= rows || col >= cols){
+                throw AccessIllegalElement();
+            }
+        }
+
+        template <class Element>
+        class Iterator;
+
+        public:
+        typedef Iterator<T> iterator;
+        typedef Iterator<const value_type> const_iterator;
+
+        /** MatrixView C'tor:   Creates a view of height x width elements, starting at origin, with the given strides.
+        *                       (Matrix::row, col and block create views of the Matrix.)
+        * */
+        MatrixView(T* origin, const int height, const int width, const int row_stride, const int col_stride) :
+                   origin(origin), rows(height), cols(width), row_stride(row_stride), col_stride(col_stride) {}
+
+        /** =(MatrixView) operator:   Copies the elements of the given view into the elements of this view
+        *                             (not the view itself: views of the same dimensions are assigned element-wise).
+        *                             Throws DimensionMismatch if the dimensions differ.
+        * */
+        MatrixView& operator=(const MatrixView& view)
+        {
+            return *this = static_cast<const MatrixExpression<MatrixView>&>(view);
+        }
+
+        MatrixView(const MatrixView& view) = default;
+
+        /** =(MatrixExpression) operator:   Sets the elements of the view to the result of the given expression
+        *                                   (which may refer to the viewed Matrix - it is evaluated before
+        *                                   any element is changed). Throws DimensionMismatch if the dimensions differ.
+        * */
+        template <class E>
+        MatrixView& operator=(const MatrixExpression<E>& expression)
+        {
+            const E& source = expression.expression();
+            if (source.height() != rows || source.width() != cols){
+                throw DimensionMismatch(Dimensions(rows, cols), Dimensions(source.height(), source.width()));
+            }
+            const Matrix<value_type> values(source);
+            for (int i = 0; i < rows; i++){
+                for (int j = 0; j < cols; j++){
+                    atUnchecked(i, j) = values.atUnchecked(i, j);
+                }
+            }
+            return *this;
+        }
+
+        /** fill:   Sets all the elements of the view to value
+        * */
+        void fill(const value_type& value)
+        {
+            for (int i = 0; i < rows; i++){
+                for (int j = 0; j < cols; j++){
+                    atUnchecked(i, j) = value;
+                }
+            }
+        }
+
+        /** height / width / size:     Returns the number of rows / columns / elements of the view
+        * */
+        int height() const { return rows; }
+        int width() const { return cols; }
+        int size() const { return rows * cols; }
+
+        /** () operator: returns a reference to the element of the view in the given row and column,
+        *                throws AccessIllegalElement if it isn't inside the view
+        * */
+        T& operator()(const int row, const int col) const
+        {
+            verifyIndex(row, col);
+            return atUnchecked(row, col);
+        }
+
+        /** atUnchecked: returns a reference to the element in the given row and column without checking it
+        * */
+        T& atUnchecked(const int row, const int col) const
+        {
+            return origin[row * row_stride + col * col_stride];
+        }
+
+        /** element: returns the element in the given flat (row major) index of the view
+        * */
+        const value_type& element(const int index) const
+        {
+            return atUnchecked(index / cols, index % cols);
+        }
+
+        /** row / col / block: return a view of a row, a column, or height x width elements starting at (row, col)
+        *                      of the view, throw AccessIllegalElement if it isn't inside the view
+        * */
+        MatrixView row(const int row) const
+        {
+            return block(row, 0, 1, cols);
+        }
+
+        MatrixView col(const int col) const
+        {
+            return block(0, col, rows, 1);
+        }
+
+        MatrixView block(const int row, const int col, const int height, const int width) const
+        {
+            if (height <= 0 || width <= 0){
+                throw AccessIllegalElement();
+            }
+            verifyIndex(row, col);
+            verifyIndex(row + height - 1, col + width - 1);
+            return MatrixView(&atUnchecked(row, col), height, width, row_stride, col_stride);
+        }
+
+        /** begin / end: iterators over the elements of the view in row major order
+        * */
+        iterator begin() const { return iterator(*this, 0); }
+        iterator end() const { return iterator(*this, size()); }
+        const_iterator cbegin() const { return const_iterator(*this, 0); }
+        const_iterator cend() const { return const_iterator(*this, size()); }
+    };
+
+    /** MatrixView iterator: iterates over the elements of a view in row major order
+    *   (it holds the layout of the view, so it stays valid after the view it came from is gone)
+    * */
+    template <class T>
+    template <class Element>
+    class MatrixView<T>::Iterator {
+        T* origin;
+        int cols, row_stride, col_stride;
+        int index;
+        Iterator(const MatrixView<T>& view, const int index) : origin(view.origin), cols(view.cols),
+                 row_stride(view.row_stride), col_stride(view.col_stride), index(index) {}
+        friend class MatrixView<T>;
+        public:
+        Element& operator*() const { return origin[(index / cols) * row_stride + (index % cols) * col_stride]; }
+        Element* operator->() const { return &**this; }
+        Iterator& operator++() { ++index; return *this; }
+        Iterator operator++(int) { Iterator result = *this; ++index; return result; }
+        bool operator==(const Iterator& other) const { return origin == other.origin && index == other.index; }
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+    };
+
+    template <class T, class AccessPolicy>
+    MatrixView<T> Matrix<T, AccessPolicy>::row(const int row)
+    {
+        return block(row, 0, 1, width());
+    }
+
+    template <class T, class AccessPolicy>
+    MatrixView<const T> Matrix<T, AccessPolicy>::row(const int row) const
+    {
+        return block(row, 0, 1, width());
+    }
+
+    template <class T, class AccessPolicy>
+    MatrixView<T> Matrix<T, AccessPolicy>::col(const int col)
+    {
+        return block(0, col, height(), 1);
+    }
+
+    template <class T, class AccessPolicy>
+    MatrixView<const T> Matrix<T, AccessPolicy>::col(const int col) const
+    {
+        return block(0, col, height(), 1);
+    }
+
+    template <class T, class AccessPolicy>
+    MatrixView<T> Matrix<T, AccessPolicy>::block(const int row, const int col, const int height, const int width)
+    {
+        return MatrixView<T>(elements, this->height(), this->width(), this->width(), 1).block(row, col, height, width);
+    }
+
+    template <class T, class AccessPolicy>
+    MatrixView<const T> Matrix<T, AccessPolicy>::block(const int row, const int col, const int height,
+                                                       const int width) const
+    {
+        return MatrixView<const T>(elements, this->height(), this->width(), this->width(), 1).block(row, col, height, width);
+    }
+}
+
+#endif //MATRIX_VIEW_H
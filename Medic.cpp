@@ -1,5 +1,7 @@
 #include "Medic.h"
 #include <iostream>
+#include <algorithm>
+#include <vector>
 
 
 namespace mtm {
@@ -13,33 +15,59 @@ namespace mtm {
         return new Medic(*this);
     }
 
+    std::shared_ptr<Character> Medic::cloneShared() const
+    {
+        return std::allocate_shared<Medic>(PoolAllocator<Medic>(), *this);
+    }
+
+    CharacterType Medic::getType() const
+    {
+        return MEDIC;
+    }
+
 
-    void Medic::attack(GridPoint attacker_point, GridPoint victim_point,Matrix<std::shared_ptr<Character>>& board)  
+    ActionStatus Medic::checkAttack(const GridPoint& attacker_point, const GridPoint& victim_point,
+                                    const Board& board) const
     {
         //check range
         if(GridPoint::distance(attacker_point,victim_point)>range)
         {
-            throw mtm::OutOfRange();
+            return OUT_OF_RANGE;
         }
         //check ammo
-        std::shared_ptr<Character> victim=board(victim_point.row,victim_point.col);
+        const std::shared_ptr<Character>& victim=board.atUnchecked(victim_point.row,victim_point.col);
         if(victim && !isSameTeam(*this,*victim) && (ammo == 0)) {
-            throw mtm::OutOfAmmo();
+            return OUT_OF_AMMO;
         }
         if ((attacker_point == victim_point)||(victim == nullptr))
         {
-            throw mtm::IllegalTarget();
+            return ILLEGAL_TARGET;
         }
+        return SUCCESS;
+    }
+
+    void Medic::legalTargets(const GridPoint& attacker_point, const Board&,
+                             const Occupancy& occupancy, std::vector<GridPoint>& targets) const
+    {
+        //the teammates within range are healed (except the medic itself), the enemies are attacked only with ammo
+        const std::vector<GridPoint>::size_type first = targets.size();
+        occupancy.appendUnitsInRadius(team, attacker_point, range, targets);
+        targets.erase(std::remove(targets.begin() + first, targets.end(), attacker_point), targets.end());
+        if(ammo > 0) {
+            occupancy.appendUnitsInRadius(team == CPP ? PYTHON : CPP, attacker_point, range, targets);
+        }
+    }
+
+    void Medic::performAttack(const GridPoint&, const GridPoint& victim_point,
+                              Board& board, BoardObserver& observer)
+    {
+        const std::shared_ptr<Character>& victim=board.atUnchecked(victim_point.row,victim_point.col);
         units_t delta=-power;
         if(!isSameTeam(*this,*victim))
         {
             ammo--;
             delta=-delta;
         }
-        victim->changeHealth(delta);
-        if(victim->isDead())
-        {
-            board(victim_point.row,victim_point.col)=nullptr;
-        }
+        damage(victim_point, delta, board, observer);
     }
 }
\ No newline at end of file
@@ -12,7 +12,14 @@ namespace mtm {
         public: 
         Medic(const Team team, const units_t health ,const units_t ammo, const units_t range, const units_t power);
         virtual Character* clone() const override;
-        void attack(GridPoint attacker_point, GridPoint victim_point,Matrix<std::shared_ptr<Character>>& board)  override;
+        std::shared_ptr<Character> cloneShared() const override;
+        CharacterType getType() const override;
+        ActionStatus checkAttack(const GridPoint& attacker_point, const GridPoint& victim_point,
+                                 const Board& board) const override;
+        void performAttack(const GridPoint& attacker_point, const GridPoint& victim_point,
+                           Board& board, BoardObserver& observer) override;
+        void legalTargets(const GridPoint& attacker_point, const Board& board,
+                          const Occupancy& occupancy, std::vector<GridPoint>& targets) const override;
     };
 }
 
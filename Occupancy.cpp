@@ -0,0 +1,265 @@
+#include "Occupancy.h"
+#include "Exceptions.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+
+namespace mtm
+{
+    namespace
+    {
+        typedef std::uint64_t word_t;
+
+        int popCount(word_t bits)
+        {
+#ifdef __GNUC__
+            return __builtin_popcountll(bits);
+#else
+            int count = 0;
+            for (; bits != 0; bits &= bits - 1)
+            {
+                count++;
+            }
+            return count;
+#endif
+        }
+
+        int lowestBit(word_t bits)
+        {
+#ifdef __GNUC__
+            return __builtin_ctzll(bits);
+#else
+            int index = 0;
+            for (; (bits & 1) == 0; bits >>= 1)
+            {
+                index++;
+            }
+            return index;
+#endif
+        }
+
+        // the bits of the given word of a line that are first to last (inclusive) of the line
+        word_t maskedWord(word_t bits, int word, int first, int last)
+        {
+            const int bits_per_word = 64;
+            if (word == first / bits_per_word)
+            {
+                bits &= ~word_t(0) << (first % bits_per_word);
+            }
+            if (word == last / bits_per_word)
+            {
+                bits &= ~word_t(0) >> (bits_per_word - 1 - last % bits_per_word);
+            }
+            return bits;
+        }
+    }
+
+    Occupancy::Bitboard::Bitboard(int lines, int line_words) : line_words(line_words),
+                                                               lines_per_chunk(std::max(1, kWordsPerChunk / line_words))
+    {
+        chunks.reserve((lines + lines_per_chunk - 1) / lines_per_chunk);
+        for (int first_line = 0; first_line < lines; first_line += lines_per_chunk)
+        {
+            const int chunk_lines = std::min(lines_per_chunk, lines - first_line);
+            chunks.push_back(std::make_shared<std::vector<word_t>>(std::size_t(chunk_lines) * line_words, 0));
+        }
+    }
+
+    Occupancy::word_t *Occupancy::Bitboard::writableLine(int index)
+    {
+        std::shared_ptr<std::vector<word_t>> &chunk = chunks[index / lines_per_chunk];
+        if (chunk.use_count() != 1)
+        {
+            chunk = std::make_shared<std::vector<word_t>>(*chunk);
+        }
+        return chunk->data() + (index % lines_per_chunk) * line_words;
+    }
+
+    Occupancy::Occupancy(int height, int width) : height(height), width(width),
+                                                  row_words((width + kBitsPerWord - 1) / kBitsPerWord),
+                                                  col_words((height + kBitsPerWord - 1) / kBitsPerWord),
+                                                  rows{Bitboard(height, row_words), Bitboard(height, row_words)},
+                                                  columns{Bitboard(width, col_words), Bitboard(width, col_words)}
+    {
+    }
+
+    void Occupancy::set(const GridPoint &point, Team team)
+    {
+        assert(!isOccupied(point));
+        rows[team].writableLine(point.row)[point.col / kBitsPerWord] |= word_t(1) << (point.col % kBitsPerWord);
+        columns[team].writableLine(point.col)[point.row / kBitsPerWord] |= word_t(1) << (point.row % kBitsPerWord);
+    }
+
+    void Occupancy::reset(const GridPoint &point, Team team)
+    {
+        assert(isOccupied(point, team));
+        rows[team].writableLine(point.row)[point.col / kBitsPerWord] &= ~(word_t(1) << (point.col % kBitsPerWord));
+        columns[team].writableLine(point.col)[point.row / kBitsPerWord] &= ~(word_t(1) << (point.row % kBitsPerWord));
+    }
+
+    bool Occupancy::isOccupied(const GridPoint &point) const
+    {
+        return isOccupied(point, CPP) || isOccupied(point, PYTHON);
+    }
+
+    bool Occupancy::isOccupied(const GridPoint &point, Team team) const
+    {
+        return (rows[team].line(point.row)[point.col / kBitsPerWord] >> (point.col % kBitsPerWord)) & 1;
+    }
+
+    int Occupancy::countBits(const word_t *line, int first, int last)
+    {
+        int count = 0;
+        for (int word = first / kBitsPerWord; word <= last / kBitsPerWord; word++)
+        {
+            count += popCount(maskedWord(line[word], word, first, last));
+        }
+        return count;
+    }
+
+    Occupancy::word_t Occupancy::emptyBits(const word_t *cpp_line, const word_t *python_line, int word, int length)
+    {
+        word_t bits = ~(cpp_line[word] | python_line[word]);
+        if (word == (length - 1) / kBitsPerWord && length % kBitsPerWord != 0)
+        {
+            bits &= (word_t(1) << (length % kBitsPerWord)) - 1;
+        }
+        return bits;
+    }
+
+    int Occupancy::countInRadius(Team team, const GridPoint &center, int radius) const
+    {
+        int count = 0;
+        // a radius past the size of the board covers the same cells (and can't overflow the coordinates)
+        radius = std::min(radius, height + width);
+        const int first_row = std::max(0, center.row - radius);
+        const int last_row = std::min(height - 1, center.row + radius);
+        for (int i = first_row; i <= last_row; i++)
+        {
+            const int row_radius = radius - std::abs(i - center.row);
+            const int first_col = std::max(0, center.col - row_radius);
+            const int last_col = std::min(width - 1, center.col + row_radius);
+            if (first_col <= last_col)
+            {
+                count += countBits(rows[team].line(i), first_col, last_col);
+            }
+        }
+        return count;
+    }
+
+    template <class LineWord>
+    void Occupancy::appendInRadius(const GridPoint &center, int radius, LineWord line_word,
+                                   std::vector<GridPoint> &cells) const
+    {
+        radius = std::min(radius, height + width);
+        const int first_row = std::max(0, center.row - radius);
+        const int last_row = std::min(height - 1, center.row + radius);
+        for (int i = first_row; i <= last_row; i++)
+        {
+            const int row_radius = radius - std::abs(i - center.row);
+            const int first_col = std::max(0, center.col - row_radius);
+            const int last_col = std::min(width - 1, center.col + row_radius);
+            for (int word = first_col / kBitsPerWord; first_col <= last_col && word <= last_col / kBitsPerWord; word++)
+            {
+                for (word_t bits = maskedWord(line_word(i, word), word, first_col, last_col); bits != 0; bits &= bits - 1)
+                {
+                    cells.push_back(GridPoint(i, word * kBitsPerWord + lowestBit(bits)));
+                }
+            }
+        }
+    }
+
+    std::vector<GridPoint> Occupancy::unitsInRadius(Team team, const GridPoint &center, int radius) const
+    {
+        std::vector<GridPoint> units;
+        appendUnitsInRadius(team, center, radius, units);
+        return units;
+    }
+
+    void Occupancy::appendUnitsInRadius(Team team, const GridPoint &center, int radius,
+                                        std::vector<GridPoint> &cells) const
+    {
+        const Bitboard &bitboard = rows[team];
+        appendInRadius(center, radius, [&bitboard](int row, int word) {
+            return bitboard.line(row)[word];
+        }, cells);
+    }
+
+    void Occupancy::appendEmptyInRadius(const GridPoint &center, int radius, std::vector<GridPoint> &cells) const
+    {
+        const Bitboard &cpp_bitboard = rows[CPP], &python_bitboard = rows[PYTHON];
+        appendInRadius(center, radius, [&cpp_bitboard, &python_bitboard](int row, int word) {
+            return ~(cpp_bitboard.line(row)[word] | python_bitboard.line(row)[word]);
+        }, cells);
+    }
+
+    void Occupancy::appendUnits(Team team, std::vector<GridPoint> &cells) const
+    {
+        for (int i = 0; i < height; i++)
+        {
+            const word_t *line = rows[team].line(i);
+            for (int word = 0; word < row_words; word++)
+            {
+                for (word_t bits = line[word]; bits != 0; bits &= bits - 1)
+                {
+                    cells.push_back(GridPoint(i, word * kBitsPerWord + lowestBit(bits)));
+                }
+            }
+        }
+    }
+
+    int Occupancy::countEmptyInRow(int row) const
+    {
+        if (row < 0 || row >= height)
+        {
+            throw mtm::IllegalCell();
+        }
+        return width - countBits(rows[CPP].line(row), 0, width - 1) - countBits(rows[PYTHON].line(row), 0, width - 1);
+    }
+
+    int Occupancy::countEmptyInColumn(int col) const
+    {
+        if (col < 0 || col >= width)
+        {
+            throw mtm::IllegalCell();
+        }
+        return height - countBits(columns[CPP].line(col), 0, height - 1) -
+               countBits(columns[PYTHON].line(col), 0, height - 1);
+    }
+
+    std::vector<GridPoint> Occupancy::emptyCellsInRow(int row) const
+    {
+        if (row < 0 || row >= height)
+        {
+            throw mtm::IllegalCell();
+        }
+        std::vector<GridPoint> cells;
+        const word_t *cpp_line = rows[CPP].line(row), *python_line = rows[PYTHON].line(row);
+        for (int word = 0; word < row_words; word++)
+        {
+            for (word_t bits = emptyBits(cpp_line, python_line, word, width); bits != 0; bits &= bits - 1)
+            {
+                cells.push_back(GridPoint(row, word * kBitsPerWord + lowestBit(bits)));
+            }
+        }
+        return cells;
+    }
+
+    std::vector<GridPoint> Occupancy::emptyCellsInColumn(int col) const
+    {
+        if (col < 0 || col >= width)
+        {
+            throw mtm::IllegalCell();
+        }
+        std::vector<GridPoint> cells;
+        const word_t *cpp_line = columns[CPP].line(col), *python_line = columns[PYTHON].line(col);
+        for (int word = 0; word < col_words; word++)
+        {
+            for (word_t bits = emptyBits(cpp_line, python_line, word, height); bits != 0; bits &= bits - 1)
+            {
+                cells.push_back(GridPoint(word * kBitsPerWord + lowestBit(bits), col));
+            }
+        }
+        return cells;
+    }
+} // namespace mtm
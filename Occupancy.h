@@ -0,0 +1,102 @@
+#ifndef OCCUPANCY_H
+#define OCCUPANCY_H
+#include "Auxiliaries.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace mtm {
+    /* class Occupancy: The cells occupied by each team, as bitboards (a bit per cell), kept by Game next to its
+                        board and updated by every action. Each team has a row major bitboard (every row starts a
+                        new word) and a column major one, so a query over a segment of a row or of a column
+                        reads 64 cells at a time instead of testing each cell of the board.
+                        A copy shares the words of the bitboards with the original until one of them changes a cell
+                        (see Bitboard), so the first change after a copy copies only the words it touches.
+    */
+    class Occupancy {
+        typedef std::uint64_t word_t;
+        static const int kBitsPerWord = 64;
+
+        /* class Bitboard: the lines (rows or columns) of a bitboard, kept in chunks of whole lines (about
+                           kWordsPerChunk words each), each behind its own shared pointer. A copy shares the chunks,
+                           and writableLine copies the chunk of a line first if it is shared (copy on write) */
+        class Bitboard {
+            static const int kWordsPerChunk = 64;
+
+            int line_words, lines_per_chunk;
+            std::vector<std::shared_ptr<std::vector<word_t>>> chunks;
+
+            public:
+            /* C'tor:  Creates a bitboard of the given number of lines of line_words words, with all bits 0  */
+            Bitboard(int lines, int line_words);
+
+            /* line:  returns the words of the given line, for reading  */
+            const word_t* line(int index) const
+            {
+                return chunks[index / lines_per_chunk]->data() + (index % lines_per_chunk) * line_words;
+            }
+
+            /* writableLine:  returns the words of the given line for a change, after copying its chunk if it is
+                              shared with a copy of the bitboard  */
+            word_t* writableLine(int index);
+        };
+
+        int height, width;
+        int row_words, col_words;
+        Bitboard rows[2];
+        Bitboard columns[2];
+
+        /* countBits:  returns the number of set bits first to last (inclusive) of the given line  */
+        static int countBits(const word_t* line, int first, int last);
+
+        /* emptyBits:  returns the word of the given line index of the cells no team occupies
+                       (bits past the end of the line are 0)  */
+        static word_t emptyBits(const word_t* cpp_line, const word_t* python_line, int word, int length);
+
+        /* appendInRadius:  appends to cells the cells within the given Manhattan distance of center whose bits
+                            are set in the words of the row major bitboard line_word(row, word) returns  */
+        template <class LineWord>
+        void appendInRadius(const GridPoint& center, int radius, LineWord line_word, std::vector<GridPoint>& cells) const;
+
+        public:
+        /* C'tor:  Creates the occupancy of an empty board of the given size  */
+        Occupancy(int height, int width);
+
+        /* set, reset:  mark the given cell as occupied / not occupied by the given team  */
+        void set(const GridPoint& point, Team team);
+        void reset(const GridPoint& point, Team team);
+
+        /* isOccupied:  returns if the given (legal) cell is occupied, by any team or by the given team  */
+        bool isOccupied(const GridPoint& point) const;
+        bool isOccupied(const GridPoint& point, Team team) const;
+
+        /* countInRadius:  returns the number of cells of the given team within the given Manhattan distance
+                           of center (the part of the diamond outside the board is ignored)  */
+        int countInRadius(Team team, const GridPoint& center, int radius) const;
+
+        /* unitsInRadius:  returns the cells of the given team within the given Manhattan distance of center,
+                           in row major order  */
+        std::vector<GridPoint> unitsInRadius(Team team, const GridPoint& center, int radius) const;
+
+        /* appendUnitsInRadius, appendEmptyInRadius:  append to cells the cells of the given team / the empty cells
+                                                      within the given Manhattan distance of center, in row major order
+                                                      (so a caller can reuse the same vector for many queries)  */
+        void appendUnitsInRadius(Team team, const GridPoint& center, int radius, std::vector<GridPoint>& cells) const;
+        void appendEmptyInRadius(const GridPoint& center, int radius, std::vector<GridPoint>& cells) const;
+
+        /* appendUnits:  appends to cells all the cells of the given team, in row major order  */
+        void appendUnits(Team team, std::vector<GridPoint>& cells) const;
+
+        /* countEmptyInRow, countEmptyInColumn:  return the number of empty cells in the given row / column,
+                                                 throw IllegalCell if it isn't in the board  */
+        int countEmptyInRow(int row) const;
+        int countEmptyInColumn(int col) const;
+
+        /* emptyCellsInRow, emptyCellsInColumn:  return the empty cells of the given row / column in order,
+                                                 throw IllegalCell if it isn't in the board  */
+        std::vector<GridPoint> emptyCellsInRow(int row) const;
+        std::vector<GridPoint> emptyCellsInColumn(int col) const;
+    };
+}
+
+#endif
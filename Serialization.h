@@ -0,0 +1,36 @@
+#ifndef SERIALIZATION_H
+#define SERIALIZATION_H
+#include <cstdint>
+
+namespace mtm {
+    /* serialization - the encoding of the numbers of the binary formats (game snapshots and action logs):
+       32 bit little endian integers, independent of the byte order of the machine
+    */
+    namespace serialization {
+        /* putInt:  writes value to the 4 bytes at bytes */
+        inline void putInt(char* bytes, std::uint32_t value)
+        {
+            bytes[0] = char(value & 0xff);
+            bytes[1] = char((value >> 8) & 0xff);
+            bytes[2] = char((value >> 16) & 0xff);
+            bytes[3] = char((value >> 24) & 0xff);
+        }
+
+        /* getInt:  returns the unsigned value of the 4 bytes at bytes */
+        inline std::uint32_t getInt(const char* bytes)
+        {
+            const unsigned char* data = reinterpret_cast<const unsigned char*>(bytes);
+            return std::uint32_t(data[0]) | (std::uint32_t(data[1]) << 8) | (std::uint32_t(data[2]) << 16) |
+                   (std::uint32_t(data[3]) << 24);
+        }
+
+        /* getSignedInt:  returns the signed (two's complement) value of the 4 bytes at bytes */
+        inline int getSignedInt(const char* bytes)
+        {
+            const std::uint32_t value = getInt(bytes);
+            return value <= 0x7fffffffu ? int(value) : -int(~value) - 1;
+        }
+    }
+}
+
+#endif
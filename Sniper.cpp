@@ -1,6 +1,8 @@
 #include "Sniper.h"
 #include <iostream>
 #include <cmath>
+#include <algorithm>
+#include <vector>
 
 
 namespace mtm {
@@ -15,35 +17,64 @@ namespace mtm {
         return new Sniper(*this);
     }
 
+    std::shared_ptr<Character> Sniper::cloneShared() const
+    {
+        return std::allocate_shared<Sniper>(PoolAllocator<Sniper>(), *this);
+    }
+
+    CharacterType Sniper::getType() const
+    {
+        return SNIPER;
+    }
+
 
-    void Sniper::attack(GridPoint attacker_point, GridPoint victim_point,Matrix<std::shared_ptr<Character>>& board)  
+    ActionStatus Sniper::checkAttack(const GridPoint& attacker_point, const GridPoint& victim_point,
+                                     const Board& board) const
     {
         //check range
         if((GridPoint::distance(attacker_point,victim_point)<ceil((double)range/kSniperMinRange)) 
                                     || (GridPoint::distance(attacker_point,victim_point)>range))
         {
-            throw mtm::OutOfRange();
+            return OUT_OF_RANGE;
         }
         //check ammo
         if(ammo == 0) {
-            throw mtm::OutOfAmmo();
+            return OUT_OF_AMMO;
         }
-        std::shared_ptr<Character> victim=board(victim_point.row,victim_point.col);
+        const std::shared_ptr<Character>& victim=board.atUnchecked(victim_point.row,victim_point.col);
         if((victim==nullptr) || (isSameTeam(*this,*victim)))
         {
-            throw mtm::IllegalTarget();
+            return ILLEGAL_TARGET;
         }
+        return SUCCESS;
+    }
+
+    void Sniper::legalTargets(const GridPoint& attacker_point, const Board&,
+                              const Occupancy& occupancy, std::vector<GridPoint>& targets) const
+    {
+        if(ammo == 0) {
+            return;
+        }
+        //the enemies within range, except those closer than the minimal range
+        const int min_range = ceil((double)range/kSniperMinRange);
+        const std::vector<GridPoint>::size_type first = targets.size();
+        occupancy.appendUnitsInRadius(team == CPP ? PYTHON : CPP, attacker_point, range, targets);
+        targets.erase(std::remove_if(targets.begin() + first, targets.end(), [&](const GridPoint& target) {
+            return GridPoint::distance(attacker_point, target) < min_range;
+        }), targets.end());
+    }
+
+    void Sniper::performAttack(const GridPoint&, const GridPoint& victim_point,
+                               Board& board, BoardObserver& observer)
+    {
         ammo--;
         attacks_counter++;
         if (attacks_counter==kSpecialAttackNum){
             attacks_counter=0;
-            victim->changeHealth(kSpecialAttackMultiply*power);
+            damage(victim_point, kSpecialAttackMultiply*power, board, observer);
         }
         else{
-            victim->changeHealth(power);
-        }
-        if(victim->isDead()){
-            board(victim_point.row,victim_point.col)=nullptr;
+            damage(victim_point, power, board, observer);
         }
     }
 }
\ No newline at end of file
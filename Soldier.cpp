@@ -1,5 +1,8 @@
 #include "Soldier.h"
 #include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 
 namespace mtm {
@@ -14,47 +17,79 @@ namespace mtm {
         return new Soldier(*this);
     }
 
+    std::shared_ptr<Character> Soldier::cloneShared() const
+    {
+        return std::allocate_shared<Soldier>(PoolAllocator<Soldier>(), *this);
+    }
 
-    void Soldier::attack(GridPoint attacker_point, GridPoint victim_point,Matrix<std::shared_ptr<Character>>& board)  
+    CharacterType Soldier::getType() const
+    {
+        return SOLDIER;
+    }
+
+
+    ActionStatus Soldier::checkAttack(const GridPoint& attacker_point, const GridPoint& victim_point,
+                                      const Board&) const
     {
         //check range
         if(GridPoint::distance(attacker_point,victim_point)>range)
         {
-            throw mtm::OutOfRange();
+            return OUT_OF_RANGE;
         }
         //check ammo
         if(ammo == 0) {
-            throw mtm::OutOfAmmo();
+            return OUT_OF_AMMO;
         }
-        std::shared_ptr<Character> victim=board(victim_point.row,victim_point.col);
         if ((attacker_point.row!=victim_point.row) && (attacker_point.col!=victim_point.col)){
-            throw mtm::IllegalTarget();
+            return ILLEGAL_TARGET;
         }
+        return SUCCESS;
+    }
+
+    void Soldier::legalTargets(const GridPoint& attacker_point, const Board& board,
+                               const Occupancy&, std::vector<GridPoint>& targets) const
+    {
+        if(ammo == 0) {
+            return;
+        }
+        //every cell (empty or not) of the row and the column of the attacker within range
+        const int first_row = attacker_point.row - std::min(range, attacker_point.row);
+        const int last_row = attacker_point.row + std::min(range, board.height() - 1 - attacker_point.row);
+        for(int i=first_row; i<=last_row; i++){
+            if(i != attacker_point.row){
+                targets.push_back(GridPoint(i, attacker_point.col));
+                continue;
+            }
+            const int first_col = attacker_point.col - std::min(range, attacker_point.col);
+            const int last_col = attacker_point.col + std::min(range, board.width() - 1 - attacker_point.col);
+            for(int j=first_col; j<=last_col; j++){
+                targets.push_back(GridPoint(i, j));
+            }
+        }
+    }
+
+    void Soldier::performAttack(const GridPoint&, const GridPoint& victim_point,
+                                Board& board, BoardObserver& observer)
+    {
+        const std::shared_ptr<Character>& victim=board.atUnchecked(victim_point.row,victim_point.col);
         ammo--;
         if(victim)
         {
             if(!isSameTeam(*this,*victim))
             {
-                victim->changeHealth(power);
-                if(victim->isDead())
-                {
-                    board(victim_point.row,victim_point.col)=nullptr;
-                }
+                damage(victim_point, power, board, observer);
             }
         }
-        for(int i=0; i<board.height(); i++){
-            for(int j=0;j<board.width();j++){
-                GridPoint current_point(i,j);
-                if((board(i,j)!=nullptr)
-                    && GridPoint::distance(current_point, victim_point) <= 
-                    ceil((double)getRange()/kSoldierDangerZone)
-                    && GridPoint::distance(current_point, victim_point) > 0 
-                    && !(isSameTeam(*this, *(board(i,j))))){
-                        board(i,j)->changeHealth(ceil((double)power/kSoldierRicochetDamage));
-                        if(board(i,j)->isDead()){
-                            board(i,j) = nullptr;
-                        }
-                }
+        //ricochet: only the enemies within the danger zone (a diamond around the victim),
+        //found in the occupancy bitboards of the enemy team instead of testing every cell of the zone
+        const int danger_radius = ceil((double)getRange()/kSoldierDangerZone);
+        const units_t ricochet_damage = ceil((double)power/kSoldierRicochetDamage);
+        const Team enemy = team == CPP ? PYTHON : CPP;
+        std::vector<GridPoint>& enemies = observer.cellsBuffer();
+        observer.getOccupancy().appendUnitsInRadius(enemy, victim_point, danger_radius, enemies);
+        for(std::vector<GridPoint>::const_iterator it = enemies.begin(); it != enemies.end(); ++it){
+            if(!(*it == victim_point)){
+                damage(*it, ricochet_damage, board, observer);
             }
         }
     }
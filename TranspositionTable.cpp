@@ -0,0 +1,55 @@
+#include "TranspositionTable.h"
+#include "Exceptions.h"
+
+namespace mtm
+{
+    TranspositionTable::TranspositionTable(std::size_t size) : mask(1)
+    {
+        if (size == 0)
+        {
+            throw mtm::IllegalArgument();
+        }
+        while (mask + 1 < size)
+        {
+            mask = (mask << 1) | 1;
+        }
+        entries.reset(new Entry[mask + 1]);
+        clear();
+    }
+
+    std::size_t TranspositionTable::size() const
+    {
+        return mask + 1;
+    }
+
+    void TranspositionTable::store(std::uint64_t hash, std::uint64_t value)
+    {
+        Entry &entry = entries[hash & mask];
+        entry.checked_key.store(hash ^ value, std::memory_order_relaxed);
+        entry.value.store(value, std::memory_order_relaxed);
+    }
+
+    bool TranspositionTable::probe(std::uint64_t hash, std::uint64_t &value) const
+    {
+        const Entry &entry = entries[hash & mask];
+        const std::uint64_t checked_key = entry.checked_key.load(std::memory_order_relaxed);
+        const std::uint64_t entry_value = entry.value.load(std::memory_order_relaxed);
+        if ((checked_key ^ entry_value) != hash)
+        {
+            return false;
+        }
+        value = entry_value;
+        return true;
+    }
+
+    void TranspositionTable::clear()
+    {
+        // an empty entry holds a key that belongs to a different entry (its index with the lowest bit flipped),
+        // so no hash probed in it matches
+        for (std::uint64_t i = 0; i <= mask; i++)
+        {
+            entries[i].checked_key.store(i ^ 1, std::memory_order_relaxed);
+            entries[i].value.store(0, std::memory_order_relaxed);
+        }
+    }
+} // namespace mtm
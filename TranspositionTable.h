@@ -0,0 +1,47 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace mtm {
+    /* class TranspositionTable: A fixed size table from game hashes (Game::getHash) to 64 bit values,
+                                 for looking up positions a search already evaluated in O(1).
+                                 Each hash has a single entry (chosen by its low bits), and a store replaces
+                                 whatever the entry held. The table is lock-free: any number of threads may
+                                 store and probe at the same time. An entry holds the value and the value xored
+                                 with the hash, so an entry torn by two concurrent stores fails the check in probe
+                                 and is read as missing instead of returning the value of another position.
+    */
+    class TranspositionTable {
+        struct Entry {
+            std::atomic<std::uint64_t> checked_key;
+            std::atomic<std::uint64_t> value;
+        };
+        std::unique_ptr<Entry[]> entries;
+        std::uint64_t mask;
+
+        public:
+        /* C'tor:  Creates an empty table of at least the given number of entries (rounded up to a power of 2,
+                   and at least 2), throws IllegalArgument if size isn't positive  */
+        explicit TranspositionTable(std::size_t size);
+
+        TranspositionTable(const TranspositionTable&) = delete;
+        TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+        /* size:  returns the number of entries of the table  */
+        std::size_t size() const;
+
+        /* store:  stores the value of the given hash (replacing the entry of the hash)  */
+        void store(std::uint64_t hash, std::uint64_t value);
+
+        /* probe:  returns if the table holds a value for the given hash, and if so writes it to value  */
+        bool probe(std::uint64_t hash, std::uint64_t& value) const;
+
+        /* clear:  removes all the entries (must not run concurrently with store or probe)  */
+        void clear();
+    };
+}
+
+#endif
@@ -0,0 +1,202 @@
+#include "ActionLog.h"
+#include "TestUtilities.h"
+#include <random>
+#include <sstream>
+#include <streambuf>
+
+using namespace mtm;
+using test::gameState;
+
+static Game randomGame(std::mt19937& rng, const int height, const int width, const int units)
+{
+    Game game(height, width);
+    for (int i = 0; i < units; i++) {
+        try {
+            game.addCharacter(GridPoint(rng() % height, rng() % width),
+                              Game::makeCharacter(CharacterType(rng() % 3), Team(rng() % 2), 1 + rng() % 15,
+                                                  rng() % 4, rng() % 8, rng() % 6));
+        } catch (const CellOccupied&) {}
+    }
+    return game;
+}
+
+static Command randomCommand(std::mt19937& rng, const int height, const int width)
+{
+    const Command command = {CommandType(rng() % 3), int(rng() % height), int(rng() % width), int(rng() % height),
+                             int(rng() % width)};
+    return command;
+}
+
+/* LimitedBuffer: a stream buffer that accepts only its first limit bytes, so writing to it then fails */
+class LimitedBuffer : public std::streambuf {
+    std::size_t limit;
+    protected:
+        int_type overflow(int_type c) override
+        {
+            if (limit == 0 || traits_type::eq_int_type(c, traits_type::eof())) {
+                return traits_type::eof();
+            }
+            limit--;
+            return c;
+        }
+    public:
+        explicit LimitedBuffer(const std::size_t limit) : limit(limit) {}
+};
+
+bool testReplayMatchesRecording()
+{
+    for (unsigned seed = 1; seed < 40; seed++) {
+        std::mt19937 rng(seed);
+        const int height = 1 + rng() % 9, width = 1 + rng() % 9;
+        Game game = randomGame(rng, height, width, height * width / 2);
+        std::ostringstream log;
+        ActionRecorder recorder(game, log, 1 + seed % 17);
+        std::vector<std::string> states(1, gameState(game));
+        std::vector<ActionStatus> statuses;
+        for (int i = 0; i < 200; i++) {
+            const Command command = randomCommand(rng, height, width);
+            if (i % 2 == 0) {
+                statuses.push_back(recorder.apply(command));
+            } else {
+                ActionStatus status = SUCCESS;
+                try {
+                    if (command.type == MOVE) {
+                        recorder.move(GridPoint(command.src_row, command.src_col),
+                                      GridPoint(command.dst_row, command.dst_col));
+                    } else if (command.type == ATTACK) {
+                        recorder.attack(GridPoint(command.src_row, command.src_col),
+                                        GridPoint(command.dst_row, command.dst_col));
+                    } else {
+                        recorder.reload(GridPoint(command.src_row, command.src_col));
+                    }
+                } catch (const GameException&) {
+                    status = ILLEGAL_CELL;
+                }
+                statuses.push_back(status);
+            }
+            states.push_back(gameState(game));
+        }
+        ASSERT_TEST(recorder.getActions() == 200);
+        const std::string bytes = log.str();
+        ActionReplayer replayer(bytes.data(), bytes.size());
+        ASSERT_TEST(replayer.getActions() == 200);
+        for (int action = 0; action <= 200; action++) {
+            ASSERT_TEST(gameState(replayer.gameAt(action)) == states[action]);
+        }
+        for (int action = 0; action < 200; action++) {
+            ASSERT_TEST((replayer.getStatus(action) == SUCCESS) == (statuses[action] == SUCCESS));
+        }
+        ASSERT_THROWS(replayer.gameAt(201), IllegalArgument);
+        ASSERT_THROWS(replayer.gameAt(-1), IllegalArgument);
+    }
+    return true;
+}
+
+bool testInvalidLogs()
+{
+    std::mt19937 rng(3);
+    Game game = randomGame(rng, 5, 5, 10);
+    std::ostringstream log;
+    ActionRecorder recorder(game, log, 8);
+    for (int i = 0; i < 20; i++) {
+        recorder.apply(randomCommand(rng, 5, 5));
+    }
+    const std::string bytes = log.str();
+    ASSERT_THROWS(ActionReplayer(bytes.data(), bytes.size() - 1), IllegalSnapshot);
+    ASSERT_THROWS(ActionReplayer(bytes.data(), 0), IllegalSnapshot);
+    std::string corrupt = bytes;
+    corrupt[0] = 'A';
+    ASSERT_THROWS(ActionReplayer(corrupt.data(), corrupt.size()), IllegalSnapshot);
+    ASSERT_THROWS(ActionRecorder(game, log, 0), IllegalArgument);
+    return true;
+}
+
+bool testFailedWritesThrow()
+{
+    std::mt19937 rng(4);
+    Game game = randomGame(rng, 6, 6, 12);
+    std::ostringstream bad_log;
+    bad_log.setstate(std::ios::badbit);
+    ASSERT_THROWS(ActionRecorder(game, bad_log), IllegalSnapshot);
+
+    std::ostringstream keyframe;
+    game.saveSnapshot(keyframe);
+    // room for the first keyframe and 10 actions, then every write fails
+    LimitedBuffer buffer(9 + keyframe.str().size() + 10 * 19);
+    std::ostream limited_log(&buffer);
+    ActionRecorder recorder(game, limited_log);
+    for (int i = 0; i < 10; i++) {
+        recorder.apply(randomCommand(rng, 6, 6));
+    }
+    ASSERT_THROWS(recorder.apply(randomCommand(rng, 6, 6)), IllegalSnapshot);
+    ASSERT_TEST(recorder.getActions() == 11);
+
+    LimitedBuffer keyframe_buffer(9 + keyframe.str().size() + 4 * 19);
+    std::ostream keyframe_log(&keyframe_buffer);
+    Game unchanged = game.clone();
+    ActionRecorder keyframe_recorder(unchanged, keyframe_log, 4);
+    for (int i = 0; i < 4; i++) {
+        keyframe_recorder.apply(randomCommand(rng, 6, 6));
+    }
+    const std::uint64_t hash = unchanged.getHash();
+    ASSERT_THROWS(keyframe_recorder.apply(Command{RELOAD, 0, 0, 0, 0}), IllegalSnapshot);
+    ASSERT_TEST(keyframe_recorder.getActions() == 4 && unchanged.getHash() == hash);
+    return true;
+}
+
+/* benchmarkReplay:  records random actions on a 50x50 board and measures replaying them: seeking to random actions
+                     (each replays at most keyframe interval actions after loading a keyframe), and replaying all
+                     of them from a log with a single keyframe */
+bool benchmarkReplay()
+{
+    const int kActions = 20000;
+    for (int interval : {256, kDefaultKeyframeInterval, kActions + 1}) {
+        std::mt19937 rng(5);
+        Game game(50, 50);
+        for (int i = 0; i < 1200; i++) {
+            try {
+                game.addCharacter(GridPoint(rng() % 50, rng() % 50),
+                                  Game::makeCharacter(CharacterType(rng() % 3), Team(rng() % 2), 30, 20, 6, 2));
+            } catch (const CellOccupied&) {}
+        }
+        std::ostringstream log;
+        test::Timer record_timer;
+        ActionRecorder recorder(game, log, interval);
+        for (int i = 0; i < kActions; i++) {
+            recorder.apply(randomCommand(rng, 50, 50));
+        }
+        const double record_seconds = record_timer.seconds();
+        const std::string bytes = log.str();
+        test::Timer index_timer;
+        ActionReplayer replayer(bytes.data(), bytes.size());
+        const double index_seconds = index_timer.seconds();
+        test::Timer replay_timer;
+        const Game end = replayer.gameAt(kActions);
+        const double replay_seconds = replay_timer.seconds();
+        ASSERT_TEST(end.getHash() == game.getHash());
+        std::cout << "  keyframe interval " << interval << ": log " << bytes.size() / 1024 << " KB, recording "
+                  << kActions / record_seconds << " actions/s, indexing " << index_seconds * 1000
+                  << " ms, replaying the " << kActions % interval << " actions after the last keyframe "
+                  << (kActions % interval) / replay_seconds << " actions/s";
+        if (interval <= kActions) {
+            const int kSeeks = 100;
+            test::Timer seek_timer;
+            for (int i = 0; i < kSeeks; i++) {
+                replayer.gameAt(rng() % (kActions + 1));
+            }
+            std::cout << ", " << kSeeks / seek_timer.seconds() << " random seeks/s";
+        }
+        std::cout << std::endl;
+    }
+    return true;
+}
+
+int main()
+{
+    int failures = 0;
+    RUN_TEST(testReplayMatchesRecording, failures);
+    RUN_TEST(testInvalidLogs, failures);
+    RUN_TEST(testFailedWritesThrow, failures);
+    RUN_TEST(benchmarkReplay, failures);
+    return failures;
+}
@@ -0,0 +1,305 @@
+#include "Game.h"
+#include "TestUtilities.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/** allocations / live_allocations: the number of calls to operator new, and the number of blocks it returned that
+*   weren't deleted yet - a test compares them before and after the code it checks (atomic: threads allocate too)
+* */
+static std::atomic<long> allocations(0);
+static std::atomic<long> live_allocations(0);
+
+void* operator new(std::size_t size)
+{
+    ++allocations;
+    ++live_allocations;
+    if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    if (pointer != nullptr) {
+        --live_allocations;
+        std::free(pointer);
+    }
+}
+
+using namespace mtm;
+
+static const CharacterType kTypes[] = { SOLDIER, MEDIC, SNIPER };
+
+/* makeUnits:  adds count units of all the types to units. main calls it once before the tests, so the pools
+               themselves (which are never destroyed) are created before the tests count the live allocations */
+static void makeUnits(std::vector<std::shared_ptr<Character>>& units, const int count)
+{
+    for (int i = 0; i < count; i++) {
+        units.push_back(Game::makeCharacter(kTypes[i % 3], i % 2 == 0 ? CPP : PYTHON, 10, 2, 4, 5));
+    }
+}
+
+bool testBlocksReleasedOnAnotherThread()
+{
+    const long live_before = live_allocations;
+    std::vector<std::shared_ptr<Character>> units;
+    units.reserve(30000);
+    std::thread maker([&]() { makeUnits(units, 30000); });
+    maker.join();
+    std::thread releaser([&]() { units.clear(); });
+    releaser.join();
+    units.shrink_to_fit();
+    ASSERT_TEST(live_allocations == live_before);
+    return true;
+}
+
+bool testThreadsThatExitDontKeepBlocks()
+{
+    const long live_before = live_allocations;
+    long live_after_first_round = 0;
+    std::vector<std::shared_ptr<Character>> survivors;
+    for (int round = 0; round < 20; round++) {
+        std::vector<std::thread> threads;
+        std::vector<std::vector<std::shared_ptr<Character>>> kept(4);
+        for (int t = 0; t < 4; t++) {
+            threads.push_back(std::thread([&kept, t]() {
+                std::vector<std::shared_ptr<Character>> units;
+                makeUnits(units, 2000);
+                Game game(50, 50);
+                for (int i = 0; i < 1000; i++) {
+                    game.addCharacter(GridPoint(i / 50, i % 50), units[i]);
+                }
+                Game copy = game;
+                copy.attack(GridPoint(0, 0), GridPoint(0, 1));
+                kept[t].assign(units.begin(), units.begin() + 100);
+            }));
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        for (std::vector<std::shared_ptr<Character>>& units : kept) {
+            survivors.insert(survivors.end(), units.begin(), units.end());
+        }
+        survivors.resize(100);
+        if (round == 0) {
+            live_after_first_round = live_allocations;
+        }
+        // the chunks stay while the survivors use them, but the free blocks are reused by the next threads
+        ASSERT_TEST(live_allocations < 2 * live_after_first_round);
+    }
+    survivors.clear();
+    survivors.shrink_to_fit();
+    ASSERT_TEST(live_allocations == live_before);
+    return true;
+}
+
+bool testConcurrentAllocateAndRelease()
+{
+    const long live_before = live_allocations;
+    std::vector<std::shared_ptr<Character>> shared_units;
+    makeUnits(shared_units, 4000);
+    std::vector<std::thread> threads;
+    threads.reserve(4);
+    for (int t = 0; t < 4; t++) {
+        threads.push_back(std::thread([&shared_units, t]() {
+            std::vector<std::shared_ptr<Character>> units;
+            for (int round = 0; round < 50; round++) {
+                makeUnits(units, 200);
+                for (int i = t; i < 4000; i += 4) {
+                    units.push_back(shared_units[i]->cloneShared());
+                }
+                units.erase(units.begin(), units.begin() + units.size() / 2);
+            }
+        }));
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    threads.clear();
+    threads.shrink_to_fit();
+    shared_units.clear();
+    shared_units.shrink_to_fit();
+    ASSERT_TEST(live_allocations == live_before);
+    return true;
+}
+
+/** testNestedBatches: the blocks of an inner batch stay with the thread until the outermost batch ends
+* */
+bool testNestedBatches()
+{
+    const long live_before = live_allocations;
+    {
+        PoolBatch outer;
+        std::vector<std::shared_ptr<Character>> units;
+        units.reserve(1000);
+        {
+            PoolBatch inner;
+            makeUnits(units, 1000);
+            units.erase(units.begin(), units.begin() + 500);
+        }
+        ASSERT_TEST(PoolBatch::active());
+        std::shared_ptr<Character> clone = units[0]->cloneShared();
+        units.clear();
+        units.shrink_to_fit();
+        ASSERT_TEST(live_allocations > live_before);
+    }
+    ASSERT_TEST(!PoolBatch::active());
+    ASSERT_TEST(live_allocations == live_before);
+    return true;
+}
+
+/** testBatchBlocksReleasedOnAnotherThread: blocks a batch allocated may be released by another thread, with or
+*                                           without a batch of its own, while the batch is still active
+* */
+bool testBatchBlocksReleasedOnAnotherThread()
+{
+    const long live_before = live_allocations;
+    std::vector<std::shared_ptr<Character>> units;
+    units.reserve(20000);
+    {
+        PoolBatch batch;
+        makeUnits(units, 20000);
+        std::thread releaser([&units]() {
+            units.erase(units.begin(), units.begin() + 10000);
+        });
+        releaser.join();
+        std::thread batch_releaser([&units]() {
+            PoolBatch batch;
+            units.erase(units.begin(), units.begin() + 5000);
+        });
+        batch_releaser.join();
+        makeUnits(units, 5000);
+    }
+    std::thread releaser([&units]() {
+        PoolBatch batch;
+        units.clear();
+    });
+    releaser.join();
+    units.shrink_to_fit();
+    ASSERT_TEST(live_allocations == live_before);
+    return true;
+}
+
+/** testPooledAllocationCount: creating 100k units takes a heap allocation per chunk of blocks instead of one
+*                              per unit, and destroying the game that holds them gives all the chunks back.
+*                              (Cloning a game also allocates its chunks of cells and of occupancy words - see Board
+*                              and Occupancy - which are counted by cloning an empty game of the same size.)
+* */
+bool testPooledAllocationCount()
+{
+    const int kUnits = 100000;
+    const long live_before = live_allocations;
+    {
+        Game game(400, 250);
+        long allocations_before = allocations;
+        test::Timer timer;
+        for (int i = 0; i < kUnits; i++) {
+            game.addCharacter(GridPoint(i / 250, i % 250),
+                              Game::makeCharacter(kTypes[i % 3], i % 2 == 0 ? CPP : PYTHON, 10, 2, 4, 5));
+        }
+        const double fill_seconds = timer.seconds();
+        const long fill_allocations = allocations - allocations_before;
+        const Game empty_game(400, 250);
+        allocations_before = allocations;
+        const Game empty_clone = empty_game.clone();
+        const long board_allocations = allocations - allocations_before;
+        allocations_before = allocations;
+        Game clone = game.clone();
+        const long clone_allocations = allocations - allocations_before - board_allocations;
+        std::cout << "  " << kUnits << " units: " << fill_allocations << " heap allocations to add them ("
+                  << fill_seconds << "s), " << clone_allocations << " to clone them (and " << board_allocations
+                  << " for the board)" << std::endl;
+        ASSERT_TEST(fill_allocations < kUnits / 100);
+        ASSERT_TEST(clone_allocations < kUnits / 100);
+    }
+    ASSERT_TEST(live_allocations == live_before);
+    return true;
+}
+
+/** testBulkCloneAndDestroy: cloning and destroying a game with 100k units locks each pool once per chunk of blocks
+*                            instead of once per unit. Prints the time of cloning and destroying the units one by
+*                            one and as a batch (as Game::clone and the Game D'tor do), and checks that the game
+*                            clones all the units and gives all the blocks back
+* */
+bool testBulkCloneAndDestroy()
+{
+    const int kUnits = 100000;
+    const long live_before = live_allocations;
+    {
+        Game game(400, 250);
+        std::vector<std::shared_ptr<Character>> units;
+        units.reserve(kUnits);
+        makeUnits(units, kUnits);
+        for (int i = 0; i < kUnits; i++) {
+            game.addCharacter(GridPoint(i / 250, i % 250), units[i]);
+        }
+        std::vector<std::shared_ptr<Character>> clones;
+        clones.reserve(kUnits);
+        // the first clones allocate the chunks, so both ways are timed with the chunks already in the pools
+        for (const std::shared_ptr<Character>& unit : units) {
+            clones.push_back(unit->cloneShared());
+        }
+        clones.clear();
+
+        test::Timer timer;
+        for (const std::shared_ptr<Character>& unit : units) {
+            clones.push_back(unit->cloneShared());
+        }
+        const double single_clone_seconds = timer.seconds();
+        timer = test::Timer();
+        clones.clear();
+        const double single_destroy_seconds = timer.seconds();
+
+        timer = test::Timer();
+        {
+            PoolBatch batch;
+            for (const std::shared_ptr<Character>& unit : units) {
+                clones.push_back(unit->cloneShared());
+            }
+        }
+        const double batch_clone_seconds = timer.seconds();
+        timer = test::Timer();
+        {
+            PoolBatch batch;
+            clones.clear();
+        }
+        const double batch_destroy_seconds = timer.seconds();
+
+        const long live_before_clone = live_allocations;
+        timer = test::Timer();
+        Game* clone = new Game(game.clone());
+        const double game_clone_seconds = timer.seconds();
+        ASSERT_TEST(clone->getHash() == game.getHash());
+        ASSERT_TEST(live_allocations > live_before_clone);
+        timer = test::Timer();
+        delete clone;
+        const double game_destroy_seconds = timer.seconds();
+        ASSERT_TEST(live_allocations == live_before_clone);
+
+        std::cout << "  " << kUnits << " units: clone / destroy one by one " << single_clone_seconds << "s / "
+                  << single_destroy_seconds << "s, as a batch " << batch_clone_seconds << "s / "
+                  << batch_destroy_seconds << "s, Game::clone / D'tor " << game_clone_seconds << "s / "
+                  << game_destroy_seconds << "s" << std::endl;
+    }
+    ASSERT_TEST(live_allocations == live_before);
+    return true;
+}
+
+int main()
+{
+    std::vector<std::shared_ptr<Character>> first_units;
+    makeUnits(first_units, 3);
+    first_units.clear();
+    first_units.shrink_to_fit();
+    int failures = 0;
+    RUN_TEST(testBlocksReleasedOnAnotherThread, failures);
+    RUN_TEST(testThreadsThatExitDontKeepBlocks, failures);
+    RUN_TEST(testConcurrentAllocateAndRelease, failures);
+    RUN_TEST(testNestedBatches, failures);
+    RUN_TEST(testBatchBlocksReleasedOnAnotherThread, failures);
+    RUN_TEST(testPooledAllocationCount, failures);
+    RUN_TEST(testBulkCloneAndDestroy, failures);
+    return failures;
+}
@@ -0,0 +1,283 @@
+#include "CompactGame.h"
+#include "Game.h"
+#include "TestUtilities.h"
+#include <cstring>
+#include <random>
+#include <streambuf>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace mtm;
+
+namespace {
+    enum Operation { ADD, MOVE_UNIT, ATTACK_UNIT, RELOAD_UNIT };
+
+    /* Step: an action of a scripted match - ADD uses the source cell and the unit, the other operations the cells */
+    struct Step {
+        Operation operation;
+        int src_row, src_col, dst_row, dst_col;
+        CharacterType type;
+        Team team;
+        units_t health, ammo, range, power;
+    };
+
+    /* perform:  performs a step on a game and returns "ok", or the what() of the exception it threw */
+    template <class G>
+    std::string perform(G& game, const Step& step);
+
+    template <>
+    std::string perform(Game& game, const Step& step)
+    {
+        const GridPoint source(step.src_row, step.src_col), target(step.dst_row, step.dst_col);
+        try {
+            switch (step.operation) {
+                case ADD:
+                    game.addCharacter(source, Game::makeCharacter(step.type, step.team, step.health, step.ammo,
+                                                                  step.range, step.power));
+                    break;
+                case MOVE_UNIT:
+                    game.move(source, target);
+                    break;
+                case ATTACK_UNIT:
+                    game.attack(source, target);
+                    break;
+                case RELOAD_UNIT:
+                    game.reload(source);
+            }
+        } catch (const GameException& e) {
+            return e.what();
+        }
+        return "ok";
+    }
+
+    template <>
+    std::string perform(CompactGame& game, const Step& step)
+    {
+        const GridPoint source(step.src_row, step.src_col), target(step.dst_row, step.dst_col);
+        try {
+            switch (step.operation) {
+                case ADD:
+                    game.addCharacter(source, step.type, step.team, step.health, step.ammo, step.range, step.power);
+                    break;
+                case MOVE_UNIT:
+                    game.move(source, target);
+                    break;
+                case ATTACK_UNIT:
+                    game.attack(source, target);
+                    break;
+                case RELOAD_UNIT:
+                    game.reload(source);
+            }
+        } catch (const GameException& e) {
+            return e.what();
+        }
+        return "ok";
+    }
+
+    /* state:  the printed board and the result of a game */
+    template <class G>
+    std::string state(const G& game)
+    {
+        std::ostringstream os;
+        Team winner = CPP;
+        const bool over = game.isOver(&winner);
+        os << game << over << (over ? int(winner) : -1);
+        return os.str();
+    }
+
+    Step add(int row, int col, CharacterType type, Team team, units_t health, units_t ammo, units_t range,
+             units_t power)
+    {
+        const Step step = {ADD, row, col, row, col, type, team, health, ammo, range, power};
+        return step;
+    }
+
+    Step action(Operation operation, int src_row, int src_col, int dst_row = 0, int dst_col = 0)
+    {
+        const Step step = {operation, src_row, src_col, dst_row, dst_col, SOLDIER, CPP, 0, 0, 0, 0};
+        return step;
+    }
+
+    /* DiscardBuffer:  a stream buffer that drops what is written to it */
+    class DiscardBuffer : public std::streambuf {
+        protected:
+        int_type overflow(const int_type c) override
+        {
+            return traits_type::not_eof(c);
+        }
+
+        std::streamsize xsputn(const char*, const std::streamsize count) override
+        {
+            return count;
+        }
+    };
+
+    /* legalSteps:  a match of count legal actions on a board filled with the given units: each is one of the
+                    legal actions of a random unit (see Game::legalActions) in the game after the ones before */
+    std::vector<Step> legalSteps(std::mt19937& rng, const std::vector<Step>& units, const int height,
+                                 const int width, const int count)
+    {
+        Game game(height, width);
+        for (const Step& unit : units) {
+            perform(game, unit);
+        }
+        std::vector<Step> steps;
+        std::vector<Command> actions;
+        while (int(steps.size()) < count) {
+            actions.clear();
+            if (game.legalActions(GridPoint(rng() % height, rng() % width), actions) == 0) {
+                continue;
+            }
+            const Command& command = actions[rng() % actions.size()];
+            const Operation operation = command.type == MOVE ? MOVE_UNIT : command.type == ATTACK ? ATTACK_UNIT :
+                                        RELOAD_UNIT;
+            steps.push_back(action(operation, command.src_row, command.src_col, command.dst_row, command.dst_col));
+            perform(game, steps.back());
+        }
+        return steps;
+    }
+
+    /* playMatch:  adds the units and performs the steps on a new game, and prints it frames times to the stream;
+                   prints the rate of each and returns the state of the game */
+    template <class G>
+    std::string playMatch(const char* name, const std::vector<Step>& units, const std::vector<Step>& steps,
+                          const int height, const int width, const int frames, std::ostream& os)
+    {
+        test::Timer add_timer;
+        G game(height, width);
+        for (const Step& unit : units) {
+            perform(game, unit);
+        }
+        const double add_seconds = add_timer.seconds();
+        test::Timer steps_timer;
+        for (const Step& step : steps) {
+            perform(game, step);
+        }
+        const double steps_seconds = steps_timer.seconds();
+        test::Timer print_timer;
+        for (int frame = 0; frame < frames; frame++) {
+            os << game;
+        }
+        const double print_seconds = print_timer.seconds();
+        std::cout << "  " << height << "x" << width << " " << name << ": " << units.size() / add_seconds / 1e6
+                  << " M units added/s, " << steps.size() / steps_seconds / 1e6 << " M actions/s, "
+                  << double(height) * width * frames / print_seconds / 1e6 << " M cells printed/s" << std::endl;
+        return state(game);
+    }
+}
+
+/* testScriptedMatch:  plays a whole match on both boards - every kind of unit, action and illegal action - and
+                       compares the outcome of each step and the boards after it */
+bool testScriptedMatch()
+{
+    const Step script[] = {
+        add(0, 0, SOLDIER, CPP, 10, 2, 4, 5), add(1, 1, MEDIC, CPP, 8, 3, 2, 3), add(0, 7, SNIPER, CPP, 6, 3, 5, 4),
+        add(4, 0, SOLDIER, PYTHON, 6, 2, 4, 3), add(3, 3, MEDIC, PYTHON, 4, 1, 2, 2),
+        add(4, 7, SNIPER, PYTHON, 5, 2, 4, 3), add(4, 4, SOLDIER, PYTHON, 3, 1, 2, 2),
+        add(0, 0, MEDIC, PYTHON, 5, 1, 1, 1), add(5, 0, MEDIC, PYTHON, 5, 1, 1, 1), add(2, 2, MEDIC, PYTHON, 0, 1, 1, 1),
+        action(MOVE_UNIT, 0, 0, 2, 0), action(MOVE_UNIT, 2, 0, 2, 4), action(MOVE_UNIT, 2, 2, 2, 3),
+        action(ATTACK_UNIT, 2, 0, 4, 0), action(ATTACK_UNIT, 2, 0, 4, 0), action(ATTACK_UNIT, 2, 0, 4, 0),
+        action(RELOAD_UNIT, 2, 0), action(ATTACK_UNIT, 2, 0, 3, 1), action(ATTACK_UNIT, 4, 7, 0, 7),
+        action(ATTACK_UNIT, 0, 7, 4, 7), action(ATTACK_UNIT, 0, 7, 4, 7), action(ATTACK_UNIT, 0, 7, 4, 7),
+        action(ATTACK_UNIT, 0, 7, 0, 6), action(ATTACK_UNIT, 3, 3, 3, 3), action(MOVE_UNIT, 3, 3, 3, 1),
+        action(ATTACK_UNIT, 3, 1, 1, 1), action(ATTACK_UNIT, 1, 1, 3, 1), action(MOVE_UNIT, 1, 1, 2, 2),
+        action(ATTACK_UNIT, 2, 2, 2, 0), action(ATTACK_UNIT, 4, 4, 2, 4), action(MOVE_UNIT, 4, 4, 3, 4),
+        action(ATTACK_UNIT, 3, 4, 3, 2), action(MOVE_UNIT, 2, 0, 3, 0), action(ATTACK_UNIT, 3, 0, 3, 1),
+        action(RELOAD_UNIT, 3, 0), action(ATTACK_UNIT, 3, 0, 3, 4), action(ATTACK_UNIT, 3, 0, 3, 4),
+        action(RELOAD_UNIT, 0, 7), action(ATTACK_UNIT, 0, 7, 3, 4), action(ATTACK_UNIT, 0, 7, 3, 1),
+        action(ATTACK_UNIT, 0, 7, 3, 4), action(RELOAD_UNIT, 5, 5), action(MOVE_UNIT, 3, 0, 3, 0),
+    };
+    // the outcome of each step of the script (the name of the exception it throws)
+    const char* const outcomes[] = {
+        "ok", "ok", "ok", "ok", "ok", "ok", "ok", "CellOccupied", "IllegalCell", "IllegalArgument",
+        "ok", "MoveTooFar", "CellEmpty", "ok", "ok", "OutOfAmmo", "ok", "IllegalTarget", "ok", "ok", "ok",
+        "IllegalTarget", "OutOfRange", "IllegalTarget", "ok", "ok", "ok", "ok", "ok", "ok", "ok", "OutOfAmmo",
+        "ok", "ok", "ok", "ok", "ok", "ok", "OutOfRange", "OutOfRange", "OutOfRange", "IllegalCell", "ok",
+    };
+    static_assert(sizeof(script) / sizeof(script[0]) == sizeof(outcomes) / sizeof(outcomes[0]),
+                  "a scripted step without an outcome");
+    Game game(5, 8);
+    CompactGame compact(5, 8);
+    for (std::size_t i = 0; i < sizeof(script) / sizeof(script[0]); i++) {
+        const std::string outcome = perform(game, script[i]);
+        ASSERT_TEST(outcome == "ok" ? outcome == outcomes[i] :
+                    outcome.compare(outcome.size() - std::strlen(outcomes[i]), std::string::npos, outcomes[i]) == 0);
+        ASSERT_TEST(perform(compact, script[i]) == outcome);
+        ASSERT_TEST(state(compact) == state(game));
+    }
+    Team winner = PYTHON;
+    ASSERT_TEST(game.isOver(&winner) && winner == CPP);
+    return true;
+}
+
+/* testRandomMatches:  the same random actions (legal or not, inside the board or not) on both boards */
+bool testRandomMatches()
+{
+    int actions = 0;
+    for (unsigned seed = 1; seed < 300; seed++) {
+        std::mt19937 rng(seed);
+        const int height = 1 + rng() % 12, width = 1 + rng() % 12;
+        Game game(height, width);
+        CompactGame compact(height, width);
+        const int units = rng() % (height * width / 2 + 2);
+        for (int i = 0; i < units; i++) {
+            const Step step = add(int(rng() % (height + 1)) - 1 + int(rng() % 2), rng() % width,
+                                  CharacterType(rng() % 3), Team(rng() % 2), units_t(rng() % 16) - 1,
+                                  units_t(rng() % 4), units_t(rng() % 8), units_t(rng() % 6));
+            ASSERT_TEST(perform(compact, step) == perform(game, step));
+        }
+        ASSERT_TEST(state(compact) == state(game));
+        for (int i = 0; i < 300; i++) {
+            const Step step = action(Operation(MOVE_UNIT + rng() % 3), int(rng() % (height + 1)) - 1 + int(rng() % 2),
+                                     int(rng() % (width + 1)) - int(rng() % 2), rng() % height, rng() % width);
+            ASSERT_TEST(perform(compact, step) == perform(game, step));
+            ASSERT_TEST(state(compact) == state(game));
+            actions++;
+        }
+    }
+    ASSERT_TEST(actions == 299 * 300);
+    ASSERT_THROWS(CompactGame(0, 3), IllegalArgument);
+    ASSERT_THROWS(CompactGame(3, -1), IllegalArgument);
+    return true;
+}
+
+/* benchmarkCompactGame:  the same match on Game and on CompactGame, on a board that fits in the cache and on one
+                          that doesn't: adding the units, performing legal actions (so no exceptions are measured),
+                          and printing the board (a scan of every cell) */
+bool benchmarkCompactGame()
+{
+    std::mt19937 rng(11);
+    DiscardBuffer discard;
+    std::ostream os(&discard);
+    const int sizes[][2] = {{50, 50}, {1000, 1000}};
+    for (const int* size : sizes) {
+        const int height = size[0], width = size[1];
+        std::vector<Step> units;
+        std::vector<bool> occupied(height * width, false);
+        for (int i = 0; i < height * width / 3; i++) {
+            const int cell = rng() % (height * width);
+            if (!occupied[cell]) {
+                occupied[cell] = true;
+                units.push_back(add(cell / width, cell % width, CharacterType(rng() % 3), Team(rng() % 2),
+                                    1 + rng() % 15, rng() % 4, 1 + rng() % 7, 1 + rng() % 5));
+            }
+        }
+        const std::vector<Step> steps = legalSteps(rng, units, height, width, 200000);
+        const int frames = 10000000 / (height * width) + 1;
+        const std::string game_state = playMatch<Game>("Game", units, steps, height, width, frames, os);
+        const std::string compact_state = playMatch<CompactGame>("CompactGame", units, steps, height, width,
+                                                                 frames, os);
+        ASSERT_TEST(compact_state == game_state);
+    }
+    return true;
+}
+
+int main()
+{
+    int failures = 0;
+    RUN_TEST(testScriptedMatch, failures);
+    RUN_TEST(testRandomMatches, failures);
+    RUN_TEST(benchmarkCompactGame, failures);
+    return failures;
+}
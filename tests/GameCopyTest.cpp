@@ -0,0 +1,159 @@
+#include "Game.h"
+#include "TestUtilities.h"
+#include <atomic>
+#include <random>
+
+/** allocated_bytes: the number of bytes operator new returned, to measure what a copy of a game and its first
+*   change allocate
+* */
+static std::atomic<long> allocated_bytes(0);
+
+void* operator new(std::size_t size)
+{
+    allocated_bytes += long(size);
+    if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+using namespace mtm;
+using test::gameState;
+using test::sameGames;
+
+static Game randomGame(const unsigned seed, const int height, const int width, const int units)
+{
+    std::mt19937 rng(seed);
+    Game game(height, width);
+    for (int i = 0; i < units; i++) {
+        try {
+            game.addCharacter(GridPoint(rng() % height, rng() % width),
+                              Game::makeCharacter(CharacterType(rng() % 3), Team(rng() % 2), 1 + rng() % 15,
+                                                  rng() % 4, rng() % 8, rng() % 6));
+        } catch (const CellOccupied&) {}
+    }
+    return game;
+}
+
+static void playRandomActions(Game& game, const unsigned seed, const int actions)
+{
+    std::mt19937 rng(seed);
+    const int height = game.getHeight(), width = game.getWidth();
+    for (int i = 0; i < actions; i++) {
+        const GridPoint source(rng() % height, rng() % width), target(rng() % height, rng() % width);
+        switch (rng() % 3) {
+            case 0:
+                game.tryMove(source, target);
+                break;
+            case 1:
+                game.tryAttack(source, target);
+                break;
+            default:
+                game.tryReload(source);
+        }
+    }
+}
+
+/* testCopiesDontShareChanges:  copies (and copies of copies) of games on boards of several chunks of cells and of
+                                occupancy words change independently: each ends as a game that played the same
+                                actions without ever being copied */
+bool testCopiesDontShareChanges()
+{
+    const int kSizes[][2] = {{3, 4}, {40, 70}, {130, 9}, {70, 300}};
+    for (const int* size : kSizes) {
+        for (unsigned seed = 1; seed <= 10; seed++) {
+            const int height = size[0], width = size[1], units = height * width / 3;
+            Game game = randomGame(seed, height, width, units);
+            const std::string original_state = gameState(game);
+            Game copy = game;
+            Game copy_of_copy = copy;
+            Game assigned(1, 1);
+            assigned = game;
+            playRandomActions(copy, seed + 100, 300);
+            ASSERT_TEST(gameState(game) == original_state && gameState(copy_of_copy) == original_state);
+            playRandomActions(game, seed + 200, 300);
+            playRandomActions(assigned, seed + 300, 300);
+            ASSERT_TEST(gameState(copy_of_copy) == original_state);
+
+            Game copy_reference = randomGame(seed, height, width, units);
+            playRandomActions(copy_reference, seed + 100, 300);
+            Game game_reference = randomGame(seed, height, width, units);
+            playRandomActions(game_reference, seed + 200, 300);
+            Game assigned_reference = randomGame(seed, height, width, units);
+            playRandomActions(assigned_reference, seed + 300, 300);
+            ASSERT_TEST(sameGames(copy, copy_reference) && sameGames(game, game_reference) &&
+                        sameGames(assigned, assigned_reference));
+        }
+    }
+    return true;
+}
+
+/* testFirstChangeCopiesItsChunks:  copying a game allocates nothing, and the first change of the copy copies the
+                                    pointers to the chunks and the chunks it changes, not the cells of the board */
+bool testFirstChangeCopiesItsChunks()
+{
+    const int kSide = 1000;
+    Game game = randomGame(7, kSide, kSide, kSide * kSide / 10);
+    game.addCharacter(GridPoint(500, 500), Game::makeCharacter(SOLDIER, CPP, 10, 3, 4, 1));
+    const std::string original_state = gameState(game);
+    const long board_bytes = long(kSide) * kSide * sizeof(std::shared_ptr<Character>);
+
+    const long before_copy = allocated_bytes;
+    Game copy = game;
+    ASSERT_TEST(allocated_bytes == before_copy);
+    ASSERT_TEST(copy.tryReload(GridPoint(500, 500)) == SUCCESS);
+    const long first_change_bytes = allocated_bytes - before_copy;
+    std::cout << "  " << kSide << " x " << kSide << ": the first change of a copy allocates " << first_change_bytes
+              << " bytes (the cells of the board are " << board_bytes << " bytes)" << std::endl;
+    ASSERT_TEST(first_change_bytes < board_bytes / 100);
+    ASSERT_TEST(gameState(game) == original_state);
+    return true;
+}
+
+/* benchmarkSnapshotThroughput:  snapshots per second of the what-if loop of a search: copy the game, try an action
+                                 on the copy and drop it, next to the same loop with a full clone of the game in place
+                                 of the copy (what every copy cost when it cloned the board) */
+bool benchmarkSnapshotThroughput()
+{
+    for (int side : {100, 1000}) {
+        Game game = randomGame(11, side, side, side * side / 4);
+        std::mt19937 rng(5);
+        const int kSnapshots = 20000, kClones = side == 100 ? 2000 : 20;
+        int successes = 0;
+        test::Timer copy_timer;
+        for (int i = 0; i < kSnapshots; i++) {
+            Game copy = game;
+            const GridPoint source(rng() % side, rng() % side), target(rng() % side, rng() % side);
+            successes += copy.tryAttack(source, GridPoint(source.row, target.col)) == SUCCESS;
+            successes += copy.tryReload(source) == SUCCESS;
+        }
+        const double copy_seconds = copy_timer.seconds();
+        test::Timer clone_timer;
+        for (int i = 0; i < kClones; i++) {
+            Game copy = game.clone();
+            const GridPoint source(rng() % side, rng() % side), target(rng() % side, rng() % side);
+            successes += copy.tryAttack(source, GridPoint(source.row, target.col)) == SUCCESS;
+            successes += copy.tryReload(source) == SUCCESS;
+        }
+        const double clone_seconds = clone_timer.seconds();
+        ASSERT_TEST(successes > 0);
+        std::cout << "  " << side << " x " << side << ": " << kSnapshots / copy_seconds
+                  << " copy-and-change snapshots/s, " << kClones / clone_seconds << " clone-and-change snapshots/s"
+                  << std::endl;
+    }
+    return true;
+}
+
+int main()
+{
+    int failures = 0;
+    RUN_TEST(testCopiesDontShareChanges, failures);
+    RUN_TEST(testFirstChangeCopiesItsChunks, failures);
+    RUN_TEST(benchmarkSnapshotThroughput, failures);
+    return failures;
+}
@@ -0,0 +1,235 @@
+#include "Game.h"
+#include "TestUtilities.h"
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+using namespace mtm;
+
+namespace {
+    const int kSizes[][2] = {{1, 1}, {1, 9}, {9, 1}, {3, 5}, {20, 31}, {100, 100}, {7, 300}};
+
+    /* cellChar:  the char a character of the given type and team is printed as */
+    char cellChar(const CharacterType type, const Team team)
+    {
+        const char cpp_chars[] = {kSoldierCppTeam, kMedicCppTeam, kSniperCppTeam};
+        const char python_chars[] = {kSoldierPythonTeam, kMedicPythonTeam, kSniperPythonTeam};
+        return team == CPP ? cpp_chars[type] : python_chars[type];
+    }
+
+    /* PrintModel:  a game with the char of each of its cells kept next to it, row by row, as the old
+                    boardToCharArray built it for printGameBoard */
+    struct PrintModel {
+        Game game;
+        std::vector<char> cells;
+        int height, width;
+
+        PrintModel(std::mt19937& rng, const int height, const int width) : game(height, width),
+                                                                           cells(height * width, ' '),
+                                                                           height(height), width(width)
+        {
+            for (int i = 0; i < height * width / 3; i++) {
+                const GridPoint point(rng() % height, rng() % width);
+                const CharacterType type = CharacterType(rng() % 3);
+                const Team team = Team(rng() % 2);
+                if (cells[point.row * width + point.col] == ' ') {
+                    game.addCharacter(point, Game::makeCharacter(type, team, 1 + rng() % 9, rng() % 4, rng() % 5,
+                                                                 rng() % 4));
+                    cells[point.row * width + point.col] = cellChar(type, team);
+                }
+            }
+        }
+
+        /* randomMove:  tries a random move and updates the cells if it succeeded (a move to the source cell
+                        succeeds and changes nothing) */
+        void randomMove(std::mt19937& rng)
+        {
+            const GridPoint source(rng() % height, rng() % width), target(rng() % height, rng() % width);
+            if (game.tryMove(source, target) == SUCCESS && !(source == target)) {
+                cells[target.row * width + target.col] = cells[source.row * width + source.col];
+                cells[source.row * width + source.col] = ' ';
+            }
+        }
+
+        std::string printedCells() const
+        {
+            std::ostringstream os;
+            printGameBoard(os, cells.data(), cells.data() + cells.size(), width);
+            return os.str();
+        }
+    };
+
+    std::string printed(const Game& game)
+    {
+        std::ostringstream os;
+        os << game;
+        return os.str();
+    }
+
+    /* DiscardBuffer:  a stream buffer that drops what is written to it (and flushes for free) */
+    class DiscardBuffer : public std::streambuf {
+        protected:
+        int_type overflow(const int_type c) override
+        {
+            return traits_type::not_eof(c);
+        }
+
+        std::streamsize xsputn(const char*, const std::streamsize count) override
+        {
+            return count;
+        }
+    };
+
+    /* printOldFrame:  prints a frame the way operator<< printed it before the reusable frame - a new char array
+                       filled cell by cell and printed by printGameBoard (here filled from the model, which is
+                       cheaper than reading the board, so the old path is measured at its best) */
+    void printOldFrame(std::ostream& os, const PrintModel& model)
+    {
+        char* cells = new char[model.cells.size()];
+        for (std::size_t i = 0; i < model.cells.size(); i++) {
+            cells[i] = model.cells[i];
+        }
+        printGameBoard(os, cells, cells + model.cells.size(), model.width);
+        delete[] cells;
+    }
+}
+
+/** testPrintMatchesPrintGameBoard: operator<< prints the same bytes as printGameBoard of the board's chars, on
+*                                   boards of several sizes, after moves, printed again and printed from a copy
+* */
+bool testPrintMatchesPrintGameBoard()
+{
+    std::mt19937 rng(8);
+    for (const int* size : kSizes) {
+        PrintModel model(rng, size[0], size[1]);
+        ASSERT_TEST(printed(model.game) == model.printedCells());
+        for (int round = 0; round < 5; round++) {
+            for (int i = 0; i < size[0] * size[1] / 10 + 1; i++) {
+                model.randomMove(rng);
+            }
+            ASSERT_TEST(printed(model.game) == model.printedCells());
+            ASSERT_TEST(printed(model.game) == model.printedCells());
+        }
+        const Game copy(model.game);
+        ASSERT_TEST(printed(copy) == model.printedCells());
+    }
+    return true;
+}
+
+/** testEmptyBoardPrint: a board with no characters prints as printGameBoard prints spaces
+* */
+bool testEmptyBoardPrint()
+{
+    for (const int* size : kSizes) {
+        const std::vector<char> cells(size[0] * size[1], ' ');
+        std::ostringstream expected;
+        printGameBoard(expected, cells.data(), cells.data() + cells.size(), size[1]);
+        ASSERT_TEST(printed(Game(size[0], size[1])) == expected.str());
+    }
+    return true;
+}
+
+/** testViewportMatchesPrint: printViewport of the whole board prints as operator<<, and of any part of it prints
+*                             the cells of that part as printGameBoard prints them
+* */
+bool testViewportMatchesPrint()
+{
+    std::mt19937 rng(23);
+    for (const int* size : kSizes) {
+        PrintModel model(rng, size[0], size[1]);
+        for (int i = 0; i < size[0] * size[1] / 10 + 1; i++) {
+            model.randomMove(rng);
+        }
+        std::ostringstream full;
+        model.game.printViewport(full, GridPoint(0, 0), size[0], size[1]);
+        ASSERT_TEST(full.str() == printed(model.game));
+        for (int viewport = 0; viewport < 20; viewport++) {
+            const int row = rng() % size[0], col = rng() % size[1];
+            const int height = 1 + rng() % (size[0] - row), width = 1 + rng() % (size[1] - col);
+            std::vector<char> cells;
+            for (int i = 0; i < height; i++) {
+                for (int j = 0; j < width; j++) {
+                    cells.push_back(model.cells[(row + i) * size[1] + col + j]);
+                }
+            }
+            std::ostringstream expected, os;
+            printGameBoard(expected, cells.data(), cells.data() + cells.size(), width);
+            model.game.printViewport(os, GridPoint(row, col), height, width);
+            ASSERT_TEST(os.str() == expected.str());
+        }
+    }
+    return true;
+}
+
+/** testViewportOutsideTheBoardThrows: a viewport that isn't entirely inside the board, or is empty, throws
+*                                      IllegalCell and prints nothing
+* */
+bool testViewportOutsideTheBoardThrows()
+{
+    const Game game(4, 6);
+    std::ostringstream os;
+    ASSERT_THROWS(game.printViewport(os, GridPoint(-1, 0), 2, 2), IllegalCell);
+    ASSERT_THROWS(game.printViewport(os, GridPoint(0, -1), 2, 2), IllegalCell);
+    ASSERT_THROWS(game.printViewport(os, GridPoint(4, 0), 1, 1), IllegalCell);
+    ASSERT_THROWS(game.printViewport(os, GridPoint(0, 6), 1, 1), IllegalCell);
+    ASSERT_THROWS(game.printViewport(os, GridPoint(0, 0), 5, 6), IllegalCell);
+    ASSERT_THROWS(game.printViewport(os, GridPoint(2, 3), 2, 4), IllegalCell);
+    ASSERT_THROWS(game.printViewport(os, GridPoint(1, 1), 0, 2), IllegalCell);
+    ASSERT_THROWS(game.printViewport(os, GridPoint(1, 1), 2, -1), IllegalCell);
+    ASSERT_TEST(os.str().empty());
+    return true;
+}
+
+/** benchmarkFramesPerSecond: frames per second printed by operator<< and by the old new char[] + printGameBoard
+*                             path, to a stream that drops the output and to a file stream on /dev/null (where
+*                             each flush of printGameBoard's std::endl is a write)
+* */
+bool benchmarkFramesPerSecond()
+{
+    std::mt19937 rng(80);
+    DiscardBuffer discard;
+    std::ostream discard_stream(&discard);
+    std::ofstream null_stream("/dev/null");
+    std::ostream* const streams[] = {&discard_stream, &null_stream};
+    const char* const stream_names[] = {"discarding stream", "/dev/null"};
+    const int sizes[][2] = {{20, 20}, {100, 100}};
+    for (const int* size : sizes) {
+        PrintModel model(rng, size[0], size[1]);
+        const int frames = 2000000 / (size[0] * size[1]);
+        for (int s = 0; s < 2; s++) {
+            std::ostream& os = *streams[s];
+            if (!os) {
+                continue;
+            }
+            test::Timer new_timer;
+            for (int frame = 0; frame < frames; frame++) {
+                os << model.game;
+            }
+            const double new_seconds = new_timer.seconds();
+            test::Timer old_timer;
+            for (int frame = 0; frame < frames; frame++) {
+                printOldFrame(os, model);
+            }
+            const double old_seconds = old_timer.seconds();
+            ASSERT_TEST(os.good());
+            std::cout << "  " << size[0] << "x" << size[1] << " to " << stream_names[s] << ": reusable frame "
+                      << frames / new_seconds << " frames/s, new char[] + printGameBoard " << frames / old_seconds
+                      << " frames/s" << std::endl;
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    int failures = 0;
+    RUN_TEST(testPrintMatchesPrintGameBoard, failures);
+    RUN_TEST(testEmptyBoardPrint, failures);
+    RUN_TEST(testViewportMatchesPrint, failures);
+    RUN_TEST(testViewportOutsideTheBoardThrows, failures);
+    RUN_TEST(benchmarkFramesPerSecond, failures);
+    return failures;
+}
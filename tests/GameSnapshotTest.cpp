@@ -0,0 +1,244 @@
+#include "Game.h"
+#include "Serialization.h"
+#include "TestUtilities.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <random>
+#include <sstream>
+#include <utility>
+
+using namespace mtm;
+using serialization::putInt;
+using serialization::getSignedInt;
+
+namespace {
+    const std::size_t kHeaderSize = 24, kRecordSize = 32;
+    const char* const kSnapshotPath = "GameSnapshotTest.snapshot";
+
+    /* Unit: all the properties of a character, as a snapshot record holds them */
+    struct Unit {
+        int type, team, health, ammo, range, power, attacks_counter;
+        bool operator==(const Unit& other) const
+        {
+            return type == other.type && team == other.team && health == other.health && ammo == other.ammo &&
+                   range == other.range && power == other.power && attacks_counter == other.attacks_counter;
+        }
+    };
+    typedef std::map<std::pair<int, int>, Unit> Units;
+}
+
+static std::string snapshotOf(const Game& game)
+{
+    std::ostringstream os;
+    game.saveSnapshot(os);
+    return os.str();
+}
+
+/* decodeUnits:  returns the units of a snapshot by their cells (the records are decoded here, independently of
+                 Game::loadSnapshot) */
+static Units decodeUnits(const std::string& snapshot)
+{
+    Units units;
+    for (std::size_t position = kHeaderSize; position + kRecordSize <= snapshot.size(); position += kRecordSize) {
+        const char* record = snapshot.data() + position;
+        const Unit unit = {record[8], record[9], getSignedInt(record + 12), getSignedInt(record + 16),
+                           getSignedInt(record + 20), getSignedInt(record + 24), getSignedInt(record + 28)};
+        units[std::make_pair(getSignedInt(record), getSignedInt(record + 4))] = unit;
+    }
+    return units;
+}
+
+/* sameSnapshotGames:  checks everything that can be observed of two games: the board and the hash (test::sameGames),
+                       the result, the legal actions of both teams and the properties of every character (through
+                       their snapshots) */
+static bool sameSnapshotGames(const Game& first, const Game& second)
+{
+    Team first_winner = CPP, second_winner = CPP;
+    const bool first_over = first.isOver(&first_winner), second_over = second.isOver(&second_winner);
+    std::vector<Command> first_actions, second_actions;
+    for (Team team : {CPP, PYTHON}) {
+        first.legalActions(team, first_actions);
+        second.legalActions(team, second_actions);
+        if (first_actions.size() != second_actions.size() ||
+            !std::equal(first_actions.begin(), first_actions.end(), second_actions.begin(),
+                        [](const Command& a, const Command& b) {
+                            return a.type == b.type && a.src_row == b.src_row && a.src_col == b.src_col &&
+                                   a.dst_row == b.dst_row && a.dst_col == b.dst_col;
+                        })) {
+            return false;
+        }
+    }
+    return first.getHeight() == second.getHeight() && first.getWidth() == second.getWidth() &&
+           test::sameGames(first, second) &&
+           first_over == second_over && (!first_over || first_winner == second_winner) &&
+           decodeUnits(snapshotOf(first)) == decodeUnits(snapshotOf(second));
+}
+
+static void playRandomActions(Game& game, std::mt19937& rng, const int actions)
+{
+    const int height = game.getHeight(), width = game.getWidth();
+    for (int i = 0; i < actions; i++) {
+        const GridPoint source(rng() % height, rng() % width), target(rng() % height, rng() % width);
+        switch (rng() % 4) {
+            case 0:
+                game.tryMove(source, target);
+                break;
+            case 1:
+                game.tryReload(source);
+                break;
+            default:
+                game.tryAttack(source, target);
+        }
+    }
+}
+
+bool testSnapshotHoldsEveryProperty()
+{
+    std::mt19937 rng(11);
+    Game game(7, 9);
+    Units added;
+    for (int i = 0; i < 40; i++) {
+        const int row = rng() % 7, col = rng() % 9;
+        if (added.count(std::make_pair(row, col)) != 0) {
+            continue;
+        }
+        const Unit unit = {int(rng() % 3), int(rng() % 2), 1 + int(rng() % 20), int(rng() % 5), int(rng() % 8),
+                           int(rng() % 6), 0};
+        game.addCharacter(GridPoint(row, col), Game::makeCharacter(CharacterType(unit.type), Team(unit.team),
+                                                                   unit.health, unit.ammo, unit.range, unit.power));
+        added[std::make_pair(row, col)] = unit;
+    }
+    const std::string snapshot = snapshotOf(game);
+    ASSERT_TEST(snapshot.size() == kHeaderSize + added.size() * kRecordSize);
+    ASSERT_TEST(decodeUnits(snapshot) == added);
+    const Game loaded = Game::loadSnapshot(snapshot.data(), snapshot.size());
+    ASSERT_TEST(decodeUnits(snapshotOf(loaded)) == added);
+    ASSERT_TEST(snapshotOf(loaded) == snapshot);
+    ASSERT_TEST(sameSnapshotGames(loaded, game));
+    return true;
+}
+
+bool testRoundTripOfPlayedGames()
+{
+    for (unsigned seed = 1; seed < 100; seed++) {
+        std::mt19937 rng(seed);
+        const int height = 1 + rng() % 9, width = 1 + rng() % 9;
+        Game game(height, width);
+        for (int i = 0; i < height * width / 2; i++) {
+            try {
+                game.addCharacter(GridPoint(rng() % height, rng() % width),
+                                  Game::makeCharacter(CharacterType(rng() % 3), Team(rng() % 2), 1 + rng() % 15,
+                                                      rng() % 4, rng() % 8, rng() % 6));
+            } catch (const CellOccupied&) {}
+        }
+        playRandomActions(game, rng, 200);
+        const std::string snapshot = snapshotOf(game);
+        Game loaded = Game::loadSnapshot(snapshot.data(), snapshot.size());
+        ASSERT_TEST(sameSnapshotGames(loaded, game));
+        game.saveSnapshot(kSnapshotPath);
+        Game loaded_file = Game::loadSnapshotFile(kSnapshotPath);
+        ASSERT_TEST(sameSnapshotGames(loaded_file, game));
+        // the games go on the same way (the snipers continue their attack counters)
+        std::mt19937 game_rng(seed + 1000), loaded_rng(seed + 1000);
+        playRandomActions(game, game_rng, 200);
+        playRandomActions(loaded, loaded_rng, 200);
+        ASSERT_TEST(sameSnapshotGames(loaded, game));
+    }
+    std::remove(kSnapshotPath);
+    return true;
+}
+
+bool testInvalidSnapshots()
+{
+    Game game(4, 4);
+    game.addCharacter(GridPoint(1, 2), Game::makeCharacter(SNIPER, CPP, 5, 2, 3, 4));
+    game.addCharacter(GridPoint(3, 0), Game::makeCharacter(MEDIC, PYTHON, 5, 2, 3, 4));
+    const std::string snapshot = snapshotOf(game);
+    for (std::size_t size : {std::size_t(0), std::size_t(10), kHeaderSize, snapshot.size() - 1}) {
+        ASSERT_THROWS(Game::loadSnapshot(snapshot.data(), size), IllegalSnapshot);
+    }
+    // the magic, the version, the height, a record's row, type, team, health, and a second unit in one cell
+    const std::size_t offsets[] = {0, 4, 8, kHeaderSize, kHeaderSize + 8, kHeaderSize + 9, kHeaderSize + 12};
+    const std::uint32_t values[] = {0, 2, 0, 4, 3, 2, 0};
+    for (int i = 0; i < 7; i++) {
+        std::string corrupt = snapshot;
+        if (offsets[i] == kHeaderSize + 8 || offsets[i] == kHeaderSize + 9) {
+            corrupt[offsets[i]] = char(values[i]);
+        } else {
+            putInt(&corrupt[offsets[i]], values[i]);
+        }
+        ASSERT_THROWS(Game::loadSnapshot(corrupt.data(), corrupt.size()), IllegalSnapshot);
+    }
+    std::string duplicate = snapshot;
+    std::memcpy(&duplicate[kHeaderSize + kRecordSize], &duplicate[kHeaderSize], 8);
+    ASSERT_THROWS(Game::loadSnapshot(duplicate.data(), duplicate.size()), IllegalSnapshot);
+    ASSERT_THROWS(Game::loadSnapshotFile("no/such/directory/game.snapshot"), IllegalSnapshot);
+    ASSERT_THROWS(game.saveSnapshot("no/such/directory/game.snapshot"), IllegalSnapshot);
+    std::ostringstream bad_stream;
+    bad_stream.setstate(std::ios::badbit);
+    ASSERT_THROWS(game.saveSnapshot(bad_stream), IllegalSnapshot);
+    return true;
+}
+
+/* benchmarkLargeSnapshot:  saves and loads a game of 10M cells (3163 x 3163) with a unit in every tenth cell,
+                            to memory and to a file. The game is created from a snapshot built here (instead of
+                            adding its million units one by one) */
+bool benchmarkLargeSnapshot()
+{
+    const int kSide = 3163, kEvery = 10;
+    std::string built(kHeaderSize, '\0');
+    std::memcpy(&built[0], "MTMG", 4);
+    putInt(&built[4], 1);
+    putInt(&built[8], kSide);
+    putInt(&built[12], kSide);
+    std::uint32_t units = 0;
+    std::mt19937 rng(1);
+    for (int cell = 0; cell < kSide * kSide; cell += kEvery) {
+        char record[kRecordSize] = {0};
+        putInt(record, cell / kSide);
+        putInt(record + 4, cell % kSide);
+        record[8] = char(rng() % 3);
+        record[9] = char(rng() % 2);
+        putInt(record + 12, 1 + rng() % 10);
+        putInt(record + 16, rng() % 5);
+        putInt(record + 20, 1 + rng() % 6);
+        putInt(record + 24, 1 + rng() % 4);
+        built.append(record, kRecordSize);
+        units++;
+    }
+    putInt(&built[16], units);
+
+    const Game game = Game::loadSnapshot(built.data(), built.size());
+    test::Timer save_timer;
+    const std::string snapshot = snapshotOf(game);
+    const double save_seconds = save_timer.seconds();
+    ASSERT_TEST(snapshot == built);
+    test::Timer load_timer;
+    const Game loaded = Game::loadSnapshot(snapshot.data(), snapshot.size());
+    const double load_seconds = load_timer.seconds();
+    test::Timer save_file_timer;
+    game.saveSnapshot(kSnapshotPath);
+    const double save_file_seconds = save_file_timer.seconds();
+    test::Timer load_file_timer;
+    const Game loaded_file = Game::loadSnapshotFile(kSnapshotPath);
+    const double load_file_seconds = load_file_timer.seconds();
+    std::remove(kSnapshotPath);
+    ASSERT_TEST(loaded.getHash() == game.getHash() && loaded_file.getHash() == game.getHash());
+    std::cout << "  " << kSide * kSide << " cells, " << units << " units (" << snapshot.size() / (1024 * 1024)
+              << " MB): save " << save_seconds * 1000 << " ms, load " << load_seconds * 1000
+              << " ms, save to a file " << save_file_seconds * 1000 << " ms, load from a file "
+              << load_file_seconds * 1000 << " ms" << std::endl;
+    return true;
+}
+
+int main()
+{
+    int failures = 0;
+    RUN_TEST(testSnapshotHoldsEveryProperty, failures);
+    RUN_TEST(testRoundTripOfPlayedGames, failures);
+    RUN_TEST(testInvalidSnapshots, failures);
+    RUN_TEST(benchmarkLargeSnapshot, failures);
+    return failures;
+}
@@ -0,0 +1,307 @@
+#include "Game.h"
+#include "TestUtilities.h"
+#include <random>
+#include <string>
+#include <vector>
+
+/* allocations: the number of calls to operator new, to check that a rejected action allocates nothing */
+static long allocations = 0;
+
+void* operator new(std::size_t size)
+{
+    ++allocations;
+    if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+using namespace mtm;
+using test::gameState;
+using test::sameGames;
+
+namespace {
+    /* kStatusNames: the name of the exception the throwing API throws for each ActionStatus */
+    const char* const kStatusNames[] = {"", "IllegalCell", "CellEmpty", "MoveTooFar", "CellOccupied", "OutOfRange",
+                                        "OutOfAmmo", "IllegalTarget"};
+    const int kStatuses = sizeof(kStatusNames) / sizeof(kStatusNames[0]);
+
+    Game randomGame(std::mt19937& rng, const int height, const int width)
+    {
+        Game game(height, width);
+        for (int i = 0; i < height * width / 2; i++) {
+            try {
+                game.addCharacter(GridPoint(rng() % height, rng() % width),
+                                  Game::makeCharacter(CharacterType(rng() % 3), Team(rng() % 2), 1 + rng() % 15,
+                                                      rng() % 4, rng() % 8, rng() % 6));
+            } catch (const CellOccupied&) {}
+        }
+        return game;
+    }
+
+    /* randomCommand:  a random action whose source may be just outside the board */
+    Command randomCommand(std::mt19937& rng, const int height, const int width)
+    {
+        const Command command = {CommandType(rng() % 3), int(rng() % (height + 1)) - 1 + int(rng() % 2),
+                                 int(rng() % (width + 1)) - int(rng() % 2), int(rng() % height),
+                                 int(rng() % width)};
+        return command;
+    }
+
+    /* throwingAction:  performs the command with move, attack or reload and returns the name of the exception it
+                        threw ("" if it didn't throw) */
+    std::string throwingAction(Game& game, const Command& command)
+    {
+        const GridPoint source(command.src_row, command.src_col), target(command.dst_row, command.dst_col);
+        try {
+            if (command.type == MOVE) {
+                game.move(source, target);
+            } else if (command.type == ATTACK) {
+                game.attack(source, target);
+            } else {
+                game.reload(source);
+            }
+        } catch (const GameException& e) {
+            const std::string what = e.what();
+            return what.substr(what.rfind(' ') + 1);
+        }
+        return "";
+    }
+
+    ActionStatus statusAction(Game& game, const Command& command)
+    {
+        const GridPoint source(command.src_row, command.src_col), target(command.dst_row, command.dst_col);
+        if (command.type == MOVE) {
+            return game.tryMove(source, target);
+        }
+        return command.type == ATTACK ? game.tryAttack(source, target) : game.tryReload(source);
+    }
+}
+
+bool testStatusesMatchExceptions()
+{
+    int seen[kStatuses] = {0};
+    for (unsigned seed = 1; seed < 300; seed++) {
+        std::mt19937 rng(seed);
+        const int height = 1 + rng() % 12, width = 1 + rng() % 12;
+        Game throwing = randomGame(rng, height, width);
+        Game with_status = throwing.clone();
+        Game batched = throwing.clone();
+        for (int i = 0; i < 400; i++) {
+            const Command command = randomCommand(rng, height, width);
+            const std::string exception = throwingAction(throwing, command);
+            const ActionStatus status = statusAction(with_status, command);
+            ActionStatus batch_status;
+            batched.applyBatch(&command, 1, &batch_status);
+            ASSERT_TEST(status >= SUCCESS && status < kStatuses);
+            ASSERT_TEST(exception == kStatusNames[status] && batch_status == status);
+            ASSERT_TEST(sameGames(with_status, throwing) && sameGames(batched, throwing));
+            seen[status]++;
+        }
+    }
+    for (int status = 0; status < kStatuses; status++) {
+        ASSERT_TEST(seen[status] > 0);
+    }
+    return true;
+}
+
+/* testMixedBatchMatchesSingleActions:  a batch with illegal commands in the middle runs every command after them:
+                                        each results[i] is the status of the same action performed alone, and the
+                                        game ends as after the single actions */
+bool testMixedBatchMatchesSingleActions()
+{
+    int illegal_then_legal = 0;
+    for (unsigned seed = 1; seed < 100; seed++) {
+        std::mt19937 rng(seed);
+        const int height = 2 + rng() % 10, width = 2 + rng() % 10;
+        Game single = randomGame(rng, height, width);
+        Game batched = single.clone();
+        std::vector<Command> commands;
+        for (int i = 0; i < 200; i++) {
+            commands.push_back(randomCommand(rng, height, width));
+        }
+        std::vector<ActionStatus> results(commands.size(), ActionStatus(-1));
+        bool failed_before = false;
+        for (std::size_t i = 0; i < commands.size(); i++) {
+            const ActionStatus status = statusAction(single, commands[i]);
+            illegal_then_legal += failed_before && status == SUCCESS ? 1 : 0;
+            failed_before = failed_before || status != SUCCESS;
+            results[i] = status;
+        }
+        std::vector<ActionStatus> batch_results(commands.size(), ActionStatus(-1));
+        Team single_winner = CPP, batch_winner = CPP;
+        const bool single_over = single.isOver(&single_winner);
+        ASSERT_TEST(batched.applyBatch(commands.data(), int(commands.size()), batch_results.data(), &batch_winner) ==
+                    single_over);
+        ASSERT_TEST(!single_over || batch_winner == single_winner);
+        ASSERT_TEST(batch_results == results);
+        ASSERT_TEST(sameGames(batched, single));
+    }
+    ASSERT_TEST(illegal_then_legal > 1000);
+    return true;
+}
+
+/* testBatchStatusesAndGameOver:  the statuses of a batch whose illegal commands come between legal ones, and the
+                                  result of the final isOver: not over (and the winner untouched) before the last
+                                  enemy dies, over with the winner once it does */
+bool testBatchStatusesAndGameOver()
+{
+    Game game(5, 5);
+    game.addCharacter(GridPoint(0, 0), Game::makeCharacter(SOLDIER, CPP, 5, 1, 3, 10));
+    game.addCharacter(GridPoint(0, 2), Game::makeCharacter(MEDIC, PYTHON, 3, 2, 2, 1));
+    game.addCharacter(GridPoint(2, 0), Game::makeCharacter(SNIPER, PYTHON, 2, 2, 4, 1));
+    const Command first[] = {{ATTACK, 0, 0, 0, 2}, {MOVE, 9, 9, 0, 0}, {MOVE, 0, 2, 0, 3}, {ATTACK, 0, 0, 2, 0},
+                             {RELOAD, 0, 0, 0, 0}, {MOVE, 0, 0, 3, 3}};
+    const ActionStatus first_expected[] = {SUCCESS, ILLEGAL_CELL, CELL_EMPTY, OUT_OF_AMMO, SUCCESS, MOVE_TOO_FAR};
+    ActionStatus results[6];
+    Team winner = PYTHON;
+    ASSERT_TEST(!game.applyBatch(first, 6, results, &winner) && winner == PYTHON);
+    for (int i = 0; i < 6; i++) {
+        ASSERT_TEST(results[i] == first_expected[i]);
+    }
+    const Command second[] = {{ATTACK, 0, 0, 2, 0}, {ATTACK, 0, 0, 1, 1}, {MOVE, 0, 0, 1, 0}};
+    const ActionStatus second_expected[] = {SUCCESS, ILLEGAL_TARGET, SUCCESS};
+    ASSERT_TEST(game.applyBatch(second, 3, results, &winner) && winner == CPP);
+    for (int i = 0; i < 3; i++) {
+        ASSERT_TEST(results[i] == second_expected[i]);
+    }
+    // an empty batch returns isOver of the game as it is
+    winner = PYTHON;
+    ASSERT_TEST(game.applyBatch(second, 0, results, &winner) && winner == CPP);
+    ASSERT_TEST(game.applyBatch(second, 0, results));
+    return true;
+}
+
+bool testThrowIfFailed()
+{
+    throwIfFailed(SUCCESS);
+    ASSERT_THROWS(throwIfFailed(ILLEGAL_CELL), IllegalCell);
+    ASSERT_THROWS(throwIfFailed(CELL_EMPTY), CellEmpty);
+    ASSERT_THROWS(throwIfFailed(MOVE_TOO_FAR), MoveTooFar);
+    ASSERT_THROWS(throwIfFailed(CELL_OCCUPIED), CellOccupied);
+    ASSERT_THROWS(throwIfFailed(OUT_OF_RANGE), OutOfRange);
+    ASSERT_THROWS(throwIfFailed(OUT_OF_AMMO), OutOfAmmo);
+    ASSERT_THROWS(throwIfFailed(ILLEGAL_TARGET), IllegalTarget);
+    return true;
+}
+
+/* testRejectedActionsChangeNothing:  a rejected action leaves the game as it was, allocates nothing, and doesn't
+                                      copy a board it shares with a copy of the game */
+bool testRejectedActionsChangeNothing()
+{
+    std::mt19937 rng(17);
+    const Game original = randomGame(rng, 10, 10);
+    const std::string original_state = gameState(original);
+    int rejected = 0;
+    for (int i = 0; i < 5000; i++) {
+        Game game = original;
+        const Command command = randomCommand(rng, 10, 10);
+        const long allocations_before = allocations;
+        const ActionStatus status = statusAction(game, command);
+        if (status == SUCCESS) {
+            continue;
+        }
+        ASSERT_TEST(allocations == allocations_before);
+        ASSERT_TEST(gameState(game) == original_state);
+        rejected++;
+    }
+    ASSERT_TEST(gameState(original) == original_state);
+    ASSERT_TEST(rejected > 1000);
+    return true;
+}
+
+/* benchmarkRejectedActions:  the rate of rejected (illegal) actions through the throwing API, which constructs and
+                              catches an exception for each, and through the status API */
+bool benchmarkRejectedActions()
+{
+    std::mt19937 rng(23);
+    Game game = randomGame(rng, 20, 20);
+    std::vector<Command> illegal;
+    while (illegal.size() < 20000) {
+        const Command command = randomCommand(rng, 20, 20);
+        Game probe = game;
+        if (statusAction(probe, command) != SUCCESS) {
+            illegal.push_back(command);
+        }
+    }
+    const int kRounds = 10;
+    test::Timer throwing_timer;
+    int thrown = 0;
+    for (int round = 0; round < kRounds; round++) {
+        for (const Command& command : illegal) {
+            thrown += throwingAction(game, command).empty() ? 0 : 1;
+        }
+    }
+    const double throwing_seconds = throwing_timer.seconds();
+    test::Timer status_timer;
+    int failed = 0;
+    for (int round = 0; round < kRounds; round++) {
+        for (const Command& command : illegal) {
+            failed += statusAction(game, command) == SUCCESS ? 0 : 1;
+        }
+    }
+    const double status_seconds = status_timer.seconds();
+    ASSERT_TEST(thrown == kRounds * int(illegal.size()) && failed == thrown);
+    std::cout << "  rejected actions: " << thrown / throwing_seconds << " /s with exceptions, "
+              << failed / status_seconds << " /s with statuses" << std::endl;
+    return true;
+}
+
+/* benchmarkBatch:  the rate of a mix of legal and illegal commands performed one call at a time with move, attack
+                    and reload (catching the exceptions of the illegal ones), one call at a time with tryMove,
+                    tryAttack and tryReload, and as one applyBatch; each on its own copy of the same game */
+bool benchmarkBatch()
+{
+    std::mt19937 rng(29);
+    const Game game = randomGame(rng, 30, 30);
+    std::vector<Command> commands;
+    for (int i = 0; i < 200000; i++) {
+        commands.push_back(randomCommand(rng, 30, 30));
+    }
+    Game throwing = game.clone(), single = game.clone(), batched = game.clone();
+    test::Timer throwing_timer;
+    int throwing_successes = 0;
+    for (const Command& command : commands) {
+        throwing_successes += throwingAction(throwing, command).empty() ? 1 : 0;
+    }
+    const double throwing_seconds = throwing_timer.seconds();
+    test::Timer single_timer;
+    int single_successes = 0;
+    for (const Command& command : commands) {
+        single_successes += statusAction(single, command) == SUCCESS ? 1 : 0;
+    }
+    const double single_seconds = single_timer.seconds();
+    std::vector<ActionStatus> results(commands.size());
+    test::Timer batch_timer;
+    batched.applyBatch(commands.data(), int(commands.size()), results.data());
+    const double batch_seconds = batch_timer.seconds();
+    int batch_successes = 0;
+    for (const ActionStatus status : results) {
+        batch_successes += status == SUCCESS ? 1 : 0;
+    }
+    ASSERT_TEST(batch_successes == single_successes && throwing_successes == single_successes);
+    ASSERT_TEST(sameGames(batched, single) && sameGames(throwing, single));
+    std::cout << "  " << commands.size() << " commands (" << single_successes << " legal): "
+              << commands.size() / throwing_seconds << " /s with move/attack/reload, "
+              << commands.size() / single_seconds << " /s with tryMove/tryAttack/tryReload, "
+              << commands.size() / batch_seconds << " /s with applyBatch" << std::endl;
+    return true;
+}
+
+int main()
+{
+    int failures = 0;
+    RUN_TEST(testStatusesMatchExceptions, failures);
+    RUN_TEST(testMixedBatchMatchesSingleActions, failures);
+    RUN_TEST(testBatchStatusesAndGameOver, failures);
+    RUN_TEST(testThrowIfFailed, failures);
+    RUN_TEST(testRejectedActionsChangeNothing, failures);
+    RUN_TEST(benchmarkRejectedActions, failures);
+    RUN_TEST(benchmarkBatch, failures);
+    return failures;
+}
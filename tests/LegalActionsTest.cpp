@@ -0,0 +1,193 @@
+#include "Game.h"
+#include "TestUtilities.h"
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace mtm;
+
+namespace {
+    /* ActionKey: a command as a comparable tuple (a reload has no destination) */
+    typedef std::tuple<int, int, int, int, int> ActionKey;
+
+    ActionKey actionKey(const Command& command)
+    {
+        const bool reload = command.type == RELOAD;
+        return ActionKey(command.type, command.src_row, command.src_col, reload ? 0 : command.dst_row,
+                         reload ? 0 : command.dst_col);
+    }
+
+    Game randomGame(std::mt19937& rng, const int height, const int width, const int characters, const int max_range)
+    {
+        Game game(height, width);
+        for (int i = 0; i < characters; i++) {
+            try {
+                game.addCharacter(GridPoint(rng() % height, rng() % width),
+                                  Game::makeCharacter(CharacterType(rng() % 3), Team(rng() % 2), 1 + rng() % 15,
+                                                      rng() % 3, rng() % max_range, rng() % 6));
+            } catch (const CellOccupied&) {}
+        }
+        return game;
+    }
+
+    ActionStatus tryCommand(Game& game, const Command& command)
+    {
+        const GridPoint source(command.src_row, command.src_col), target(command.dst_row, command.dst_col);
+        if (command.type == MOVE) {
+            return game.tryMove(source, target);
+        }
+        return command.type == ATTACK ? game.tryAttack(source, target) : game.tryReload(source);
+    }
+
+    /* bruteForceActions:  the legal actions of each team, found by trying every move, attack and reload from every
+                           cell to every cell on a copy of the game (the team of a unit is read from its printed
+                           char: the PYTHON team's are lower case) */
+    void bruteForceActions(const Game& game, const int height, const int width, std::set<ActionKey> actions[2])
+    {
+        std::ostringstream os;
+        os << game;
+        const std::string printed = os.str();
+        for (int row = 0; row < height; row++) {
+            for (int col = 0; col < width; col++) {
+                const char unit = printed[(2 * width + 2) * (row + 1) + 1 + 2 * col];
+                for (int type = MOVE; type <= RELOAD; type++) {
+                    for (int target = 0; target < (type == RELOAD ? 1 : height * width); target++) {
+                        const Command command = {CommandType(type), row, col, target / width, target % width};
+                        Game copy = game;
+                        if (tryCommand(copy, command) == SUCCESS) {
+                            actions[unit >= 'a' ? PYTHON : CPP].insert(actionKey(command));
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /* randomActions:  performs random commands, to test the actions of the games that follow */
+    void randomActions(std::mt19937& rng, Game& game, const int height, const int width, const int count)
+    {
+        for (int i = 0; i < count; i++) {
+            const Command command = {CommandType(rng() % 3), int(rng() % height), int(rng() % width),
+                                     int(rng() % height), int(rng() % width)};
+            tryCommand(game, command);
+        }
+    }
+}
+
+/** testEveryActionSucceeds: each action legalActions generates, of a team or of a cell, succeeds when performed
+*                            on a copy of the game, and appears once
+* */
+bool testEveryActionSucceeds()
+{
+    int performed = 0;
+    for (unsigned seed = 1; seed < 100; seed++) {
+        std::mt19937 rng(seed);
+        const int height = 1 + rng() % 15, width = 1 + rng() % 15;
+        Game game = randomGame(rng, height, width, height * width / 2, 14);
+        for (int step = 0; step < 4; step++) {
+            std::vector<Command> actions(3, Command());
+            int generated = game.legalActions(CPP, actions);
+            generated += game.legalActions(PYTHON, actions);
+            ASSERT_TEST(generated == int(actions.size()) - 3);
+            std::set<ActionKey> distinct;
+            for (std::size_t i = 3; i < actions.size(); i++) {
+                Game copy = game;
+                ASSERT_TEST(tryCommand(copy, actions[i]) == SUCCESS);
+                distinct.insert(actionKey(actions[i]));
+                performed++;
+            }
+            ASSERT_TEST(int(distinct.size()) == generated);
+            std::vector<Command> unit_actions;
+            for (int row = 0; row < height; row++) {
+                for (int col = 0; col < width; col++) {
+                    const int before = int(unit_actions.size());
+                    ASSERT_TEST(game.legalActions(GridPoint(row, col), unit_actions) ==
+                                int(unit_actions.size()) - before);
+                }
+            }
+            ASSERT_TEST(int(unit_actions.size()) == generated);
+            randomActions(rng, game, height, width, 20);
+        }
+    }
+    ASSERT_TEST(performed > 10000);
+    return true;
+}
+
+/** testNoLegalActionIsMissing: the actions of each team are exactly the commands that succeed when every move,
+*                               attack and reload over all cells is tried; illegal and empty cells have none
+* */
+bool testNoLegalActionIsMissing()
+{
+    for (unsigned seed = 1; seed < 60; seed++) {
+        std::mt19937 rng(seed);
+        const int height = 1 + rng() % 9, width = 1 + rng() % 9;
+        Game game = randomGame(rng, height, width, height * width / 2, 12);
+        for (int step = 0; step < 3; step++) {
+            std::set<ActionKey> expected[2];
+            bruteForceActions(game, height, width, expected);
+            for (int team = CPP; team <= PYTHON; team++) {
+                std::vector<Command> actions;
+                game.legalActions(Team(team), actions);
+                std::set<ActionKey> generated;
+                for (const Command& command : actions) {
+                    generated.insert(actionKey(command));
+                }
+                ASSERT_TEST(generated == expected[team]);
+            }
+            std::vector<Command> actions;
+            ASSERT_TEST(game.legalActions(GridPoint(-1, 0), actions) == 0);
+            ASSERT_TEST(game.legalActions(GridPoint(0, width), actions) == 0);
+            ASSERT_TEST(game.legalActions(GridPoint(height, 0), actions) == 0);
+            ASSERT_TEST(actions.empty());
+            randomActions(rng, game, height, width, 20);
+        }
+    }
+    std::vector<Command> actions;
+    ASSERT_TEST(Game(4, 4).legalActions(GridPoint(1, 1), actions) == 0 && actions.empty());
+    return true;
+}
+
+/** benchmarkLegalActions: actions per second generated by legalActions for both teams of a crowded and of a sparse
+*                          board, reusing the vector, and found by trying every command on a copy of a small board
+* */
+bool benchmarkLegalActions()
+{
+    std::mt19937 rng(7);
+    const int sizes[][3] = {{200, 200, 24000}, {200, 200, 2000}, {20, 20, 200}};
+    std::vector<Command> actions;
+    for (const int* size : sizes) {
+        const Game game = randomGame(rng, size[0], size[1], size[2], 12);
+        const int kRounds = 20;
+        long long generated = 0;
+        test::Timer timer;
+        for (int round = 0; round < kRounds; round++) {
+            actions.clear();
+            generated += game.legalActions(Team(round % 2), actions);
+        }
+        const double seconds = timer.seconds();
+        ASSERT_TEST(generated > 0);
+        std::cout << "  legalActions on " << size[0] << "x" << size[1] << " with " << size[2] << " characters: "
+                  << generated / seconds / 1e6 << " M actions/s" << std::endl;
+    }
+    const Game small = randomGame(rng, 20, 20, 200, 12);
+    std::set<ActionKey> expected[2];
+    test::Timer brute_timer;
+    bruteForceActions(small, 20, 20, expected);
+    const double brute_seconds = brute_timer.seconds();
+    std::cout << "  trying every command on 20x20 with 200 characters: "
+              << (expected[CPP].size() + expected[PYTHON].size()) / brute_seconds / 1e6 << " M actions/s"
+              << std::endl;
+    return true;
+}
+
+int main()
+{
+    int failures = 0;
+    RUN_TEST(testEveryActionSucceeds, failures);
+    RUN_TEST(testNoLegalActionIsMissing, failures);
+    RUN_TEST(benchmarkLegalActions, failures);
+    return failures;
+}
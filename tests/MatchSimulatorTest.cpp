@@ -0,0 +1,140 @@
+#include "MatchSimulator.h"
+#include "TestUtilities.h"
+#include <atomic>
+#include <dirent.h>
+#include <stdexcept>
+
+using namespace mtm;
+
+static Game startingGame()
+{
+    Game game(3, 3);
+    game.addCharacter(GridPoint(0, 0), Game::makeCharacter(SOLDIER, CPP, 10, 3, 4, 3));
+    game.addCharacter(GridPoint(1, 1), Game::makeCharacter(SNIPER, CPP, 8, 3, 5, 4));
+    game.addCharacter(GridPoint(2, 2), Game::makeCharacter(SOLDIER, PYTHON, 10, 3, 4, 3));
+    game.addCharacter(GridPoint(2, 1), Game::makeCharacter(MEDIC, PYTHON, 8, 3, 3, 2));
+    return game;
+}
+
+static bool sameResults(const SimulationResult& first, const SimulationResult& second)
+{
+    return first.playouts == second.playouts && first.wins[CPP] == second.wins[CPP] &&
+           first.wins[PYTHON] == second.wins[PYTHON] && first.actions == second.actions &&
+           first.illegal_actions == second.illegal_actions;
+}
+
+/* countThreads:  returns the number of threads of the process, or -1 where /proc isn't available */
+static int countThreads()
+{
+    DIR* tasks = opendir("/proc/self/task");
+    if (tasks == nullptr) {
+        return -1;
+    }
+    int threads = 0;
+    while (dirent* entry = readdir(tasks)) {
+        threads += entry->d_name[0] == '.' ? 0 : 1;
+    }
+    closedir(tasks);
+    return threads;
+}
+
+/* ThrowingPolicy: a random policy that throws on its calls_before_throw + 1th call (counted across threads) */
+class ThrowingPolicy : public PlayoutPolicy {
+    mutable std::atomic<int> calls;
+    const int calls_before_throw;
+    public:
+        explicit ThrowingPolicy(const int calls_before_throw) : calls(0), calls_before_throw(calls_before_throw) {}
+
+        Command nextCommand(const Game& game, std::mt19937& rng) const override
+        {
+            if (calls++ == calls_before_throw) {
+                throw std::runtime_error("policy failed");
+            }
+            return RandomPolicy().nextCommand(game, rng);
+        }
+};
+
+bool testResultsDontDependOnThreads()
+{
+    const Game start = startingGame();
+    RandomPolicy policy;
+    const SimulationResult expected = simulate(start, policy, 42, 1000, 1, 300);
+    ASSERT_TEST(expected.playouts == 1000);
+    ASSERT_TEST(expected.wins[CPP] + expected.wins[PYTHON] <= 1000);
+    ASSERT_TEST(expected.wins[CPP] > 0 && expected.wins[PYTHON] > 0);
+    ASSERT_TEST(expected.illegal_actions <= expected.actions);
+    for (int threads : {2, 3, 8, 0}) {
+        ASSERT_TEST(sameResults(simulate(start, policy, 42, 1000, threads, 300), expected));
+    }
+    ThreadPoolExecutor pool(2);
+    ASSERT_TEST(sameResults(simulate(start, policy, 42, 1000, pool, 300), expected));
+    ASSERT_TEST(sameResults(simulate(start, policy, 42, 1000, sequentialExecutor(), 300), expected));
+    ASSERT_TEST(!sameResults(simulate(start, policy, 43, 1000, 2, 300), expected));
+    ASSERT_TEST(start.getHash() == startingGame().getHash());
+    return true;
+}
+
+bool testSimulationsReuseTheirThreads()
+{
+    const Game start = startingGame();
+    RandomPolicy policy;
+    const int threads_before = countThreads();
+    const SimulationResult expected = simulate(start, policy, 7, 200, 5, 100);
+    const int threads_after = countThreads();
+    if (threads_before >= 0) {
+        ASSERT_TEST(threads_after == threads_before + 4);
+    }
+    for (int i = 0; i < 20; i++) {
+        ASSERT_TEST(sameResults(simulate(start, policy, 7, 200, 5, 100), expected));
+        ASSERT_TEST(countThreads() == threads_after);
+    }
+    return true;
+}
+
+bool testPolicyExceptionIsRethrown()
+{
+    const Game start = startingGame();
+    for (int threads : {1, 4}) {
+        ThrowingPolicy policy(500);
+        ASSERT_THROWS(simulate(start, policy, 1, 1000, threads, 300), std::runtime_error);
+    }
+    RandomPolicy policy;
+    ASSERT_TEST(sameResults(simulate(start, policy, 3, 100, 4, 300), simulate(start, policy, 3, 100, 1, 300)));
+    return true;
+}
+
+bool testIllegalArguments()
+{
+    const Game start = startingGame();
+    RandomPolicy policy;
+    ASSERT_THROWS(simulate(start, policy, 1, -1), IllegalArgument);
+    ASSERT_THROWS(simulate(start, policy, 1, 10, -1), IllegalArgument);
+    ASSERT_THROWS(simulate(start, policy, 1, 10, 1, -1), IllegalArgument);
+    const SimulationResult empty = simulate(start, policy, 1, 0, 4);
+    ASSERT_TEST(empty.playouts == 0 && empty.actions == 0 && empty.winRate(CPP) == 0);
+    return true;
+}
+
+bool benchmarkSimulation()
+{
+    const Game start = startingGame();
+    RandomPolicy policy;
+    for (int threads : {1, 0}) {
+        const SimulationResult result = simulate(start, policy, 42, 20000, threads, 300);
+        std::cout << "  " << (threads == 0 ? "hardware threads" : "1 thread") << ": "
+                  << result.playoutsPerSecond() << " playouts/s, " << result.actionsPerSecond() << " actions/s"
+                  << std::endl;
+    }
+    return true;
+}
+
+int main()
+{
+    int failures = 0;
+    RUN_TEST(testResultsDontDependOnThreads, failures);
+    RUN_TEST(testSimulationsReuseTheirThreads, failures);
+    RUN_TEST(testPolicyExceptionIsRethrown, failures);
+    RUN_TEST(testIllegalArguments, failures);
+    RUN_TEST(benchmarkSimulation, failures);
+    return failures;
+}
@@ -0,0 +1,260 @@
+#include "Matrix.h"
+#include "MatrixExecution.h"
+#include "TestUtilities.h"
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <vector>
+
+using namespace mtm;
+
+namespace {
+    /** Bytes - the reference layout the packed Matrix<bool> is checked (and timed) against: a byte per entry
+    * */
+    typedef std::vector<unsigned char> Bytes;
+
+    const int kSizes[][2] = {{1, 1}, {1, 63}, {1, 64}, {1, 65}, {2, 32}, {3, 43}, {8, 8}, {5, 13}, {64, 3},
+                             {7, 128}, {13, 77}};
+
+    struct Not {
+        bool operator()(const bool value) const { return !value; }
+    };
+
+    Matrix<int> randomMatrix(std::mt19937& rng, const int height, const int width, const int values)
+    {
+        Matrix<int> matrix(Dimensions(height, width));
+        for (int& element : matrix) {
+            element = int(rng() % values);
+        }
+        return matrix;
+    }
+
+    template <class Predicate>
+    Bytes bytesOf(const Matrix<int>& matrix, Predicate predicate)
+    {
+        Bytes bytes;
+        for (const int element : matrix) {
+            bytes.push_back(predicate(element) ? 1 : 0);
+        }
+        return bytes;
+    }
+
+    bool sameEntries(const Matrix<bool>& matrix, const Bytes& bytes)
+    {
+        if (std::size_t(matrix.size()) != bytes.size()) {
+            return false;
+        }
+        for (int i = 0; i < matrix.height(); i++) {
+            for (int j = 0; j < matrix.width(); j++) {
+                if (matrix(i, j) != (bytes[i * matrix.width() + j] != 0)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+}
+
+bool testComparisonsPackEveryEntry()
+{
+    std::mt19937 rng(3);
+    for (const int* size : kSizes) {
+        const Matrix<int> matrix = randomMatrix(rng, size[0], size[1], 4);
+        ASSERT_TEST(sameEntries(matrix < 2, bytesOf(matrix, [](int x) { return x < 2; })));
+        ASSERT_TEST(sameEntries(matrix <= 2, bytesOf(matrix, [](int x) { return x <= 2; })));
+        ASSERT_TEST(sameEntries(matrix > 2, bytesOf(matrix, [](int x) { return x > 2; })));
+        ASSERT_TEST(sameEntries(matrix >= 2, bytesOf(matrix, [](int x) { return x >= 2; })));
+        ASSERT_TEST(sameEntries(matrix == 2, bytesOf(matrix, [](int x) { return x == 2; })));
+        ASSERT_TEST(sameEntries(matrix != 2, bytesOf(matrix, [](int x) { return x != 2; })));
+        const Matrix<bool> evaluated = (matrix + 1) < 2;
+        ASSERT_TEST(sameEntries(evaluated, bytesOf(matrix, [](int x) { return x + 1 < 2; })));
+    }
+    return true;
+}
+
+bool testWordOperations()
+{
+    std::mt19937 rng(5);
+    for (const int* size : kSizes) {
+        for (int repeat = 0; repeat < 8; repeat++) {
+            const int height = size[0], width = size[1];
+            const Matrix<int> first = randomMatrix(rng, height, width, 3);
+            const Matrix<int> second = randomMatrix(rng, height, width, repeat % 4 + 1);
+            const Matrix<bool> x = first < 1, y = second == 0;
+            const Bytes x_bytes = bytesOf(first, [](int v) { return v < 1; });
+            const Bytes y_bytes = bytesOf(second, [](int v) { return v == 0; });
+            Bytes or_bytes, xor_bytes;
+            bool all_y = true, any_y = false;
+            for (std::size_t i = 0; i < x_bytes.size(); i++) {
+                or_bytes.push_back(x_bytes[i] | y_bytes[i]);
+                xor_bytes.push_back(x_bytes[i] ^ y_bytes[i]);
+                all_y = all_y && y_bytes[i];
+                any_y = any_y || y_bytes[i];
+            }
+            ASSERT_TEST(sameEntries(x + y, or_bytes));
+            ASSERT_TEST(sameEntries(x - y, xor_bytes));
+            ASSERT_TEST(sameEntries(-y, y_bytes));
+            ASSERT_TEST(all(y) == all_y && any(y) == any_y);
+            ASSERT_TEST(all(y) == all(second == 0) && any(y) == any(second == 0));
+            ASSERT_TEST(all(y.apply(Not()) - y));
+            ASSERT_TEST(y.countIf([](bool value) { return value; }) == std::count(y_bytes.begin(), y_bytes.end(), 1));
+
+            Matrix<bool> transposed = y.transpose();
+            Matrix<bool> in_place = y;
+            in_place.transposeInPlace();
+            ASSERT_TEST(transposed.height() == width && transposed.width() == height);
+            ASSERT_TEST(!any(transposed - in_place));
+            for (int i = 0; i < height; i++) {
+                for (int j = 0; j < width; j++) {
+                    ASSERT_TEST(transposed(j, i) == y(i, j));
+                }
+            }
+            Matrix<bool> filled = y;
+            filled += true;
+            ASSERT_TEST(all(filled));
+            filled += false;
+            ASSERT_TEST(all(filled));
+        }
+    }
+    return true;
+}
+
+bool testPaddingBitsStayClear()
+{
+    for (const int* size : kSizes) {
+        const Dimensions dimensions(size[0], size[1]);
+        Matrix<bool> full(dimensions, true);
+        ASSERT_TEST(all(full) && any(full));
+        ASSERT_TEST(full.countIf([](bool value) { return value; }) == full.size());
+        full(size[0] - 1, size[1] - 1) = false;
+        ASSERT_TEST(!all(full) && any(full) == (full.size() > 1));
+        Matrix<bool> empty(dimensions);
+        ASSERT_TEST(!any(empty));
+        ASSERT_TEST(all(empty.apply(Not())));
+        ASSERT_TEST(all(empty.applyInPlace(Not())));
+        ASSERT_TEST(all(-empty) && all(empty + empty));
+        Matrix<bool> transposed = empty;
+        transposed.transposeInPlace();
+        ASSERT_TEST(all(transposed) && transposed.countIf([](bool value) { return value; }) == full.size());
+    }
+    return true;
+}
+
+bool testProxies()
+{
+    Matrix<bool> matrix(Dimensions(3, 70));
+    matrix(0, 0) = true;
+    matrix(2, 69) = matrix(0, 0);
+    ASSERT_TEST(matrix(2, 69) && matrix(0, 0) && !matrix(1, 5));
+    Matrix<bool>::reference reference = matrix(1, 5);
+    reference = true;
+    ASSERT_TEST(matrix(1, 5) && bool(reference));
+    reference = false;
+    ASSERT_TEST(!matrix(1, 5));
+    matrix.atUnchecked(1, 6) = true;
+    ASSERT_TEST(matrix.atUnchecked(1, 6) && matrix.element(76));
+
+    int count = 0;
+    for (Matrix<bool>::iterator it = matrix.begin(); it != matrix.end(); ++it) {
+        *it = !*it;
+        count++;
+    }
+    ASSERT_TEST(count == 210);
+    const Matrix<bool>& const_matrix = matrix;
+    int set = 0;
+    for (Matrix<bool>::const_iterator it = const_matrix.begin(); it != const_matrix.end(); ++it) {
+        set += *it ? 1 : 0;
+    }
+    ASSERT_TEST(set == 210 - 3);
+    ASSERT_THROWS(matrix(3, 0), Matrix<bool>::AccessIllegalElement);
+    ASSERT_THROWS(matrix(0, -1) = true, Matrix<bool>::AccessIllegalElement);
+    ASSERT_THROWS(*matrix.end(), Matrix<bool>::AccessIllegalElement);
+    ASSERT_THROWS(matrix + Matrix<bool>(Dimensions(70, 3)), Matrix<bool>::DimensionMismatch);
+    ASSERT_THROWS(Matrix<bool>(Dimensions(0, 3)), Matrix<bool>::IllegalInitialization);
+
+    const Matrix<bool> diagonal = Matrix<bool>::Diagonal(70, true);
+    ASSERT_TEST(diagonal.countIf([](bool value) { return value; }) == 70 && diagonal(69, 69) && !diagonal(0, 1));
+    Matrix<bool> moved(std::move(matrix));
+    ASSERT_TEST(moved.size() == 210 && !moved(1, 6) && matrix.size() == 0);
+    return true;
+}
+
+bool testParallelWordChunks()
+{
+    std::mt19937 rng(8);
+    ThreadPoolExecutor pool(3);
+    const Matrix<int> values = randomMatrix(rng, 1000, 333, 5);
+    const Matrix<bool> mask = values < 2;
+    const Matrix<bool> sequential = mask.apply(Not());
+    ASSERT_TEST(!any(mask.apply(Not(), pool) - sequential));
+    Matrix<bool> in_place = mask;
+    in_place.applyInPlace(Not(), pool);
+    ASSERT_TEST(!any(in_place - sequential));
+    const int count = mask.countIf([](bool value) { return value; });
+    ASSERT_TEST(mask.countIf([](bool value) { return value; }, pool) == count);
+    ASSERT_TEST(mask.reduce(0, std::plus<int>(), pool) == count);
+    return true;
+}
+
+/** benchmarkAgainstBytes: builds, combines and checks 4096 x 4096 masks as a packed Matrix<bool> and as a byte per
+*                          entry, and prints the times and the memory of each layout
+* */
+bool benchmarkAgainstBytes()
+{
+    const int kSide = 4096, kCells = kSide * kSide;
+    std::mt19937 rng(1);
+    const Matrix<int> first = randomMatrix(rng, kSide, kSide, 1000), second = randomMatrix(rng, kSide, kSide, 1000);
+
+    test::Timer packed_build_timer;
+    const Matrix<bool> x = first < 999, y = second < 999;
+    const double packed_build = packed_build_timer.seconds();
+    test::Timer packed_combine_timer;
+    const Matrix<bool> combined = x + y;
+    const double packed_combine = packed_combine_timer.seconds();
+    test::Timer packed_check_timer;
+    const bool packed_result = all(combined) || any(x - y);
+    const double packed_check = packed_check_timer.seconds();
+
+    test::Timer bytes_build_timer;
+    Bytes x_bytes(kCells), y_bytes(kCells);
+    for (int i = 0; i < kCells; i++) {
+        x_bytes[i] = first.data()[i] < 999;
+        y_bytes[i] = second.data()[i] < 999;
+    }
+    const double bytes_build = bytes_build_timer.seconds();
+    test::Timer bytes_combine_timer;
+    Bytes combined_bytes(kCells);
+    for (int i = 0; i < kCells; i++) {
+        combined_bytes[i] = x_bytes[i] | y_bytes[i];
+    }
+    const double bytes_combine = bytes_combine_timer.seconds();
+    test::Timer bytes_check_timer;
+    bool all_combined = true, any_different = false;
+    for (int i = 0; i < kCells && all_combined; i++) {
+        all_combined = combined_bytes[i] != 0;
+    }
+    for (int i = 0; i < kCells && !any_different; i++) {
+        any_different = x_bytes[i] != y_bytes[i];
+    }
+    const double bytes_check = bytes_check_timer.seconds();
+    ASSERT_TEST(packed_result == (all_combined || any_different));
+    ASSERT_TEST(sameEntries(combined, combined_bytes));
+
+    std::cout << "  " << kSide << " x " << kSide << " masks, packed / bytes: memory " << kCells / 8 / 1024 << " KB / "
+              << kCells / 1024 << " KB, build " << packed_build * 1000 << " / " << bytes_build * 1000
+              << " ms, or " << packed_combine * 1000 << " / " << bytes_combine * 1000 << " ms, all + any "
+              << packed_check * 1000 << " / " << bytes_check * 1000 << " ms" << std::endl;
+    return true;
+}
+
+int main()
+{
+    int failures = 0;
+    RUN_TEST(testComparisonsPackEveryEntry, failures);
+    RUN_TEST(testWordOperations, failures);
+    RUN_TEST(testPaddingBitsStayClear, failures);
+    RUN_TEST(testProxies, failures);
+    RUN_TEST(testParallelWordChunks, failures);
+    RUN_TEST(benchmarkAgainstBytes, failures);
+    return failures;
+}
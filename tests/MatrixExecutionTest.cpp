@@ -0,0 +1,264 @@
+#include "Matrix.h"
+#include "MatrixExecution.h"
+#include "TestUtilities.h"
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mtm;
+
+namespace {
+    // small and odd shapes, a row of exactly one chunk of ints and one more, and matrices of many chunks
+    const int kSizes[][2] = {{1, 1}, {1, 15}, {3, 7}, {100, 100}, {1, 16384}, {1, 16385}, {129, 1031}, {700, 700}};
+
+    Matrix<int> randomMatrix(std::mt19937& rng, const int height, const int width)
+    {
+        Matrix<int> matrix(Dimensions(height, width));
+        for (int& element : matrix) {
+            element = int(rng() % 1000) - 500;
+        }
+        return matrix;
+    }
+
+    int triplePlusOne(const int value)
+    {
+        return value * 3 + 1;
+    }
+
+    long long add(const long long first, const long long second)
+    {
+        return first + second;
+    }
+}
+
+/** testRunCallsEveryChunkOnce: Executor::run on each executor, for no chunks, one chunk and many chunks
+* */
+bool testRunCallsEveryChunkOnce()
+{
+    ThreadPoolExecutor pool(3), no_workers(0);
+    SequentialExecutor sequential;
+    Executor* const executors[] = {&sequential, &sequentialExecutor(), &pool, &no_workers};
+    ASSERT_TEST(pool.threads() == 4 && no_workers.threads() == 1);
+    for (Executor* executor : executors) {
+        for (int chunks : {0, 1, 2, 7, 1000}) {
+            std::vector<std::atomic<int>> calls(chunks);
+            for (std::atomic<int>& count : calls) {
+                count = 0;
+            }
+            executor->run(chunks, [&](const int chunk) { calls[chunk]++; });
+            for (const std::atomic<int>& count : calls) {
+                ASSERT_TEST(count == 1);
+            }
+        }
+    }
+    return true;
+}
+
+/** testChunksCoverTheData: the chunks are contiguous, cover every element once, and all but the first start at
+*                           a cache line boundary of the data
+* */
+bool testChunksCoverTheData()
+{
+    std::vector<int> data(100000);
+    for (int offset : {0, 1, 5, 15}) {
+        for (int size : {0, 1, 15, 16, 16384, 16385, 40000, 99000}) {
+            const int* elements = data.data() + offset;
+            const execution::Chunks<int> chunks(elements, size);
+            ASSERT_TEST(chunks.count() == 0 ? size == 0 : chunks.first(0) == 0);
+            int covered = 0;
+            for (int chunk = 0; chunk < chunks.count(); chunk++) {
+                ASSERT_TEST(chunks.first(chunk) == covered && chunks.last(chunk) > chunks.first(chunk));
+                if (chunk > 0) {
+                    ASSERT_TEST(reinterpret_cast<std::uintptr_t>(elements + chunks.first(chunk)) %
+                                execution::kCacheLineBytes == 0);
+                }
+                covered = chunks.last(chunk);
+            }
+            ASSERT_TEST(covered == size);
+        }
+    }
+    return true;
+}
+
+bool testOperationsMatchSequential()
+{
+    std::mt19937 rng(1);
+    ThreadPoolExecutor pool(3);
+    for (const int* size : kSizes) {
+        const Matrix<int> matrix = randomMatrix(rng, size[0], size[1]);
+        long long sum = 0;
+        int positive = 0;
+        for (const int element : matrix) {
+            sum += element;
+            positive += element > 0 ? 1 : 0;
+        }
+        const Matrix<int> expected = matrix.apply(triplePlusOne);
+        for (int i = 0; i < matrix.size(); i++) {
+            ASSERT_TEST(expected.data()[i] == triplePlusOne(matrix.data()[i]));
+        }
+        Executor* const executors[] = {&sequentialExecutor(), &pool};
+        for (Executor* executor : executors) {
+            ASSERT_TEST(!any(matrix.apply(triplePlusOne, *executor) - expected != 0, *executor));
+            Matrix<int> in_place = matrix;
+            ASSERT_TEST(!any(in_place.applyInPlace(triplePlusOne, *executor) - expected != 0, *executor));
+            ASSERT_TEST(matrix.reduce(0LL, add, *executor) == sum);
+            ASSERT_TEST(matrix.countIf([](int value) { return value > 0; }, *executor) == positive);
+
+            const Matrix<int> ones(Dimensions(size[0], size[1]), 1);
+            ASSERT_TEST(all(ones, *executor) && any(ones, *executor));
+            ASSERT_TEST(!all(ones - ones, *executor) && !any(ones - ones, *executor));
+            ASSERT_TEST(all(matrix > 0, *executor) == all(matrix > 0));
+            ASSERT_TEST(any(matrix > 498, *executor) == any(matrix > 498));
+            ASSERT_TEST(all(matrix >= -500, *executor) && !any(matrix > 500, *executor));
+        }
+    }
+    return true;
+}
+
+/** testOneEntryDecidesAllAndAny: a single entry anywhere (each chunk is skipped or checked) decides all and any
+* */
+bool testOneEntryDecidesAllAndAny()
+{
+    ThreadPoolExecutor pool(3);
+    Matrix<int> matrix(Dimensions(300, 1000), 1);
+    for (int index : {0, 16383, 16384, 150000, 299999}) {
+        matrix.data()[index] = 0;
+        ASSERT_TEST(!all(matrix, pool) && any(matrix, pool));
+        ASSERT_TEST(any(matrix == 0, pool) && !all(matrix == 1, pool));
+        matrix.data()[index] = 1;
+        ASSERT_TEST(all(matrix, pool) && !any(matrix == 0, pool));
+    }
+    return true;
+}
+
+bool testExceptionsAreRethrown()
+{
+    ThreadPoolExecutor pool(3);
+    Matrix<int> matrix(Dimensions(1000, 1000), 7);
+    matrix(999, 999) = 8;
+    const auto throw_on_eight = [](int value) -> int {
+        if (value == 8) {
+            throw std::runtime_error("eight");
+        }
+        return value;
+    };
+    ASSERT_THROWS(matrix.apply(throw_on_eight, pool), std::runtime_error);
+    ASSERT_THROWS(matrix.applyInPlace(throw_on_eight, pool), std::runtime_error);
+    ASSERT_THROWS(matrix.countIf([](int value) -> bool { return value == 8 ? throw std::runtime_error("") : true; },
+                                 pool), std::runtime_error);
+    ASSERT_THROWS(pool.run(100, [](int chunk) {
+        if (chunk == 42) {
+            throw std::logic_error("chunk");
+        }
+    }), std::logic_error);
+    // the pool is usable after an exception
+    ASSERT_TEST(matrix.reduce(0LL, add, pool) == 7LL * 999999 + 8);
+    return true;
+}
+
+/** testPoolSharedByThreads: operations run from several threads on the same pool (one after another)
+* */
+bool testPoolSharedByThreads()
+{
+    ThreadPoolExecutor pool(2);
+    const Matrix<int> matrix(Dimensions(500, 500), 2);
+    std::atomic<int> wrong(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.push_back(std::thread([&]() {
+            for (int i = 0; i < 20; i++) {
+                if (matrix.reduce(0LL, add, pool) != 500000 || matrix.countIf([](int v) { return v == 2; }, pool) !=
+                    250000) {
+                    wrong++;
+                }
+            }
+        }));
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    ASSERT_TEST(wrong == 0);
+    return true;
+}
+
+/** testNestedRunsOnTheSamePool: chunks that run jobs (and Matrix operations) on their own pool, from the workers
+*                                and from the calling thread, finish with every nested chunk run once
+* */
+bool testNestedRunsOnTheSamePool()
+{
+    ThreadPoolExecutor pool(3);
+    const int kOuter = 16, kInner = 8;
+    std::vector<std::atomic<int>> calls(kOuter * kInner);
+    for (std::atomic<int>& count : calls) {
+        count = 0;
+    }
+    const Matrix<int> matrix(Dimensions(300, 300), 2);
+    std::atomic<int> wrong(0);
+    pool.run(kOuter, [&](const int outer) {
+        pool.run(kInner, [&](const int inner) {
+            pool.run(2, [&](const int) {});
+            calls[outer * kInner + inner]++;
+        });
+        if (matrix.reduce(0LL, add, pool) != 180000 || !all(matrix == 2, pool)) {
+            wrong++;
+        }
+    });
+    for (const std::atomic<int>& count : calls) {
+        ASSERT_TEST(count == 1);
+    }
+    ASSERT_TEST(wrong == 0);
+    // a nested exception reaches the outer run, and the pool is usable afterwards
+    ASSERT_THROWS(pool.run(kOuter, [&](const int outer) {
+        pool.run(kInner, [&](const int inner) {
+            if (outer == 5 && inner == 3) {
+                throw std::logic_error("nested");
+            }
+        });
+    }), std::logic_error);
+    ASSERT_TEST(matrix.reduce(0LL, add, pool) == 180000);
+    return true;
+}
+
+/** benchmarkExecutors: applyInPlace and reduce on 4000 x 4000 ints on each executor
+* */
+bool benchmarkExecutors()
+{
+    ThreadPoolExecutor pool;
+    Executor* const executors[] = {&sequentialExecutor(), &pool};
+    for (Executor* executor : executors) {
+        Matrix<int> matrix(Dimensions(4000, 4000), 3);
+        test::Timer timer;
+        const int kRounds = 5;
+        for (int round = 0; round < kRounds; round++) {
+            matrix.applyInPlace([](int value) { return value * 2 + 1; }, *executor);
+        }
+        const double apply_seconds = timer.seconds();
+        test::Timer reduce_timer;
+        const long long sum = matrix.reduce(0LL, add, *executor);
+        const double reduce_seconds = reduce_timer.seconds();
+        ASSERT_TEST(sum == 16000000LL * 127);
+        std::cout << "  " << (executor == &pool ? "thread pool of " + std::to_string(pool.threads()) + " threads" :
+                              std::string("sequential")) << ": applyInPlace " << kRounds * matrix.size() / apply_seconds / 1e6
+                  << " M elements/s, reduce " << matrix.size() / reduce_seconds / 1e6 << " M elements/s"
+                  << std::endl;
+    }
+    return true;
+}
+
+int main()
+{
+    int failures = 0;
+    RUN_TEST(testRunCallsEveryChunkOnce, failures);
+    RUN_TEST(testChunksCoverTheData, failures);
+    RUN_TEST(testOperationsMatchSequential, failures);
+    RUN_TEST(testOneEntryDecidesAllAndAny, failures);
+    RUN_TEST(testExceptionsAreRethrown, failures);
+    RUN_TEST(testPoolSharedByThreads, failures);
+    RUN_TEST(testNestedRunsOnTheSamePool, failures);
+    RUN_TEST(benchmarkExecutors, failures);
+    return failures;
+}
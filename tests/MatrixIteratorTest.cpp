@@ -0,0 +1,144 @@
+#include "Matrix.h"
+#include "TestUtilities.h"
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace mtm;
+
+namespace {
+    template <class Iterator, class Reference>
+    struct IsRandomAccess {
+        typedef std::iterator_traits<Iterator> traits;
+        static const bool value =
+            std::is_same<typename traits::iterator_category, std::random_access_iterator_tag>::value &&
+            std::is_same<typename traits::difference_type, std::ptrdiff_t>::value &&
+            std::is_same<typename traits::reference, Reference>::value &&
+            std::is_same<typename traits::pointer, typename std::remove_reference<Reference>::type*>::value &&
+            std::is_same<typename traits::value_type, int>::value;
+    };
+}
+
+static_assert(IsRandomAccess<Matrix<int>::iterator, int&>::value, "Matrix iterator must be random access");
+static_assert(IsRandomAccess<Matrix<int>::const_iterator, const int&>::value,
+              "Matrix const_iterator must be random access");
+static_assert(IsRandomAccess<Matrix<int, UncheckedAccess>::iterator, int&>::value,
+              "unchecked Matrix iterator must be random access");
+static_assert(IsRandomAccess<Matrix<int, UncheckedAccess>::const_iterator, const int&>::value,
+              "unchecked Matrix const_iterator must be random access");
+static_assert(std::is_convertible<Matrix<int>::iterator, Matrix<int>::const_iterator>::value,
+              "an iterator must convert to a const_iterator");
+
+/** testRandomAccessOperations: +=, -=, +, -, [], ++, --, the difference of iterators and their ordering agree with
+*                               the indices of the elements they point to, for iterator and const_iterator
+* */
+bool testRandomAccessOperations()
+{
+    Matrix<int> matrix(Dimensions(7, 9));
+    std::iota(matrix.begin(), matrix.end(), 0);
+    const Matrix<int>& const_matrix = matrix;
+    ASSERT_TEST(matrix.end() - matrix.begin() == 63 && const_matrix.end() - const_matrix.begin() == 63);
+    ASSERT_TEST(matrix.begin() - matrix.end() == -63);
+    for (int first = 0; first <= 63; first += 7) {
+        for (int second = 0; second <= 63; second += 9) {
+            const Matrix<int>::iterator a = matrix.begin() + first, b = matrix.begin() + second;
+            const Matrix<int>::const_iterator ca = const_matrix.begin() + first, cb = const_matrix.cbegin() + second;
+            ASSERT_TEST(b - a == second - first && cb - ca == second - first);
+            ASSERT_TEST((a < b) == (first < second) && (a > b) == (first > second));
+            ASSERT_TEST((a <= b) == (first <= second) && (a >= b) == (first >= second));
+            ASSERT_TEST((a == b) == (first == second) && (a != b) == (first != second));
+            ASSERT_TEST((ca < cb) == (first < second) && (ca >= cb) == (first >= second));
+            ASSERT_TEST((ca == cb) == (first == second));
+            ASSERT_TEST(a + (second - first) == b && (second - first) + a == b && b - (second - first) == a);
+            if (first < 63 && second < 63) {
+                ASSERT_TEST(a[second - first] == second && ca[second - first] == second);
+            }
+        }
+    }
+    Matrix<int>::iterator it = matrix.begin();
+    it += 20;
+    ASSERT_TEST(*it == 20 && it[-20] == 0 && it[42] == 62);
+    it -= 11;
+    ASSERT_TEST(*it == 9);
+    ASSERT_TEST(*it++ == 9 && *it == 10 && *++it == 11 && *it-- == 11 && *--it == 9);
+    it[1] = -1;
+    ASSERT_TEST(matrix(1, 1) == -1);
+    Matrix<int>::const_iterator const_it = it;
+    ASSERT_TEST(const_it == const_matrix.begin() + 9 && const_it[1] == -1);
+    const_it += 54;
+    ASSERT_TEST(const_it == const_matrix.end() && const_it == matrix.cend());
+    ASSERT_THROWS(*matrix.end(), Matrix<int>::AccessIllegalElement);
+    ASSERT_THROWS(matrix.begin()[-1], Matrix<int>::AccessIllegalElement);
+    ASSERT_THROWS(const_matrix.begin()[63], Matrix<int>::AccessIllegalElement);
+    return true;
+}
+
+/** testIteratorsPointIntoData: the elements are contiguous and in row major order: &*begin() == data(), and
+*                               &*(begin() + n) == data() + n
+* */
+bool testIteratorsPointIntoData()
+{
+    Matrix<int> matrix(Dimensions(5, 11), 3);
+    const Matrix<int>& const_matrix = matrix;
+    ASSERT_TEST(&*matrix.begin() == matrix.data() && &*const_matrix.begin() == const_matrix.data());
+    ASSERT_TEST(&*matrix.cbegin() == matrix.data());
+    for (int n = 0; n < matrix.size(); n++) {
+        ASSERT_TEST(&*(matrix.begin() + n) == matrix.data() + n && &matrix.begin()[n] == &matrix(n / 11, n % 11));
+        ASSERT_TEST(&*(const_matrix.begin() + n) == const_matrix.data() + n);
+    }
+    Matrix<std::string> strings(Dimensions(2, 3), "text");
+    ASSERT_TEST(&*strings.begin() == strings.data() && strings.begin()->size() == 4);
+    Matrix<int, UncheckedAccess> unchecked(Dimensions(3, 4), 1);
+    ASSERT_TEST(&*unchecked.begin() == unchecked.data() && &*(unchecked.end() - 1) == unchecked.data() + 11);
+    return true;
+}
+
+/** testStandardAlgorithms: std::sort (and other algorithms that need random access iterators) over a Matrix
+* */
+bool testStandardAlgorithms()
+{
+    std::mt19937 rng(24);
+    for (const int size : {1, 2, 17, 1000}) {
+        Matrix<int> matrix(Dimensions(size, 3));
+        std::vector<int> expected;
+        for (int& element : matrix) {
+            element = int(rng() % 100);
+            expected.push_back(element);
+        }
+        std::sort(matrix.begin(), matrix.end());
+        std::sort(expected.begin(), expected.end());
+        ASSERT_TEST(std::equal(expected.begin(), expected.end(), matrix.cbegin()));
+        ASSERT_TEST(std::is_sorted(matrix.cbegin(), matrix.cend()));
+        const Matrix<int>& const_matrix = matrix;
+        ASSERT_TEST(std::binary_search(const_matrix.begin(), const_matrix.end(), expected[expected.size() / 2]));
+        ASSERT_TEST(std::lower_bound(matrix.begin(), matrix.end(), expected.back()) -
+                    matrix.begin() == std::lower_bound(expected.begin(), expected.end(), expected.back()) -
+                    expected.begin());
+        std::sort(matrix.begin(), matrix.end(), std::greater<int>());
+        ASSERT_TEST(std::equal(expected.rbegin(), expected.rend(), matrix.begin()));
+        std::reverse(matrix.begin(), matrix.end());
+        ASSERT_TEST(std::equal(expected.begin(), expected.end(), matrix.begin()));
+        std::nth_element(matrix.begin(), matrix.begin() + matrix.size() / 2, matrix.end());
+        ASSERT_TEST(matrix.begin()[matrix.size() / 2] == expected[expected.size() / 2]);
+    }
+    Matrix<std::string> strings(Dimensions(2, 2), "b");
+    strings(0, 0) = "z";
+    strings(1, 0) = "a";
+    std::sort(strings.begin(), strings.end());
+    ASSERT_TEST(strings(0, 0) == "a" && strings(0, 1) == "b" && strings(1, 0) == "b" && strings(1, 1) == "z");
+    return true;
+}
+
+int main()
+{
+    int failures = 0;
+    RUN_TEST(testRandomAccessOperations, failures);
+    RUN_TEST(testIteratorsPointIntoData, failures);
+    RUN_TEST(testStandardAlgorithms, failures);
+    return failures;
+}
@@ -0,0 +1,189 @@
+#include "Matrix.h"
+#include "TestUtilities.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace mtm;
+
+static const kernels::Level kLevels[] = { kernels::SCALAR, kernels::SSE2, kernels::AVX2 };
+static const kernels::Comparison kComparisons[] = { kernels::LESS, kernels::LESS_EQUAL, kernels::GREATER,
+                                                    kernels::GREATER_EQUAL, kernels::EQUAL, kernels::NOT_EQUAL };
+
+/** randomValues: values that exercise the special cases of the kernels - for floating point types NaN, -0.0, 0.0,
+*                 infinities, denormals and the extremes (for int, large values that don't overflow)
+* */
+template <class T>
+static std::vector<T> randomValues(std::mt19937& random, const int size)
+{
+    const T specials[] = { std::numeric_limits<T>::has_quiet_NaN ? std::numeric_limits<T>::quiet_NaN() : T(7),
+                           std::numeric_limits<T>::is_iec559 ? -T(0) : T(0), T(0),
+                           std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : T(-7),
+                           std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity() : T(1),
+                           std::numeric_limits<T>::denorm_min(),
+                           std::numeric_limits<T>::is_integer ? T(1 << 29) : std::numeric_limits<T>::max(),
+                           std::numeric_limits<T>::is_integer ? T(-(1 << 29)) : std::numeric_limits<T>::lowest() };
+    std::vector<T> values(size);
+    for (int i = 0; i < size; i++) {
+        values[i] = random() % 4 == 0 ? specials[random() % 8] : T(int(random() % 9) - 4) / T(2);
+    }
+    return values;
+}
+
+/** levelsAgree: checks that every level the CPU supports gives bit-identical results to the scalar templates,
+*                for every size up to a few vectors (all the tails) and for unaligned pointers
+* */
+template <class T>
+static bool levelsAgree(std::mt19937& random)
+{
+    const kernels::Level original = kernels::activeLevel();
+    for (int size = 0; size <= 130; size++) {
+        const int offset = size % 3;
+        const std::vector<T> matrix_a = randomValues<T>(random, size + offset);
+        const std::vector<T> matrix_b = randomValues<T>(random, size + offset);
+        const std::vector<T> objects = randomValues<T>(random, 1);
+        const T* a = matrix_a.data() + offset;
+        const T* b = matrix_b.data() + offset;
+        const T object = objects[0];
+        const int words = (size + kernels::kBitsPerWord - 1) / kernels::kBitsPerWord;
+        std::vector<T> expected(size + 1), result(size + 1);
+        std::vector<kernels::word_t> expected_words(words + 1), result_words(words + 1);
+        for (const kernels::Level level : kLevels) {
+            if (level > kernels::supportedLevel()) {
+                continue;
+            }
+            ASSERT_TEST(kernels::setLevel(level) == level);
+            kernels::add<T>(a, b, expected.data(), size);
+            kernels::add(a, b, result.data(), size);
+            ASSERT_TEST(std::memcmp(expected.data(), result.data(), sizeof(T) * size) == 0);
+            kernels::subtract<T>(a, b, expected.data(), size);
+            kernels::subtract(a, b, result.data(), size);
+            ASSERT_TEST(std::memcmp(expected.data(), result.data(), sizeof(T) * size) == 0);
+            kernels::addObject<T>(a, object, expected.data(), size);
+            kernels::addObject(a, object, result.data(), size);
+            ASSERT_TEST(std::memcmp(expected.data(), result.data(), sizeof(T) * size) == 0);
+            for (const kernels::Comparison comparison : kComparisons) {
+                kernels::compare<T>(a, object, expected_words.data(), size, comparison);
+                kernels::compare(a, object, result_words.data(), size, comparison);
+                ASSERT_TEST(std::equal(expected_words.begin(), expected_words.begin() + words, result_words.begin()));
+            }
+        }
+    }
+    kernels::setLevel(original);
+    return true;
+}
+
+bool testIntLevelsAgree()
+{
+    std::mt19937 random(1);
+    return levelsAgree<int>(random);
+}
+
+bool testFloatLevelsAgree()
+{
+    std::mt19937 random(2);
+    return levelsAgree<float>(random);
+}
+
+bool testDoubleLevelsAgree()
+{
+    std::mt19937 random(3);
+    return levelsAgree<double>(random);
+}
+
+bool testSpecialValues()
+{
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    Matrix<double> matrix(Dimensions(3, 7), 1.0);
+    matrix(0, 1) = nan;
+    matrix(1, 2) = -0.0;
+    matrix(2, 6) = nan;
+    const kernels::Level original = kernels::activeLevel();
+    for (const kernels::Level level : kLevels) {
+        kernels::setLevel(level);
+        Matrix<bool> equal = matrix == 0.0;
+        Matrix<bool> not_equal = matrix != nan;
+        Matrix<bool> less = matrix < 2.0;
+        Matrix<double> sum = matrix + -0.0;
+        ASSERT_TEST(equal(1, 2) && !equal(0, 1) && !equal(0, 0));
+        ASSERT_TEST(all(not_equal));
+        ASSERT_TEST(!less(0, 1) && !less(2, 6) && less(1, 2));
+        ASSERT_TEST(std::signbit(sum(1, 2)) && std::isnan(sum(0, 1)));
+    }
+    kernels::setLevel(original);
+    return true;
+}
+
+bool testLevelIsClampedToSupported()
+{
+    const kernels::Level original = kernels::activeLevel();
+    ASSERT_TEST(kernels::setLevel(kernels::AVX2) == kernels::supportedLevel());
+    ASSERT_TEST(kernels::activeLevel() == kernels::supportedLevel());
+    ASSERT_TEST(kernels::setLevel(kernels::SCALAR) == kernels::SCALAR);
+    kernels::setLevel(original);
+    return true;
+}
+
+bool testSetLevelWhileKernelsRun()
+{
+    Matrix<int> matrix(Dimensions(64, 64), 3);
+    const kernels::Level original = kernels::activeLevel();
+    bool correct = true;
+    std::thread worker([&]() {
+        for (int i = 0; i < 200; i++) {
+            Matrix<int> sum = matrix + matrix;
+            correct = correct && all(sum == 6);
+        }
+    });
+    for (int i = 0; i < 200; i++) {
+        kernels::setLevel(kLevels[i % 3]);
+    }
+    worker.join();
+    kernels::setLevel(original);
+    ASSERT_TEST(correct);
+    return true;
+}
+
+/** benchmarkLevels: prints the cells per second of + and < on a 2000x2000 Matrix<int> for each supported level
+* */
+bool benchmarkLevels()
+{
+    const int kRepeats = 10;
+    Matrix<int> matrix(Dimensions(2000, 2000), 3);
+    const kernels::Level original = kernels::activeLevel();
+    for (const kernels::Level level : kLevels) {
+        if (level > kernels::supportedLevel()) {
+            continue;
+        }
+        kernels::setLevel(level);
+        int checksum = 0;
+        test::Timer timer;
+        for (int i = 0; i < kRepeats; i++) {
+            Matrix<int> sum = matrix + matrix;
+            Matrix<bool> less = matrix < 4;
+            checksum += sum(i, i) + less(i, i);
+        }
+        const double seconds = timer.seconds();
+        std::cout << "  level " << level << ": " << 2.0 * kRepeats * matrix.size() / seconds / 1e6
+                  << " Mcells/s (checksum " << checksum << ")" << std::endl;
+    }
+    kernels::setLevel(original);
+    return true;
+}
+
+int main()
+{
+    int failures = 0;
+    RUN_TEST(testIntLevelsAgree, failures);
+    RUN_TEST(testFloatLevelsAgree, failures);
+    RUN_TEST(testDoubleLevelsAgree, failures);
+    RUN_TEST(testSpecialValues, failures);
+    RUN_TEST(testLevelIsClampedToSupported, failures);
+    RUN_TEST(testSetLevelWhileKernelsRun, failures);
+    RUN_TEST(benchmarkLevels, failures);
+    return failures;
+}
@@ -0,0 +1,198 @@
+#include "FixedMatrix.h"
+#include "Matrix.h"
+#include "TestUtilities.h"
+#include <type_traits>
+#include <utility>
+
+/** allocations: the number of times operator new / new[] were called - a test resets it, runs the code it checks
+*   and compares it to the number of buffers the code should allocate
+* */
+static int allocations = 0;
+
+void* operator new(std::size_t size)
+{
+    ++allocations;
+    if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+using namespace mtm;
+
+static_assert(std::is_nothrow_move_constructible<Matrix<int>>::value, "Matrix move C'tor must be noexcept");
+static_assert(std::is_nothrow_move_assignable<Matrix<int>>::value, "Matrix move = must be noexcept");
+static_assert(noexcept(std::declval<Matrix<int>&>().swap(std::declval<Matrix<int>&>())), "swap must be noexcept");
+
+static Matrix<int> makeMatrix(const int height, const int width, const int value)
+{
+    Matrix<int> matrix(Dimensions(height, width), value);
+    return matrix;
+}
+
+bool testMoveConstructor()
+{
+    Matrix<int> matrix(Dimensions(20, 30), 7);
+    const int* elements = matrix.data();
+    allocations = 0;
+    Matrix<int> moved(std::move(matrix));
+    ASSERT_TEST(allocations == 0);
+    ASSERT_TEST(moved.data() == elements);
+    ASSERT_TEST(moved.height() == 20 && moved.width() == 30 && moved(19, 29) == 7);
+    ASSERT_TEST(matrix.size() == 0);
+    matrix = makeMatrix(2, 2, 1);
+    ASSERT_TEST(matrix(1, 1) == 1);
+    return true;
+}
+
+bool testMoveAssignment()
+{
+    Matrix<int> matrix(Dimensions(20, 30), 7);
+    Matrix<int> target(Dimensions(5, 5), 1);
+    const int* elements = matrix.data();
+    allocations = 0;
+    target = std::move(matrix);
+    ASSERT_TEST(allocations == 0);
+    ASSERT_TEST(target.data() == elements && target.height() == 20 && target(0, 0) == 7);
+    allocations = 0;
+    target = makeMatrix(3, 4, 2);
+    ASSERT_TEST(allocations == 1);
+    ASSERT_TEST(target.height() == 3 && target(2, 3) == 2);
+    return true;
+}
+
+bool testSwap()
+{
+    Matrix<int> matrix_a(Dimensions(2, 3), 1);
+    Matrix<int> matrix_b(Dimensions(4, 5), 2);
+    allocations = 0;
+    swap(matrix_a, matrix_b);
+    matrix_a.swap(matrix_b);
+    std::swap(matrix_a, matrix_b);
+    ASSERT_TEST(allocations == 0);
+    ASSERT_TEST(matrix_a.height() == 4 && matrix_a(3, 4) == 2);
+    ASSERT_TEST(matrix_b.height() == 2 && matrix_b(1, 2) == 1);
+    return true;
+}
+
+bool testReturnedMatricesAreNotCopied()
+{
+    Matrix<int> matrix(Dimensions(100, 100), 2);
+    allocations = 0;
+    Matrix<int> transposed = matrix.transpose();
+    ASSERT_TEST(allocations == 1);
+    allocations = 0;
+    Matrix<int> doubled = matrix.apply([](const int value) { return value * 2; });
+    ASSERT_TEST(allocations == 1);
+    allocations = 0;
+    Matrix<int> diagonal = Matrix<int>::Diagonal(50, 3);
+    ASSERT_TEST(allocations == 1);
+    ASSERT_TEST(transposed(5, 7) == 2 && doubled(0, 0) == 4 && diagonal(4, 4) == 3 && diagonal(4, 5) == 0);
+    return true;
+}
+
+bool testChainedExpressionsAllocateOnlyTheResult()
+{
+    Matrix<int> matrix(Dimensions(100, 100), 2);
+    matrix(0, 0) = 3;
+    Matrix<int> other(Dimensions(100, 100), 1);
+    allocations = 0;
+    Matrix<bool> mask = (matrix < 3) + (matrix == 3);
+    ASSERT_TEST(allocations == 1);
+    ASSERT_TEST(all(mask));
+    allocations = 0;
+    Matrix<int> sum = matrix + 3 + other;
+    ASSERT_TEST(allocations == 1);
+    ASSERT_TEST(sum(0, 0) == 7 && sum(99, 99) == 6);
+    allocations = 0;
+    mask = (matrix <= 2);
+    ASSERT_TEST(allocations == 1);
+    ASSERT_TEST(!mask(0, 0) && mask(1, 1));
+    allocations = 0;
+    bool result = all((matrix >= 1) - (matrix == 3)) || any(matrix < 0);
+    ASSERT_TEST(allocations == 0);
+    ASSERT_TEST(!result);
+    return true;
+}
+
+/** testSmallKernelsDontAllocate: creating, copying and evaluating expressions (also with a Matrix operand, and
+*                                 aliasing the result) into FixedMatrix, its transpose, all and any never allocate
+* */
+bool testSmallKernelsDontAllocate()
+{
+    const Matrix<double> dynamic(Dimensions(4, 4), 0.25);
+    allocations = 0;
+    const FixedMatrix<double, 4, 4> half(0.5);
+    FixedMatrix<double, 4, 4> identity;
+    for (int i = 0; i < 4; i++) {
+        identity(i, i) = 1;
+    }
+    FixedMatrix<double, 4, 4> kernel = half + identity;
+    kernel = kernel + kernel - half;
+    kernel += 1;
+    kernel = kernel + dynamic;
+    const FixedMatrix<double, 4, 4> copy = kernel.transpose();
+    const FixedMatrix<bool, 4, 4> positive = copy > 0.0;
+    const bool checks = all(positive) && any(copy == 3.75) && !any(kernel - copy != 0.0);
+    ASSERT_TEST(allocations == 0);
+    ASSERT_TEST(checks && kernel(0, 0) == 3.75 && kernel(0, 1) == 1.75);
+    return true;
+}
+
+/** benchmarkSmallKernels: a 4 x 4 kernel updated element-wise many times, as a FixedMatrix and as a Matrix (which
+*                          allocates the result of each expression)
+* */
+bool benchmarkSmallKernels()
+{
+    const int kRounds = 1000000;
+    const FixedMatrix<float, 4, 4> fixed_step(0.5f), fixed_back(0.25f);
+    FixedMatrix<float, 4, 4> fixed_kernel(1.0f);
+    allocations = 0;
+    test::Timer fixed_timer;
+    for (int round = 0; round < kRounds; round++) {
+        fixed_kernel = fixed_kernel + fixed_step - fixed_back;
+    }
+    const double fixed_seconds = fixed_timer.seconds();
+    const int fixed_allocations = allocations;
+    const Matrix<float> step(Dimensions(4, 4), 0.5f), back(Dimensions(4, 4), 0.25f);
+    Matrix<float> kernel(Dimensions(4, 4), 1.0f);
+    allocations = 0;
+    test::Timer timer;
+    for (int round = 0; round < kRounds; round++) {
+        kernel = kernel + step - back;
+    }
+    const double seconds = timer.seconds();
+    ASSERT_TEST(fixed_allocations == 0 && allocations == kRounds);
+    ASSERT_TEST(fixed_kernel(3, 3) == kernel(3, 3) && kernel(3, 3) == 1.0f + kRounds / 4);
+    std::cout << "  4x4 kernel: FixedMatrix " << kRounds / fixed_seconds / 1e6 << " M updates/s, Matrix "
+              << kRounds / seconds / 1e6 << " M updates/s" << std::endl;
+    return true;
+}
+
+int main()
+{
+    int failures = 0;
+    RUN_TEST(testMoveConstructor, failures);
+    RUN_TEST(testMoveAssignment, failures);
+    RUN_TEST(testSwap, failures);
+    RUN_TEST(testReturnedMatricesAreNotCopied, failures);
+    RUN_TEST(testChainedExpressionsAllocateOnlyTheResult, failures);
+    RUN_TEST(testSmallKernelsDontAllocate, failures);
+    RUN_TEST(benchmarkSmallKernels, failures);
+    return failures;
+}
@@ -0,0 +1,211 @@
+#include "Matrix.h"
+#include "TestUtilities.h"
+#include <atomic>
+#include <functional>
+#include <random>
+#include <string>
+
+using namespace mtm;
+
+/** CountingExecutor: runs the chunks sequentially and counts the runs and the chunks
+* */
+class CountingExecutor : public Executor {
+    public:
+    int runs = 0;
+    int chunks = 0;
+
+    void run(const int count, const std::function<void(int)>& chunk) override
+    {
+        runs++;
+        chunks += count;
+        sequentialExecutor().run(count, chunk);
+    }
+};
+
+/** naiveTranspose: the reference transpose, an element at a time through the checked () operator
+* */
+template <class T>
+static Matrix<T> naiveTranspose(const Matrix<T>& matrix)
+{
+    Matrix<T> result(Dimensions(matrix.width(), matrix.height()));
+    for (int i = 0; i < result.height(); i++) {
+        for (int j = 0; j < result.width(); j++) {
+            result(i, j) = matrix(j, i);
+        }
+    }
+    return result;
+}
+
+template <class T>
+static bool sameMatrices(const Matrix<T>& first, const Matrix<T>& second)
+{
+    if (first.height() != second.height() || first.width() != second.width()) {
+        return false;
+    }
+    for (int i = 0; i < first.height(); i++) {
+        for (int j = 0; j < first.width(); j++) {
+            if (!(first(i, j) == second(i, j))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/** testTileEdges: dimensions around the 32 x 32 tiles (partial tiles at the right and bottom edges)
+* */
+bool testTileEdges()
+{
+    std::mt19937 rng(3);
+    const int dimensions[] = {1, 2, 31, 32, 33, 64, 65, 100, 1023, 1025};
+    for (int height : dimensions) {
+        for (int width : dimensions) {
+            Matrix<int> matrix(Dimensions(height, width));
+            for (int& element : matrix) {
+                element = int(rng());
+            }
+            const Matrix<int> expected = naiveTranspose(matrix);
+            ASSERT_TEST(sameMatrices(matrix.transpose(), expected));
+            Matrix<int> in_place = matrix;
+            ASSERT_TEST(sameMatrices(in_place.transposeInPlace(), expected));
+            ASSERT_TEST(sameMatrices(in_place.transposeInPlace(), matrix));
+        }
+    }
+    return true;
+}
+
+/** testNonTrivialElements: elements that own memory (copied and swapped, never split between threads)
+* */
+bool testNonTrivialElements()
+{
+    std::mt19937 rng(4);
+    const int dimensions[] = {1, 31, 33, 70};
+    for (int height : dimensions) {
+        for (int width : dimensions) {
+            Matrix<std::string> matrix(Dimensions(height, width));
+            for (std::string& element : matrix) {
+                element = std::to_string(rng()) + " a string long enough to be allocated";
+            }
+            const Matrix<std::string> expected = naiveTranspose(matrix);
+            ASSERT_TEST(sameMatrices(matrix.transpose(), expected));
+            ASSERT_TEST(sameMatrices(matrix.transposeInPlace(), expected));
+        }
+    }
+    return true;
+}
+
+/** testLargeMatrices: matrices from kParallelTransposeSize elements up take the path split into chunks
+* */
+bool testLargeMatrices()
+{
+    const int shapes[][2] = {{1500, 1500}, {2100, 700}, {513, 2049}};
+    for (const int* shape : shapes) {
+        Matrix<int> matrix(Dimensions(shape[0], shape[1]));
+        int value = 0;
+        for (int& element : matrix) {
+            element = value++;
+        }
+        ASSERT_TEST(matrix.size() >= kernels::kParallelTransposeSize);
+        const Matrix<int> expected = naiveTranspose(matrix);
+        ASSERT_TEST(sameMatrices(matrix.transpose(), expected));
+        ASSERT_TEST(sameMatrices(matrix.transposeInPlace(), expected));
+    }
+    return true;
+}
+
+/** testExecutor: a large matrix is transposed on the given executor, a row of tiles per chunk, and gives the same
+*                 result on a thread pool; small matrices and elements whose copy may throw never use the executor
+* */
+bool testExecutor()
+{
+    CountingExecutor counting;
+    Matrix<int> small(Dimensions(100, 300), 1);
+    small.transpose(counting);
+    small.transposeInPlace(counting);
+    Matrix<std::string> strings(Dimensions(1024, 1024), "s");
+    strings.transpose(counting);
+    strings.transposeInPlace(counting);
+    ASSERT_TEST(counting.runs == 0);
+
+    Matrix<int> matrix(Dimensions(1100, 1000));
+    int value = 0;
+    for (int& element : matrix) {
+        element = value++;
+    }
+    const Matrix<int> expected = naiveTranspose(matrix);
+    ASSERT_TEST(sameMatrices(matrix.transpose(counting), expected));
+    ASSERT_TEST(counting.runs == 1 && counting.chunks == (1100 + kernels::kTransposeBlock - 1) /
+                                                         kernels::kTransposeBlock);
+    Matrix<int> square(Dimensions(1030, 1030));
+    for (int& element : square) {
+        element = value++;
+    }
+    const Matrix<int> square_expected = naiveTranspose(square);
+    ASSERT_TEST(sameMatrices(Matrix<int>(square).transposeInPlace(counting), square_expected));
+    ASSERT_TEST(counting.runs == 2);
+
+    ThreadPoolExecutor pool(3);
+    ASSERT_TEST(sameMatrices(matrix.transpose(pool), expected));
+    ASSERT_TEST(sameMatrices(Matrix<int>(matrix).transposeInPlace(pool), expected));
+    ASSERT_TEST(sameMatrices(square.transposeInPlace(pool), square_expected));
+    // a transpose inside a chunk of the same pool runs in the thread of the chunk
+    std::atomic<int> correct(0);
+    pool.run(4, [&](int) {
+        if (sameMatrices(square.transpose(pool), naiveTranspose(square))) {
+            correct++;
+        }
+    });
+    ASSERT_TEST(correct == 4);
+    return true;
+}
+
+bool testDoubleTransposeOfDoubles()
+{
+    Matrix<double> matrix(Dimensions(77, 45));
+    for (int i = 0; i < matrix.size(); i++) {
+        matrix.data()[i] = i * 0.5 - 100;
+    }
+    ASSERT_TEST(sameMatrices(matrix.transpose().transpose(), matrix));
+    Matrix<double> square = Matrix<double>::Diagonal(40, 2.5);
+    square(3, 7) = -1;
+    square.transposeInPlace();
+    ASSERT_TEST(square(7, 3) == -1 && square(3, 7) == 0 && square(39, 39) == 2.5);
+    return true;
+}
+
+/** benchmarkTranspose: GB/s (bytes read + written) of the naive transpose, transpose and transposeInPlace
+* */
+bool benchmarkTranspose()
+{
+    const int shapes[][2] = {{4096, 4096}, {16384, 1024}};
+    for (const int* shape : shapes) {
+        Matrix<int> matrix(Dimensions(shape[0], shape[1]), 1);
+        const double bytes = 2.0 * matrix.size() * sizeof(int);
+        test::Timer naive_timer;
+        const Matrix<int> naive = naiveTranspose(matrix);
+        const double naive_seconds = naive_timer.seconds();
+        test::Timer tiled_timer;
+        const Matrix<int> tiled = matrix.transpose();
+        const double tiled_seconds = tiled_timer.seconds();
+        test::Timer in_place_timer;
+        matrix.transposeInPlace();
+        const double in_place_seconds = in_place_timer.seconds();
+        ASSERT_TEST(tiled.height() == shape[1] && naive.height() == shape[1] && matrix.height() == shape[1]);
+        std::cout << "  " << shape[0] << " x " << shape[1] << ": naive " << bytes / naive_seconds / 1e9
+                  << " GB/s, transpose " << bytes / tiled_seconds / 1e9 << " GB/s, transposeInPlace "
+                  << bytes / in_place_seconds / 1e9 << " GB/s" << std::endl;
+    }
+    return true;
+}
+
+int main()
+{
+    int failures = 0;
+    RUN_TEST(testTileEdges, failures);
+    RUN_TEST(testNonTrivialElements, failures);
+    RUN_TEST(testLargeMatrices, failures);
+    RUN_TEST(testExecutor, failures);
+    RUN_TEST(testDoubleTransposeOfDoubles, failures);
+    RUN_TEST(benchmarkTranspose, failures);
+    return failures;
+}
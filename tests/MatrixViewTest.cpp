@@ -0,0 +1,188 @@
+#include "Matrix.h"
+#include "TestUtilities.h"
+#include <sstream>
+#include <vector>
+
+using namespace mtm;
+
+namespace {
+    /** numbered: a height x width Matrix whose entry (i, j) is i * 100 + j
+    * */
+    Matrix<int> numbered(const int height, const int width)
+    {
+        Matrix<int> matrix(Dimensions(height, width));
+        for (int i = 0; i < height; i++) {
+            for (int j = 0; j < width; j++) {
+                matrix(i, j) = i * 100 + j;
+            }
+        }
+        return matrix;
+    }
+
+    /** refersTo: checks that the view has the given extents and that its element (i, j) is the entry
+    *             (row + i, col + j) of the Matrix itself (which checks the strides of the view)
+    * */
+    template <class View>
+    bool refersTo(const View& view, const Matrix<int>& matrix, const int row, const int col, const int height,
+                  const int width)
+    {
+        if (view.height() != height || view.width() != width || view.size() != height * width) {
+            return false;
+        }
+        for (int i = 0; i < height; i++) {
+            for (int j = 0; j < width; j++) {
+                if (&view(i, j) != &matrix(row + i, col + j) || &view.atUnchecked(i, j) != &view(i, j) ||
+                    view.element(i * width + j) != matrix(row + i, col + j)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+}
+
+/** testViewsReferToTheirEntries: rows, columns and blocks of a Matrix and of views, and of a const Matrix, refer to
+*                                 the entries they cover, with the extents and strides of their shape
+* */
+bool testViewsReferToTheirEntries()
+{
+    Matrix<int> matrix = numbered(6, 9);
+    const Matrix<int>& const_matrix = matrix;
+    for (int row = 0; row < 6; row++) {
+        ASSERT_TEST(refersTo(matrix.row(row), matrix, row, 0, 1, 9));
+        ASSERT_TEST(refersTo(const_matrix.row(row), matrix, row, 0, 1, 9));
+    }
+    for (int col = 0; col < 9; col++) {
+        ASSERT_TEST(refersTo(matrix.col(col), matrix, 0, col, 6, 1));
+        ASSERT_TEST(refersTo(const_matrix.col(col), matrix, 0, col, 6, 1));
+    }
+    ASSERT_TEST(refersTo(matrix.block(0, 0, 6, 9), matrix, 0, 0, 6, 9));
+    ASSERT_TEST(refersTo(matrix.block(5, 8, 1, 1), matrix, 5, 8, 1, 1));
+    const MatrixView<int> block = matrix.block(1, 2, 4, 6);
+    ASSERT_TEST(refersTo(block, matrix, 1, 2, 4, 6));
+    ASSERT_TEST(refersTo(block.row(3), matrix, 4, 2, 1, 6));
+    ASSERT_TEST(refersTo(block.col(5), matrix, 1, 7, 4, 1));
+    ASSERT_TEST(refersTo(block.block(1, 1, 2, 3), matrix, 2, 3, 2, 3));
+    ASSERT_TEST(refersTo(block.block(1, 1, 2, 3).col(2).block(1, 0, 1, 1), matrix, 3, 5, 1, 1));
+    ASSERT_TEST(refersTo(const_matrix.block(2, 3, 3, 2).row(1), matrix, 3, 3, 1, 2));
+    ASSERT_TEST(matrix.col(4)(5, 0) == 504 && block(3, 5) == 407);
+    return true;
+}
+
+/** testOutOfRangeViewsThrow: a view or an element that isn't entirely inside the Matrix (or the view it is taken
+*                             from), or that is empty, throws AccessIllegalElement
+* */
+bool testOutOfRangeViewsThrow()
+{
+    Matrix<int> matrix = numbered(4, 5);
+    const Matrix<int>& const_matrix = matrix;
+    ASSERT_THROWS(matrix.row(-1), Matrix<int>::AccessIllegalElement);
+    ASSERT_THROWS(matrix.row(4), Matrix<int>::AccessIllegalElement);
+    ASSERT_THROWS(matrix.col(5), Matrix<int>::AccessIllegalElement);
+    ASSERT_THROWS(const_matrix.col(-1), Matrix<int>::AccessIllegalElement);
+    ASSERT_THROWS(matrix.block(-1, 0, 2, 2), Matrix<int>::AccessIllegalElement);
+    ASSERT_THROWS(matrix.block(0, -1, 2, 2), Matrix<int>::AccessIllegalElement);
+    ASSERT_THROWS(matrix.block(3, 0, 2, 1), Matrix<int>::AccessIllegalElement);
+    ASSERT_THROWS(matrix.block(0, 4, 1, 2), Matrix<int>::AccessIllegalElement);
+    ASSERT_THROWS(matrix.block(0, 0, 5, 5), Matrix<int>::AccessIllegalElement);
+    ASSERT_THROWS(matrix.block(1, 1, 0, 2), Matrix<int>::AccessIllegalElement);
+    ASSERT_THROWS(matrix.block(1, 1, 2, -1), Matrix<int>::AccessIllegalElement);
+    ASSERT_THROWS(const_matrix.block(2, 2, 3, 3), Matrix<int>::AccessIllegalElement);
+
+    // inside the Matrix but outside the view it is taken from
+    const MatrixView<int> block = matrix.block(1, 1, 2, 3);
+    ASSERT_THROWS(block.row(2), Matrix<int>::AccessIllegalElement);
+    ASSERT_THROWS(block.col(3), Matrix<int>::AccessIllegalElement);
+    ASSERT_THROWS(block.block(1, 1, 2, 1), Matrix<int>::AccessIllegalElement);
+    ASSERT_THROWS(block.block(0, 2, 1, 2), Matrix<int>::AccessIllegalElement);
+    ASSERT_THROWS(block(2, 0), Matrix<int>::AccessIllegalElement);
+    ASSERT_THROWS(block(0, 3), Matrix<int>::AccessIllegalElement);
+    ASSERT_THROWS(block(-1, 0), Matrix<int>::AccessIllegalElement);
+    ASSERT_THROWS(matrix.col(0)(0, 1), Matrix<int>::AccessIllegalElement);
+    return true;
+}
+
+/** testIteration: iterating a view visits its elements in row major order, once each, and can change them
+* */
+bool testIteration()
+{
+    Matrix<int> matrix = numbered(5, 7);
+    const MatrixView<int> views[] = {matrix.row(2), matrix.col(3), matrix.block(1, 2, 3, 4), matrix.block(4, 6, 1, 1)};
+    for (const MatrixView<int>& view : views) {
+        int index = 0;
+        for (MatrixView<int>::iterator it = view.begin(); it != view.end(); ++it, index++) {
+            ASSERT_TEST(&*it == &view(index / view.width(), index % view.width()));
+        }
+        ASSERT_TEST(index == view.size());
+        index = 0;
+        for (MatrixView<int>::const_iterator it = view.cbegin(); it != view.cend(); it++, index++) {
+            ASSERT_TEST(*it == view.element(index));
+        }
+        ASSERT_TEST(index == view.size());
+    }
+    for (int& element : matrix.col(6)) {
+        element = -1;
+    }
+    for (int row = 0; row < 5; row++) {
+        ASSERT_TEST(matrix(row, 6) == -1 && matrix(row, 5) == row * 100 + 5);
+    }
+    const Matrix<int>& const_matrix = matrix;
+    std::vector<int> visited;
+    for (const int element : const_matrix.block(3, 4, 2, 2)) {
+        visited.push_back(element);
+    }
+    ASSERT_TEST(visited == std::vector<int>({304, 305, 404, 405}));
+    // an iterator keeps the layout of its view after the view is gone
+    MatrixView<int>::iterator it = matrix.block(1, 1, 2, 2).begin();
+    ++it;
+    ++it;
+    ASSERT_TEST(*it == 201);
+    return true;
+}
+
+/** testElementWiseOperations: views as operands of the element-wise operators, all and any, as the source of a
+*                              Matrix, and assigned to (also from an overlapping view of the same Matrix)
+* */
+bool testElementWiseOperations()
+{
+    Matrix<int> matrix = numbered(5, 7);
+    const MatrixView<int> block = matrix.block(1, 2, 3, 4);
+    const Matrix<int> copy(block);
+    ASSERT_TEST(copy.height() == 3 && copy.width() == 4 && copy(2, 3) == 305);
+    const Matrix<int> sum = block + block - copy;
+    ASSERT_TEST(!any(sum - copy != 0));
+    const Matrix<int> shifted = block + 1;
+    ASSERT_TEST(shifted(0, 0) == 103 && shifted(2, 3) == 306);
+    ASSERT_TEST(all(block > 100) && !any(block > 305) && any(block == 204));
+    ASSERT_TEST(all(matrix.row(0) < 7) && !all(matrix.col(0) == 0) && any(matrix.col(0) == 400));
+    const Matrix<bool> mask = matrix.row(1) >= 103;
+    ASSERT_TEST(!mask(0, 2) && mask(0, 3) && mask(0, 6));
+    std::ostringstream view_printed, copy_printed;
+    view_printed << block;
+    copy_printed << copy;
+    ASSERT_TEST(view_printed.str() == copy_printed.str());
+
+    matrix.row(0) = matrix.row(4);
+    ASSERT_TEST(matrix(0, 3) == 403 && matrix(4, 3) == 403);
+    matrix.col(1) = matrix.col(2) + 1000;
+    ASSERT_TEST(matrix(3, 1) == 1302 && matrix(3, 2) == 302);
+    // overlapping views: the source is evaluated before any element changes
+    matrix.block(0, 3, 2, 2) = matrix.block(1, 4, 2, 2);
+    ASSERT_TEST(matrix(0, 3) == 104 && matrix(0, 4) == 105 && matrix(1, 3) == 204 && matrix(1, 4) == 205);
+    matrix.block(2, 5, 3, 2).fill(7);
+    ASSERT_TEST(matrix(2, 5) == 7 && matrix(4, 6) == 7 && matrix(1, 5) == 105 && matrix(2, 4) == 204);
+    ASSERT_THROWS(matrix.row(0) = matrix.col(0), Matrix<int>::DimensionMismatch);
+    ASSERT_THROWS(matrix.block(0, 0, 2, 2) = matrix.block(0, 0, 2, 3), Matrix<int>::DimensionMismatch);
+    ASSERT_THROWS(block + matrix, Matrix<int>::DimensionMismatch);
+    return true;
+}
+
+int main()
+{
+    int failures = 0;
+    RUN_TEST(testViewsReferToTheirEntries, failures);
+    RUN_TEST(testOutOfRangeViewsThrow, failures);
+    RUN_TEST(testIteration, failures);
+    RUN_TEST(testElementWiseOperations, failures);
+    return failures;
+}
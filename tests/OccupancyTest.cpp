@@ -0,0 +1,234 @@
+#include "Occupancy.h"
+#include "Exceptions.h"
+#include "TestUtilities.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace mtm;
+
+namespace {
+    const int kEmpty = -1;
+
+    /* Model: the team in each cell (or kEmpty), the brute force reference the queries of Occupancy are checked
+              against by scanning every cell */
+    struct Model {
+        int height, width;
+        std::vector<int> cells;
+
+        Model(int height, int width) : height(height), width(width), cells(height * width, kEmpty) {}
+
+        int& at(const GridPoint& point) { return cells[point.row * width + point.col]; }
+        int at(const GridPoint& point) const { return cells[point.row * width + point.col]; }
+
+        /* inRadius:  the cells with the given content within radius of center, in row major order */
+        std::vector<GridPoint> inRadius(const int content, const GridPoint& center, const int radius) const
+        {
+            std::vector<GridPoint> found;
+            for (int row = 0; row < height; row++) {
+                for (int col = 0; col < width; col++) {
+                    if (at(GridPoint(row, col)) == content && GridPoint::distance(center, GridPoint(row, col)) <= radius) {
+                        found.push_back(GridPoint(row, col));
+                    }
+                }
+            }
+            return found;
+        }
+    };
+
+    /* kSizes: boards whose rows and columns end before, at and after the end of a 64 bit word */
+    const int kSizes[][2] = {{1, 1}, {1, 64}, {64, 1}, {63, 65}, {64, 64}, {65, 129}, {130, 3}, {7, 200}};
+
+    Occupancy randomOccupancy(Model& model, std::mt19937& rng)
+    {
+        Occupancy occupancy(model.height, model.width);
+        for (int i = 0; i < model.height * model.width; i++) {
+            const GridPoint point(rng() % model.height, rng() % model.width);
+            if (model.at(point) == kEmpty && rng() % 3 == 0) {
+                model.at(point) = int(rng() % 2);
+                occupancy.set(point, Team(model.at(point)));
+            } else if (model.at(point) != kEmpty && rng() % 4 == 0) {
+                occupancy.reset(point, Team(model.at(point)));
+                model.at(point) = kEmpty;
+            }
+        }
+        return occupancy;
+    }
+
+    /* centers:  cells next to the ends of the words of the rows and the columns, the corners, and random cells */
+    std::vector<GridPoint> centers(const Model& model, std::mt19937& rng)
+    {
+        const int lines[] = {0, 1, 62, 63, 64, 65, 127, 128, 129, 199};
+        std::vector<GridPoint> points;
+        for (int row : lines) {
+            for (int col : lines) {
+                if (row < model.height && col < model.width) {
+                    points.push_back(GridPoint(row, col));
+                }
+            }
+        }
+        points.push_back(GridPoint(model.height - 1, model.width - 1));
+        for (int i = 0; i < 20; i++) {
+            points.push_back(GridPoint(rng() % model.height, rng() % model.width));
+        }
+        return points;
+    }
+}
+
+bool testCellsMatchModel()
+{
+    std::mt19937 rng(1);
+    for (const int* size : kSizes) {
+        Model model(size[0], size[1]);
+        const Occupancy occupancy = randomOccupancy(model, rng);
+        std::vector<GridPoint> units[2];
+        for (int row = 0; row < model.height; row++) {
+            for (int col = 0; col < model.width; col++) {
+                const GridPoint point(row, col);
+                ASSERT_TEST(occupancy.isOccupied(point) == (model.at(point) != kEmpty));
+                ASSERT_TEST(occupancy.isOccupied(point, CPP) == (model.at(point) == CPP));
+                ASSERT_TEST(occupancy.isOccupied(point, PYTHON) == (model.at(point) == PYTHON));
+            }
+        }
+        for (Team team : {CPP, PYTHON}) {
+            occupancy.appendUnits(team, units[team]);
+            ASSERT_TEST(units[team] == model.inRadius(team, GridPoint(0, 0), model.height + model.width));
+        }
+    }
+    return true;
+}
+
+bool testRadiusQueriesMatchBruteForce()
+{
+    std::mt19937 rng(2);
+    const int kRadii[] = {0, 1, 2, 5, 63, 64, 65, 100000};
+    for (const int* size : kSizes) {
+        Model model(size[0], size[1]);
+        const Occupancy occupancy = randomOccupancy(model, rng);
+        for (const GridPoint& center : centers(model, rng)) {
+            for (int radius : kRadii) {
+                for (Team team : {CPP, PYTHON}) {
+                    const std::vector<GridPoint> expected = model.inRadius(team, center, radius);
+                    ASSERT_TEST(occupancy.countInRadius(team, center, radius) == int(expected.size()));
+                    ASSERT_TEST(occupancy.unitsInRadius(team, center, radius) == expected);
+                    // appended after the cells already in the vector
+                    std::vector<GridPoint> appended(1, GridPoint(-1, -1));
+                    occupancy.appendUnitsInRadius(team, center, radius, appended);
+                    ASSERT_TEST(appended.size() == expected.size() + 1 &&
+                                std::equal(expected.begin(), expected.end(), appended.begin() + 1));
+                }
+                std::vector<GridPoint> empty;
+                occupancy.appendEmptyInRadius(center, radius, empty);
+                ASSERT_TEST(empty == model.inRadius(kEmpty, center, radius));
+            }
+        }
+    }
+    return true;
+}
+
+bool testRowAndColumnQueriesMatchBruteForce()
+{
+    std::mt19937 rng(3);
+    for (const int* size : kSizes) {
+        Model model(size[0], size[1]);
+        const Occupancy occupancy = randomOccupancy(model, rng);
+        for (int row = 0; row < model.height; row++) {
+            std::vector<GridPoint> expected;
+            for (int col = 0; col < model.width; col++) {
+                if (model.at(GridPoint(row, col)) == kEmpty) {
+                    expected.push_back(GridPoint(row, col));
+                }
+            }
+            ASSERT_TEST(occupancy.emptyCellsInRow(row) == expected);
+            ASSERT_TEST(occupancy.countEmptyInRow(row) == int(expected.size()));
+        }
+        for (int col = 0; col < model.width; col++) {
+            std::vector<GridPoint> expected;
+            for (int row = 0; row < model.height; row++) {
+                if (model.at(GridPoint(row, col)) == kEmpty) {
+                    expected.push_back(GridPoint(row, col));
+                }
+            }
+            ASSERT_TEST(occupancy.emptyCellsInColumn(col) == expected);
+            ASSERT_TEST(occupancy.countEmptyInColumn(col) == int(expected.size()));
+        }
+        ASSERT_THROWS(occupancy.emptyCellsInRow(-1), IllegalCell);
+        ASSERT_THROWS(occupancy.emptyCellsInRow(model.height), IllegalCell);
+        ASSERT_THROWS(occupancy.countEmptyInRow(model.height), IllegalCell);
+        ASSERT_THROWS(occupancy.emptyCellsInColumn(-1), IllegalCell);
+        ASSERT_THROWS(occupancy.emptyCellsInColumn(model.width), IllegalCell);
+        ASSERT_THROWS(occupancy.countEmptyInColumn(model.width), IllegalCell);
+    }
+    return true;
+}
+
+/* testFullAndEmptyLines:  rows and columns that are completely empty or completely full, so every bit of their
+                           words (and none past their ends) counts */
+bool testFullAndEmptyLines()
+{
+    for (const int* size : kSizes) {
+        const int height = size[0], width = size[1];
+        Occupancy occupancy(height, width);
+        ASSERT_TEST(occupancy.countEmptyInRow(height - 1) == width && occupancy.countEmptyInColumn(width - 1) == height);
+        for (int col = 0; col < width; col++) {
+            occupancy.set(GridPoint(height - 1, col), PYTHON);
+        }
+        for (int row = 0; row < height; row++) {
+            if (!occupancy.isOccupied(GridPoint(row, width - 1))) {
+                occupancy.set(GridPoint(row, width - 1), CPP);
+            }
+        }
+        ASSERT_TEST(occupancy.countEmptyInRow(height - 1) == 0 && occupancy.emptyCellsInRow(height - 1).empty());
+        ASSERT_TEST(occupancy.countEmptyInColumn(width - 1) == 0 && occupancy.emptyCellsInColumn(width - 1).empty());
+        ASSERT_TEST(occupancy.countInRadius(PYTHON, GridPoint(height - 1, 0), width) == width);
+        ASSERT_TEST(occupancy.countInRadius(CPP, GridPoint(0, width - 1), height) == height - 1);
+    }
+    return true;
+}
+
+/* testCopiesChangeIndependently:  a copy shares the words of the original until one of them changes a cell */
+bool testCopiesChangeIndependently()
+{
+    std::mt19937 rng(4);
+    Model model(130, 200);
+    Occupancy original = randomOccupancy(model, rng);
+    Occupancy copy = original;
+    Model copy_model = model;
+    for (int i = 0; i < 2000; i++) {
+        const GridPoint point(rng() % model.height, rng() % model.width);
+        if (copy_model.at(point) == kEmpty) {
+            copy_model.at(point) = int(rng() % 2);
+            copy.set(point, Team(copy_model.at(point)));
+        } else {
+            copy.reset(point, Team(copy_model.at(point)));
+            copy_model.at(point) = kEmpty;
+        }
+    }
+    for (Team team : {CPP, PYTHON}) {
+        std::vector<GridPoint> original_units, copy_units;
+        original.appendUnits(team, original_units);
+        copy.appendUnits(team, copy_units);
+        ASSERT_TEST(original_units == model.inRadius(team, GridPoint(0, 0), 1000));
+        ASSERT_TEST(copy_units == copy_model.inRadius(team, GridPoint(0, 0), 1000));
+    }
+    for (int col = 0; col < model.width; col++) {
+        int original_empty = 0, copy_empty = 0;
+        for (int row = 0; row < model.height; row++) {
+            original_empty += model.at(GridPoint(row, col)) == kEmpty;
+            copy_empty += copy_model.at(GridPoint(row, col)) == kEmpty;
+        }
+        ASSERT_TEST(original.countEmptyInColumn(col) == original_empty && copy.countEmptyInColumn(col) == copy_empty);
+    }
+    return true;
+}
+
+int main()
+{
+    int failures = 0;
+    RUN_TEST(testCellsMatchModel, failures);
+    RUN_TEST(testRadiusQueriesMatchBruteForce, failures);
+    RUN_TEST(testRowAndColumnQueriesMatchBruteForce, failures);
+    RUN_TEST(testFullAndEmptyLines, failures);
+    RUN_TEST(testCopiesChangeIndependently, failures);
+    return failures;
+}
@@ -0,0 +1,177 @@
+#include "Game.h"
+#include "TestUtilities.h"
+#include <cmath>
+#include <cstdlib>
+#include <random>
+
+using namespace mtm;
+using test::sameGames;
+
+namespace {
+    /* Unit: a character and its cell, the model the brute force reference works on */
+    struct Unit {
+        int row, col;
+        CharacterType type;
+        Team team;
+        units_t health, ammo, range, power;
+    };
+}
+
+static Game gameOf(const int height, const int width, const std::vector<Unit>& units)
+{
+    Game game(height, width);
+    for (const Unit& unit : units) {
+        game.addCharacter(GridPoint(unit.row, unit.col), Game::makeCharacter(unit.type, unit.team, unit.health,
+                                                                             unit.ammo, unit.range, unit.power));
+    }
+    return game;
+}
+
+/* bruteForceAttack:  the attack of the soldier units[attacker] on target by the rules, checking every unit of the
+                      board for the ricochet (as Soldier::attack did before it was limited to the danger zone) */
+static std::vector<Unit> bruteForceAttack(std::vector<Unit> units, const int attacker, const GridPoint& target)
+{
+    Unit& soldier = units[attacker];
+    soldier.ammo--;
+    const int danger_radius = int(std::ceil(double(soldier.range) / 3));
+    const units_t ricochet_damage = units_t(std::ceil(double(soldier.power) / 2));
+    for (Unit& unit : units) {
+        if (unit.team == soldier.team) {
+            continue;
+        }
+        const int distance = GridPoint::distance(GridPoint(unit.row, unit.col), target);
+        if (distance == 0) {
+            unit.health -= soldier.power;
+        } else if (distance <= danger_radius) {
+            unit.health -= ricochet_damage;
+        }
+    }
+    std::vector<Unit> alive;
+    for (const Unit& unit : units) {
+        if (unit.health > 0) {
+            alive.push_back(unit);
+        }
+    }
+    return alive;
+}
+
+bool testRicochetMatchesBruteForce()
+{
+    int attacks = 0;
+    for (unsigned seed = 1; seed <= 400; seed++) {
+        std::mt19937 rng(seed);
+        const int height = 1 + rng() % 30, width = 1 + rng() % 30;
+        std::vector<Unit> units;
+        std::vector<bool> occupied(height * width, false);
+        const int count = 1 + rng() % (height * width);
+        for (int i = 0; i < count; i++) {
+            const int row = rng() % height, col = rng() % width;
+            if (occupied[row * width + col]) {
+                continue;
+            }
+            occupied[row * width + col] = true;
+            const Unit unit = {row, col, i == 0 ? SOLDIER : CharacterType(rng() % 3), Team(rng() % 2),
+                               units_t(1 + rng() % 12), units_t(rng() % 3), units_t(rng() % 21),
+                               units_t(rng() % 9)};
+            units.push_back(unit);
+        }
+        // the first unit attacks a cell (empty, enemy or friendly) of its row or column, within its range
+        units[0].ammo = 1 + rng() % 3;
+        const Unit& soldier = units[0];
+        const int offset = int(rng() % (2 * soldier.range + 1)) - soldier.range;
+        GridPoint target(soldier.row, soldier.col);
+        if (rng() % 2 == 0) {
+            target.row = std::min(height - 1, std::max(0, soldier.row + offset));
+        } else {
+            target.col = std::min(width - 1, std::max(0, soldier.col + offset));
+        }
+        Game game = gameOf(height, width, units);
+        game.attack(GridPoint(soldier.row, soldier.col), target);
+        ASSERT_TEST(sameGames(game, gameOf(height, width, bruteForceAttack(units, 0, target))));
+        attacks++;
+    }
+    ASSERT_TEST(attacks == 400);
+    return true;
+}
+
+bool testRicochetAtTheEdges()
+{
+    // a soldier of range 12 (danger radius 4) attacks each corner of a 6 x 7 board full of enemies
+    const int height = 6, width = 7;
+    const GridPoint corners[] = {GridPoint(0, 0), GridPoint(0, width - 1), GridPoint(height - 1, 0),
+                                 GridPoint(height - 1, width - 1)};
+    for (const GridPoint& corner : corners) {
+        std::vector<Unit> units;
+        const Unit soldier = {corner.row, corner.col == 0 ? 1 : corner.col - 1, SOLDIER, CPP, 10, 5, 12, 4};
+        units.push_back(soldier);
+        for (int row = 0; row < height; row++) {
+            for (int col = 0; col < width; col++) {
+                if (row != soldier.row || col != soldier.col) {
+                    const Unit enemy = {row, col, MEDIC, PYTHON, 3, 0, 1, 1};
+                    units.push_back(enemy);
+                }
+            }
+        }
+        Game game = gameOf(height, width, units);
+        game.attack(GridPoint(soldier.row, soldier.col), corner);
+        ASSERT_TEST(sameGames(game, gameOf(height, width, bruteForceAttack(units, 0, corner))));
+    }
+    return true;
+}
+
+/* benchmarkBoardSizes:  times soldier attacks on boards of 1000 x 1000 and 4000 x 4000 with the same units around
+                         the target, next to a scan of every cell (what each attack cost before): the time of an
+                         attack doesn't depend on the size of the board (16 times the cells, well under 4 times
+                         the time, even on a busy machine) */
+bool benchmarkBoardSizes()
+{
+    double first_attack_seconds = 0;
+    for (int side : {1000, 4000}) {
+        std::vector<Unit> units;
+        const int center = side / 2;
+        const Unit soldier = {center, center - 3, SOLDIER, CPP, 10, 1000000, 12, 1};
+        units.push_back(soldier);
+        for (int row = center - 6; row <= center + 6; row++) {
+            for (int col = center - 1; col <= center + 6; col++) {
+                const Unit enemy = {row, col, SOLDIER, PYTHON, 1000000, 0, 1, 1};
+                units.push_back(enemy);
+            }
+        }
+        Game game = gameOf(side, side, units);
+        const int kAttacks = 10000;
+        test::Timer attack_timer;
+        for (int i = 0; i < kAttacks; i++) {
+            game.attack(GridPoint(soldier.row, soldier.col), GridPoint(center, center));
+        }
+        const double attack_seconds = attack_timer.seconds();
+        if (side == 1000) {
+            first_attack_seconds = attack_seconds;
+        }
+        ASSERT_TEST(attack_seconds < 4 * first_attack_seconds);
+
+        Matrix<std::shared_ptr<Character>> cells(Dimensions(side, side));
+        cells(center, center) = Game::makeCharacter(SOLDIER, PYTHON, 1, 1, 1, 1);
+        test::Timer scan_timer;
+        int in_zone = 0;
+        for (int row = 0; row < side; row++) {
+            for (int col = 0; col < side; col++) {
+                in_zone += cells.atUnchecked(row, col) != nullptr &&
+                           GridPoint::distance(GridPoint(row, col), GridPoint(center, center)) <= 4;
+            }
+        }
+        const double scan_seconds = scan_timer.seconds();
+        ASSERT_TEST(in_zone == 1);
+        std::cout << "  " << side << " x " << side << ": " << attack_seconds / kAttacks * 1e6
+                  << " us per attack, " << scan_seconds * 1e6 << " us per scan of the board" << std::endl;
+    }
+    return true;
+}
+
+int main()
+{
+    int failures = 0;
+    RUN_TEST(testRicochetMatchesBruteForce, failures);
+    RUN_TEST(testRicochetAtTheEdges, failures);
+    RUN_TEST(benchmarkBoardSizes, failures);
+    return failures;
+}
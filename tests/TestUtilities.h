@@ -0,0 +1,82 @@
+#ifndef TEST_UTILITIES_H
+#define TEST_UTILITIES_H
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+
+/** Test utilities - each tests/...Test.cpp file is a separate program whose main runs its tests with RUN_TEST and
+*   returns the number of failed tests (see run_tests.sh).
+*   ASSERT_TEST:   fails the current test (a function returning bool) if the expression is false
+*   ASSERT_THROWS: fails the current test if the statement doesn't throw the given exception
+*   RUN_TEST:      runs a test and prints its result
+* */
+#define ASSERT_TEST(expression) do { \
+        if (!(expression)) { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": assertion failed: " << #expression << std::endl; \
+            return false; \
+        } \
+    } while (0)
+
+#define ASSERT_THROWS(statement, exception) do { \
+        bool thrown = false; \
+        try { \
+            statement; \
+        } catch (const exception&) { \
+            thrown = true; \
+        } \
+        if (!thrown) { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": " << #statement << " didn't throw " << #exception \
+                      << std::endl; \
+            return false; \
+        } \
+    } while (0)
+
+#define RUN_TEST(test, failures) do { \
+        bool passed = false; \
+        try { \
+            passed = test(); \
+        } catch (const std::exception& e) { \
+            std::cerr << #test << ": unexpected exception: " << e.what() << std::endl; \
+        } \
+        std::cout << (passed ? "[OK] " : "[FAILED] ") << #test << std::endl; \
+        failures += passed ? 0 : 1; \
+    } while (0)
+
+namespace mtm {
+    namespace test {
+        /** Timer: measures the seconds since it was created, for the throughput numbers the tests print
+        * */
+        class Timer {
+            std::chrono::steady_clock::time_point start;
+            public:
+            Timer() : start(std::chrono::steady_clock::now()) {}
+            double seconds() const
+            {
+                return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            }
+        };
+
+        /** gameState: the printed board and the hash of a game, to compare games (or to keep the state of a game
+        *   and compare it later). sameGames: checks that two games have the same state.
+        *   (Templates, so the tests that include this file don't all depend on Game.)
+        * */
+        template <class G>
+        std::string gameState(const G& game)
+        {
+            std::ostringstream os;
+            os << game << game.getHash();
+            return os.str();
+        }
+
+        template <class G>
+        bool sameGames(const G& first, const G& second)
+        {
+            return gameState(first) == gameState(second);
+        }
+    }
+}
+
+#endif //TEST_UTILITIES_H
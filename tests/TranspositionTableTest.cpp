@@ -0,0 +1,231 @@
+#include "Game.h"
+#include "TestUtilities.h"
+#include "TranspositionTable.h"
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace mtm;
+using test::sameGames;
+
+namespace {
+    Game randomGame(std::mt19937& rng, const int height, const int width)
+    {
+        Game game(height, width);
+        for (int i = 0; i < height * width / 3; i++) {
+            try {
+                game.addCharacter(GridPoint(rng() % height, rng() % width),
+                                  Game::makeCharacter(CharacterType(rng() % 3), Team(rng() % 2), 1 + rng() % 15,
+                                                      rng() % 4, rng() % 8, rng() % 6));
+            } catch (const CellOccupied&) {}
+        }
+        return game;
+    }
+
+    /* valueOf:  the value the concurrency test stores for a hash, so a probe can tell whose value it read */
+    std::uint64_t valueOf(const std::uint64_t hash)
+    {
+        return hash * 0x9E3779B97F4A7C15ULL + 1;
+    }
+}
+
+/* testTransposedMovesHashEqually:  two moves of different units performed in either order give the same hash (and
+                                    board), equal to the hash of a game built with the units where they ended,
+                                    and moving a unit away and back restores the hash */
+bool testTransposedMovesHashEqually()
+{
+    int transposed = 0;
+    for (unsigned seed = 1; seed < 200; seed++) {
+        std::mt19937 rng(seed);
+        const int height = 2 + rng() % 10, width = 2 + rng() % 10;
+        const Game game = randomGame(rng, height, width);
+        std::vector<Command> moves;
+        for (int row = 0; row < height; row++) {
+            for (int col = 0; col < width; col++) {
+                std::vector<Command> actions;
+                game.legalActions(GridPoint(row, col), actions);
+                for (const Command& action : actions) {
+                    if (action.type == MOVE && (action.src_row != action.dst_row || action.src_col != action.dst_col)) {
+                        moves.push_back(action);
+                    }
+                }
+            }
+        }
+        if (moves.size() < 2) {
+            continue;
+        }
+        const Command first = moves[rng() % moves.size()], second = moves[rng() % moves.size()];
+        const GridPoint first_source(first.src_row, first.src_col), first_target(first.dst_row, first.dst_col);
+        const GridPoint second_source(second.src_row, second.src_col), second_target(second.dst_row, second.dst_col);
+        Game in_order = game, reversed = game;
+        if (first_source == second_source || in_order.tryMove(first_source, first_target) != SUCCESS ||
+            in_order.tryMove(second_source, second_target) != SUCCESS ||
+            reversed.tryMove(second_source, second_target) != SUCCESS ||
+            reversed.tryMove(first_source, first_target) != SUCCESS) {
+            continue;
+        }
+        ASSERT_TEST(in_order.getHash() == reversed.getHash() && sameGames(in_order, reversed));
+        ASSERT_TEST(in_order.getHash() != game.getHash());
+        Game back = in_order;
+        ASSERT_TEST(back.tryMove(first_target, first_source) == SUCCESS);
+        ASSERT_TEST(back.tryMove(second_target, second_source) == SUCCESS);
+        ASSERT_TEST(back.getHash() == game.getHash() && sameGames(back, game));
+        transposed++;
+    }
+    ASSERT_TEST(transposed > 100);
+
+    Game moved(4, 4), built(4, 4);
+    moved.addCharacter(GridPoint(0, 0), Game::makeCharacter(SOLDIER, CPP, 5, 2, 3, 1));
+    moved.addCharacter(GridPoint(3, 3), Game::makeCharacter(MEDIC, PYTHON, 4, 1, 2, 1));
+    moved.move(GridPoint(3, 3), GridPoint(3, 1));
+    moved.move(GridPoint(0, 0), GridPoint(0, 2));
+    built.addCharacter(GridPoint(3, 1), Game::makeCharacter(MEDIC, PYTHON, 4, 1, 2, 1));
+    built.addCharacter(GridPoint(0, 2), Game::makeCharacter(SOLDIER, CPP, 5, 2, 3, 1));
+    ASSERT_TEST(moved.getHash() == built.getHash() && sameGames(moved, built));
+    return true;
+}
+
+/* testHashAfterSplashDeaths:  a Soldier attack that kills its victim and, by ricochet, some of the enemies around
+                               it, and wounds others: the hash of the game equals the hash of a game built with the
+                               survivors as they are after the attack */
+bool testHashAfterSplashDeaths()
+{
+    Game game(7, 7);
+    // danger radius ceil(6 / 3) = 2 around the victim, ricochet damage ceil(6 / 2) = 3
+    game.addCharacter(GridPoint(3, 0), Game::makeCharacter(SOLDIER, CPP, 10, 1, 6, 6));
+    game.addCharacter(GridPoint(3, 3), Game::makeCharacter(MEDIC, PYTHON, 5, 1, 2, 1));
+    game.addCharacter(GridPoint(3, 5), Game::makeCharacter(SNIPER, PYTHON, 3, 2, 4, 1));
+    game.addCharacter(GridPoint(5, 3), Game::makeCharacter(MEDIC, PYTHON, 2, 0, 2, 1));
+    game.addCharacter(GridPoint(2, 3), Game::makeCharacter(SOLDIER, PYTHON, 4, 2, 3, 2));
+    game.addCharacter(GridPoint(6, 6), Game::makeCharacter(SOLDIER, PYTHON, 5, 3, 3, 2));
+    game.addCharacter(GridPoint(4, 4), Game::makeCharacter(MEDIC, CPP, 5, 1, 2, 1));
+    ASSERT_TEST(game.tryAttack(GridPoint(3, 0), GridPoint(3, 3)) == SUCCESS);
+
+    Game survivors(7, 7);
+    survivors.addCharacter(GridPoint(4, 4), Game::makeCharacter(MEDIC, CPP, 5, 1, 2, 1));
+    survivors.addCharacter(GridPoint(6, 6), Game::makeCharacter(SOLDIER, PYTHON, 5, 3, 3, 2));
+    survivors.addCharacter(GridPoint(2, 3), Game::makeCharacter(SOLDIER, PYTHON, 1, 2, 3, 2));
+    survivors.addCharacter(GridPoint(3, 0), Game::makeCharacter(SOLDIER, CPP, 10, 0, 6, 6));
+    ASSERT_TEST(game.getHash() == survivors.getHash() && sameGames(game, survivors));
+
+    // a reload, a move and a second attack, which kills the wounded Soldier
+    ASSERT_TEST(game.tryReload(GridPoint(3, 0)) == SUCCESS);
+    ASSERT_TEST(game.tryMove(GridPoint(3, 0), GridPoint(2, 0)) == SUCCESS);
+    ASSERT_TEST(game.tryAttack(GridPoint(2, 0), GridPoint(2, 3)) == SUCCESS);
+    Game winners(7, 7);
+    winners.addCharacter(GridPoint(2, 0), Game::makeCharacter(SOLDIER, CPP, 10, 2, 6, 6));
+    winners.addCharacter(GridPoint(4, 4), Game::makeCharacter(MEDIC, CPP, 5, 1, 2, 1));
+    winners.addCharacter(GridPoint(6, 6), Game::makeCharacter(SOLDIER, PYTHON, 5, 3, 3, 2));
+    ASSERT_TEST(game.getHash() == winners.getHash() && sameGames(game, winners));
+    ASSERT_TEST(game.getHash() != survivors.getHash());
+    return true;
+}
+
+/* testStoreAndProbe:  the size of a table, stored values probed back, and misses: on an empty table, for hashes
+                       never stored, and for a hash whose entry was replaced by a store of a hash with the same index */
+bool testStoreAndProbe()
+{
+    ASSERT_THROWS(TranspositionTable(0), IllegalArgument);
+    ASSERT_TEST(TranspositionTable(1).size() == 2 && TranspositionTable(2).size() == 2);
+    ASSERT_TEST(TranspositionTable(1000).size() == 1024 && TranspositionTable(1024).size() == 1024);
+
+    TranspositionTable table(1024);
+    std::uint64_t value = 42;
+    for (std::uint64_t hash : {std::uint64_t(0), std::uint64_t(1), std::uint64_t(1023), ~std::uint64_t(0)}) {
+        ASSERT_TEST(!table.probe(hash, value));
+    }
+    ASSERT_TEST(value == 42);
+
+    std::mt19937_64 rng(5);
+    std::vector<std::uint64_t> hashes;
+    for (std::uint64_t index = 0; index < 1024; index++) {
+        hashes.push_back((rng() & ~std::uint64_t(1023)) | index);
+        table.store(hashes.back(), valueOf(hashes.back()));
+    }
+    for (const std::uint64_t hash : hashes) {
+        ASSERT_TEST(table.probe(hash, value) && value == valueOf(hash));
+        // a hash of the same index that wasn't stored
+        ASSERT_TEST(!table.probe(hash + 1024, value) && !table.probe(hash ^ (std::uint64_t(1) << 40), value));
+    }
+    // a store of a colliding hash replaces the entry
+    const std::uint64_t colliding = hashes[7] + 5 * 1024;
+    table.store(colliding, 0);
+    ASSERT_TEST(table.probe(colliding, value) && value == 0);
+    ASSERT_TEST(!table.probe(hashes[7], value));
+    ASSERT_TEST(table.probe(hashes[8], value) && value == valueOf(hashes[8]));
+
+    table.clear();
+    for (const std::uint64_t hash : hashes) {
+        ASSERT_TEST(!table.probe(hash, value));
+    }
+    ASSERT_TEST(!table.probe(colliding, value));
+
+    // the hashes of games
+    std::mt19937 game_rng(3);
+    const Game game = randomGame(game_rng, 8, 8);
+    Game moved = game;
+    std::vector<Command> actions;
+    moved.legalActions(CPP, actions);
+    for (const Command& action : actions) {
+        if (action.type == MOVE && (action.src_row != action.dst_row || action.src_col != action.dst_col)) {
+            moved.tryMove(GridPoint(action.src_row, action.src_col), GridPoint(action.dst_row, action.dst_col));
+            break;
+        }
+    }
+    ASSERT_TEST(moved.getHash() != game.getHash());
+    table.store(game.getHash(), 1);
+    table.store(moved.getHash(), 2);
+    ASSERT_TEST(table.probe(Game(game).getHash(), value) && value == 1);
+    ASSERT_TEST(table.probe(moved.getHash(), value) && value == 2);
+    return true;
+}
+
+/* testConcurrentStoreAndProbe:  threads store and probe hashes that collide on the few entries of a small table;
+                                 a probe may miss, but a value it returns is always the one stored for its hash */
+bool testConcurrentStoreAndProbe()
+{
+    TranspositionTable table(16);
+    const int kThreads = 4, kRounds = 200000;
+    std::atomic<int> wrong(0), hits(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; t++) {
+        threads.push_back(std::thread([&, t]() {
+            std::mt19937_64 rng(t + 1);
+            int thread_hits = 0;
+            for (int round = 0; round < kRounds; round++) {
+                // 256 hashes, 16 for each entry
+                const std::uint64_t hash = (rng() % 256) * 0x100000001ULL;
+                if (rng() % 2 == 0) {
+                    table.store(hash, valueOf(hash));
+                    continue;
+                }
+                std::uint64_t value = 0;
+                if (table.probe(hash, value)) {
+                    thread_hits++;
+                    if (value != valueOf(hash)) {
+                        wrong++;
+                    }
+                }
+            }
+            hits += thread_hits;
+        }));
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    ASSERT_TEST(wrong == 0);
+    ASSERT_TEST(hits > 0);
+    return true;
+}
+
+int main()
+{
+    int failures = 0;
+    RUN_TEST(testTransposedMovesHashEqually, failures);
+    RUN_TEST(testHashAfterSplashDeaths, failures);
+    RUN_TEST(testStoreAndProbe, failures);
+    RUN_TEST(testConcurrentStoreAndProbe, failures);
+    return failures;
+}
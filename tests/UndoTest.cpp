@@ -0,0 +1,246 @@
+#include "Game.h"
+#include "TestUtilities.h"
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace mtm;
+using test::gameState;
+using test::sameGames;
+
+namespace {
+    Game randomGame(std::mt19937& rng, const int height, const int width)
+    {
+        Game game(height, width);
+        for (int i = 0; i < height * width / 3; i++) {
+            try {
+                game.addCharacter(GridPoint(rng() % height, rng() % width),
+                                  Game::makeCharacter(CharacterType(rng() % 3), Team(rng() % 2), 1 + rng() % 15,
+                                                      rng() % 4, rng() % 8, rng() % 6));
+            } catch (const CellOccupied&) {}
+        }
+        return game;
+    }
+
+    /* randomAction:  performs one of the legal actions of the game, or sometimes (and when there is none) adds a
+                      character in an empty cell. Returns the type of the action: MOVE, ATTACK, RELOAD, -1 for
+                      addCharacter, or -2 if it performed nothing (a full board without legal actions) */
+    int randomAction(std::mt19937& rng, Game& game)
+    {
+        std::vector<Command> actions;
+        game.legalActions(CPP, actions);
+        game.legalActions(PYTHON, actions);
+        if (actions.empty() || rng() % 8 == 0) {
+            const int cells = game.getHeight() * game.getWidth(), first = rng() % cells;
+            for (int i = 0; i < cells; i++) {
+                const GridPoint point((first + i) % cells / game.getWidth(), (first + i) % game.getWidth());
+                if (!game.getOccupancy().isOccupied(point)) {
+                    game.addCharacter(point, Game::makeCharacter(CharacterType(rng() % 3), Team(rng() % 2),
+                                                                 1 + rng() % 15, rng() % 4, rng() % 8, rng() % 6));
+                    return -1;
+                }
+            }
+            if (actions.empty()) {
+                return -2;
+            }
+        }
+        const Command& command = actions[rng() % actions.size()];
+        const GridPoint source(command.src_row, command.src_col), target(command.dst_row, command.dst_col);
+        const ActionStatus status = command.type == MOVE ? game.tryMove(source, target) :
+                                    command.type == ATTACK ? game.tryAttack(source, target) :
+                                    game.tryReload(source);
+        return status == SUCCESS ? command.type : -2;
+    }
+
+    /* overState:  the result of isOver of a game (which reads its team counters) */
+    std::string overState(const Game& game)
+    {
+        Team winner = CPP;
+        const bool over = game.isOver(&winner);
+        return over ? std::to_string(int(winner)) : "-";
+    }
+
+    /* sameFutures:  performs the same random actions on both games and checks they stay the same game - so the
+                     games also agree on what isn't printed or hashed (the ranges and powers of the characters and
+                     the attack counters of the Snipers) */
+    bool sameFutures(Game first, Game second, const unsigned seed)
+    {
+        std::mt19937 first_rng(seed), second_rng(seed);
+        for (int i = 0; i < 30; i++) {
+            randomAction(first_rng, first);
+            randomAction(second_rng, second);
+            if (!sameGames(first, second) || overState(first) != overState(second)) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+/* testUndoRestoresEveryAction:  random actions of every type, undone one by one back to the start: after each undo
+                                 the board, the hash, the team counters (isOver) and the characters (their future
+                                 actions) are as they were before the undone action; redo reapplies them all */
+bool testUndoRestoresEveryAction()
+{
+    int seen[4] = {0};
+    for (unsigned seed = 1; seed < 60; seed++) {
+        std::mt19937 rng(seed);
+        const int height = 2 + rng() % 8, width = 2 + rng() % 8;
+        Game game = randomGame(rng, height, width);
+        game.enableUndo();
+        std::vector<Game> before;
+        for (int i = 0; i < 40; i++) {
+            before.push_back(game.clone());
+            const int type = randomAction(rng, game);
+            if (type == -2) {
+                before.pop_back();
+                continue;
+            }
+            seen[type + 1]++;
+        }
+        const Game last = game.clone();
+        for (std::size_t i = before.size(); i-- > 0;) {
+            ASSERT_TEST(game.undo());
+            ASSERT_TEST(sameGames(game, before[i]) && overState(game) == overState(before[i]));
+            if (i % 8 == 0) {
+                ASSERT_TEST(sameFutures(game, before[i], seed + unsigned(i)));
+            }
+        }
+        ASSERT_TEST(!game.undo());
+        for (std::size_t i = 0; i < before.size(); i++) {
+            ASSERT_TEST(game.redo());
+            ASSERT_TEST(i + 1 == before.size() || sameGames(game, before[i + 1]));
+        }
+        ASSERT_TEST(!game.redo());
+        ASSERT_TEST(sameGames(game, last) && sameFutures(game, last, seed));
+    }
+    for (const int count : seen) {
+        ASSERT_TEST(count > 50);
+    }
+    return true;
+}
+
+/* testUndoRestoresTeamsAndSniperCounter:  undoing the death of the last enemy makes the game not over again, and
+                                           undoing Sniper attacks restores its attack counter (every third attack
+                                           does double damage) */
+bool testUndoRestoresTeamsAndSniperCounter()
+{
+    Game game(1, 8);
+    game.enableUndo();
+    game.addCharacter(GridPoint(0, 0), Game::makeCharacter(SNIPER, CPP, 5, 5, 6, 2));
+    game.addCharacter(GridPoint(0, 4), Game::makeCharacter(SOLDIER, PYTHON, 20, 1, 2, 1));
+    game.attack(GridPoint(0, 0), GridPoint(0, 4));
+    game.attack(GridPoint(0, 0), GridPoint(0, 4));
+    ASSERT_TEST(game.undo() && game.undo());
+    // the attacks after the undos are the first, second and third again: 2 + 2 + 4 damage
+    game.attack(GridPoint(0, 0), GridPoint(0, 4));
+    game.attack(GridPoint(0, 0), GridPoint(0, 4));
+    game.attack(GridPoint(0, 0), GridPoint(0, 4));
+    Game expected(1, 8);
+    expected.addCharacter(GridPoint(0, 0), Game::makeCharacter(SNIPER, CPP, 5, 2, 6, 2));
+    expected.addCharacter(GridPoint(0, 4), Game::makeCharacter(SOLDIER, PYTHON, 12, 1, 2, 1));
+    ASSERT_TEST(sameGames(game, expected));
+    // undoing the third attack and attacking again is a third attack again
+    ASSERT_TEST(game.undo());
+    game.attack(GridPoint(0, 0), GridPoint(0, 4));
+    ASSERT_TEST(sameGames(game, expected));
+
+    game.addCharacter(GridPoint(0, 7), Game::makeCharacter(MEDIC, CPP, 3, 1, 3, 20));
+    ASSERT_TEST(!game.isOver());
+    game.attack(GridPoint(0, 7), GridPoint(0, 4));
+    Team winner = PYTHON;
+    ASSERT_TEST(game.isOver(&winner) && winner == CPP);
+    ASSERT_TEST(game.undo() && !game.isOver());
+    ASSERT_TEST(game.undo() && !game.isOver());
+    ASSERT_TEST(sameGames(game, expected));
+    ASSERT_TEST(game.redo() && game.redo() && game.isOver(&winner) && winner == CPP);
+    return true;
+}
+
+/* testNewActionDropsRedo:  an action after an undo drops the undone actions (a rejected action doesn't) */
+bool testNewActionDropsRedo()
+{
+    Game game(3, 3);
+    game.enableUndo();
+    game.addCharacter(GridPoint(0, 0), Game::makeCharacter(SOLDIER, CPP, 5, 2, 3, 2));
+    const std::string added = gameState(game);
+    game.move(GridPoint(0, 0), GridPoint(0, 1));
+    const std::string moved = gameState(game);
+    ASSERT_TEST(game.undo() && gameState(game) == added);
+    ASSERT_TEST(game.redo() && gameState(game) == moved);
+    ASSERT_TEST(game.undo() && gameState(game) == added);
+    // a rejected action is not an action
+    ASSERT_TEST(game.tryMove(GridPoint(2, 2), GridPoint(0, 0)) == CELL_EMPTY);
+    ASSERT_TEST(game.redo() && gameState(game) == moved);
+    ASSERT_TEST(game.undo());
+    ASSERT_TEST(game.tryMove(GridPoint(0, 0), GridPoint(1, 0)) == SUCCESS);
+    const std::string moved_down = gameState(game);
+    ASSERT_TEST(!game.redo() && gameState(game) == moved_down);
+    ASSERT_TEST(game.undo() && gameState(game) == added);
+    ASSERT_TEST(game.redo() && gameState(game) == moved_down);
+    ASSERT_TEST(game.undo() && game.undo() && !game.undo());
+    ASSERT_TEST(gameState(game) == gameState(Game(3, 3)));
+
+    // stopping the recording drops the record
+    game.redo();
+    game.enableUndo(false);
+    ASSERT_TEST(!game.undo() && !game.redo());
+    return true;
+}
+
+/* testCopiesOfAGameWithHistory:  a copy of a game with recorded actions (to undo and to redo) starts with an empty
+                                  record, and the undos of each don't change the other; an assigned game takes the
+                                  undo setting of the game assigned to it, like a copy */
+bool testCopiesOfAGameWithHistory()
+{
+    std::mt19937 rng(4);
+    Game game = randomGame(rng, 6, 6);
+    game.enableUndo();
+    const std::string start = gameState(game);
+    for (int i = 0; i < 10; i++) {
+        randomAction(rng, game);
+    }
+    ASSERT_TEST(game.undo() && game.undo());
+    const std::string copied_state = gameState(game);
+    Game copy(game);
+    ASSERT_TEST(gameState(copy) == copied_state);
+    ASSERT_TEST(!copy.undo() && !copy.redo());
+    ASSERT_TEST(gameState(copy) == copied_state);
+
+    // the copy records its own actions
+    randomAction(rng, copy);
+    const std::string copy_action = gameState(copy);
+    ASSERT_TEST(copy.undo() && gameState(copy) == copied_state && !copy.undo());
+    ASSERT_TEST(copy.redo() && gameState(copy) == copy_action);
+
+    // the original still has its record, and its undos don't touch the copy
+    ASSERT_TEST(gameState(game) == copied_state);
+    ASSERT_TEST(game.redo() && game.redo() && !game.redo());
+    while (game.undo()) {
+    }
+    ASSERT_TEST(gameState(game) == start);
+    ASSERT_TEST(gameState(copy) == copy_action);
+
+    // assignment drops the record of the assigned game and takes the setting of the other
+    Game assigned(6, 6);
+    ASSERT_TEST(randomAction(rng, assigned) == -1 && !assigned.undo());
+    assigned = copy;
+    ASSERT_TEST(gameState(assigned) == copy_action && !assigned.undo() && !assigned.redo());
+    randomAction(rng, assigned);
+    ASSERT_TEST(assigned.undo() && gameState(assigned) == copy_action);
+    Game not_recording(6, 6);
+    assigned = not_recording;
+    randomAction(rng, assigned);
+    ASSERT_TEST(!assigned.undo());
+    return true;
+}
+
+int main()
+{
+    int failures = 0;
+    RUN_TEST(testUndoRestoresEveryAction, failures);
+    RUN_TEST(testUndoRestoresTeamsAndSniperCounter, failures);
+    RUN_TEST(testNewActionDropsRedo, failures);
+    RUN_TEST(testCopiesOfAGameWithHistory, failures);
+    return failures;
+}
@@ -0,0 +1,28 @@
+#!/bin/bash
+# Builds every tests/*Test.cpp with the sources of the repository and runs it.
+# usage: tests/run_tests.sh [compiler flags...]   e.g. tests/run_tests.sh -fsanitize=address,undefined
+# The compiler is $CXX (g++ by default). Returns the number of test programs that failed to build or run.
+cd "$(dirname "$0")/.." || exit 1
+build=$(mktemp -d) || exit 1
+trap 'rm -rf "$build"' EXIT
+compile() {
+    "${CXX:-g++}" -std=c++11 -Wall -Wextra -pedantic-errors -O2 -I. -Itests "${flags[@]}" "$@"
+}
+flags=("$@")
+for source in *.cpp; do
+    compile -c "$source" -o "$build/${source%.cpp}.o" || { echo "=== $source: BUILD FAILED"; exit 1; }
+done
+failed=0
+for test in tests/*Test.cpp; do
+    name=$(basename "$test" .cpp)
+    echo "=== $name"
+    if ! compile "$test" "$build"/*.o -o "$build/$name" -pthread; then
+        echo "=== $name: BUILD FAILED"
+        failed=$((failed + 1))
+    elif ! "$build/$name"; then
+        echo "=== $name: FAILED"
+        failed=$((failed + 1))
+    fi
+done
+echo "=== $failed test program(s) failed"
+exit $failed